@@ -21,11 +21,16 @@
 
 #include "utils.h"
 
+#include <fcntl.h>
+#include <time.h>
+#include <unistd.h>
+
 
 #define ACTIVITY_MONITOR_METHOD_GET_APPLICATION_MEMORY_USAGE "getApplicationMemoryUsage"
 #define ACTIVITY_MONITOR_METHOD_GET_ALL_MEMORY_USAGE "getAllMemoryUsage"
 #define ACTIVITY_MONITOR_METHOD_ENABLE_MONITORING "enableMonitoring"
 #define ACTIVITY_MONITOR_METHOD_DISABLE_MONITORING "disableMonitoring"
+#define ACTIVITY_MONITOR_METHOD_GET_MONITORING_STATS "getMonitoringStats"
 
 #define ACTIVITY_MONITOR_EVT_ON_MEMORY_THRESHOLD "onMemoryThreshold"
 #define ACTIVITY_MONITOR_EVT_ON_CPU_THRESHOLD "onCPUThreshold"
@@ -38,6 +43,9 @@
 
 #define CALLSIGN_PARAMETER "-C"
 
+#define PROC_TREE_MAX_DEPTH 100
+#define PROC_REDISCOVER_SECONDS 10 // new descendants are picked up this late, unless a tracked process changes first
+
 namespace WPEFramework
 {
     namespace Plugin
@@ -77,6 +85,72 @@ namespace WPEFramework
             bool eventSent;
         };
 
+        // Samples only the monitored apps and their descendants. The /proc files of a
+        // tracked process are opened once and re-read with pread on every tick, memory
+        // comes from smaps_rollup where the kernel has it. A file opened on a process
+        // that exited fails to read, even if its pid is reused meanwhile.
+        class ProcSampler
+        {
+        public:
+            struct Stats
+            {
+                Stats() : samples(0), discoveries(0), processes(0), openFiles(0), smapsRollup(false),
+                    lastSampleUs(0), maxSampleUs(0), totalSampleUs(0), totalCpuUs(0) {}
+
+                long long unsigned int samples;
+                long long unsigned int discoveries; // walks of the process trees
+                unsigned int processes;
+                unsigned int openFiles;
+                bool smapsRollup;
+                long long unsigned int lastSampleUs;
+                long long unsigned int maxSampleUs;
+                long long unsigned int totalSampleUs;
+                long long unsigned int totalCpuUs; // cpu time of the sampling thread
+            };
+
+            ProcSampler();
+            ~ProcSampler();
+
+            void setRoots(const std::vector<unsigned int> &roots);
+            void sample(bool calcMem, bool calcCpu, std::vector<unsigned int> &pidsOut, std::vector <unsigned int> &memUsageOut, std::vector <long long unsigned int> &cpuUsageOut);
+            const Stats &stats() const { return m_stats; }
+
+        private:
+            struct Proc
+            {
+                Proc() : statFd(-1), smapsFd(-1), root(0), alive(false), cpuTicks(0), threads(0), pvt(0), shared(0) {}
+
+                int statFd;
+                int smapsFd;
+                std::string cmd;
+                unsigned int root;
+                bool alive;
+                long long unsigned int cpuTicks;
+                long int threads;
+                unsigned int pvt;
+                unsigned int shared;
+            };
+
+            void discover(std::map <unsigned int, unsigned int> &found);
+            void readChildren(unsigned int pid, std::vector <unsigned int> &children);
+            void scanChildren(std::map <unsigned int, std::vector <unsigned int>> &children);
+            bool open(unsigned int pid, Proc &proc);
+            void close(Proc &proc);
+            bool readStat(Proc &proc);
+            bool readSmaps(Proc &proc);
+            bool readAll(int fd);
+
+            std::vector <unsigned int> m_roots;
+            std::map <unsigned int, unsigned int> m_tree; // pid -> root, from the last discover
+            long long unsigned int m_discoveredUs;
+            bool m_rediscover;
+            std::map <unsigned int, Proc> m_procs;
+            std::vector <char> m_buf;
+            bool m_haveChildren;
+            bool m_haveRollup;
+            Stats m_stats;
+        };
+
         struct MonitorParams
         {
             double memoryIntervalSeconds;
@@ -85,6 +159,8 @@ namespace WPEFramework
             long long unsigned int totalCpuUsage;
             std::chrono::system_clock::time_point lastMemCheck;
             std::chrono::system_clock::time_point lastCpuCheck;
+            ProcSampler sampler;
+            ProcSampler::Stats samplerStats; // copy for the API, guarded by m_monitoringMutex
         };
 
         class MemoryInfo
@@ -124,6 +200,7 @@ namespace WPEFramework
             registerMethod(ACTIVITY_MONITOR_METHOD_GET_ALL_MEMORY_USAGE, &ActivityMonitor::getAllMemoryUsage, this);
             registerMethod(ACTIVITY_MONITOR_METHOD_ENABLE_MONITORING, &ActivityMonitor::enableMonitoring, this);
             registerMethod(ACTIVITY_MONITOR_METHOD_DISABLE_MONITORING, &ActivityMonitor::disableMonitoring, this);
+            registerMethod(ACTIVITY_MONITOR_METHOD_GET_MONITORING_STATS, &ActivityMonitor::getMonitoringStats, this);
         }
 
         ActivityMonitor::~ActivityMonitor()
@@ -236,19 +313,19 @@ namespace WPEFramework
                 returnResponse(false);
             }
 
-            delete m_monitorParams;
-
-            m_monitorParams = new MonitorParams();
+            // Set up aside, getMonitoringStats may be reading the current ones
+            MonitorParams *params = new MonitorParams();
 
-            m_monitorParams->totalCpuUsage = 0;
+            params->totalCpuUsage = 0;
 
-            m_monitorParams->lastMemCheck = std::chrono::system_clock::now();
-            m_monitorParams->lastCpuCheck = std::chrono::system_clock::now();
+            params->lastMemCheck = std::chrono::system_clock::now();
+            params->lastCpuCheck = std::chrono::system_clock::now();
 
-            m_monitorParams->memoryIntervalSeconds = memoryIntervalSeconds;
-            m_monitorParams->cpuIntervalSeconds = cpuIntervalSeconds;
+            params->memoryIntervalSeconds = memoryIntervalSeconds;
+            params->cpuIntervalSeconds = cpuIntervalSeconds;
 
             JsonArray::Iterator index(configArray.Elements());
+            std::vector <unsigned int> roots;
 
             while (index.Next() == true)
             {
@@ -264,12 +341,21 @@ namespace WPEFramework
                     getNumberParameterObject(m, "cpuThresholdSeconds", conf.cpuThresholdSeconds);
 
 
-                    m_monitorParams->config.push_back(conf);
+                    params->config.push_back(conf);
+                    roots.push_back(conf.pid);
                 }
                 else
                     LOGWARN("Unexpected variant type");
             }
 
+            params->sampler.setRoots(roots);
+
+            {
+                std::lock_guard<std::mutex> lock(m_monitoringMutex);
+                delete m_monitorParams;
+                m_monitorParams = params;
+            }
+
             if (m_monitor.joinable())
                 m_monitor.join();
 
@@ -290,8 +376,37 @@ namespace WPEFramework
             if (threadStop() == -1);
                 LOGWARN("Monitoring is already disabled");
 
-            delete m_monitorParams;
-            m_monitorParams = NULL;
+            {
+                std::lock_guard<std::mutex> lock(m_monitoringMutex);
+                delete m_monitorParams;
+                m_monitorParams = NULL;
+            }
+
+            returnResponse(true);
+        }
+
+        uint32_t ActivityMonitor::getMonitoringStats(const JsonObject& parameters, JsonObject& response)
+        {
+            LOGINFOMETHOD();
+
+            std::lock_guard<std::mutex> lock(m_monitoringMutex);
+
+            response["enabled"] = (m_monitorParams != NULL && !m_stopMonitoring);
+
+            if (m_monitorParams != NULL)
+            {
+                const ProcSampler::Stats &stats = m_monitorParams->samplerStats;
+
+                response["samples"] = stats.samples;
+                response["discoveries"] = stats.discoveries;
+                response["trackedProcesses"] = stats.processes;
+                response["openFiles"] = stats.openFiles;
+                response["smapsRollup"] = stats.smapsRollup;
+                response["lastSampleUs"] = stats.lastSampleUs;
+                response["averageSampleUs"] = stats.samples ? stats.totalSampleUs / stats.samples : 0;
+                response["maxSampleUs"] = stats.maxSampleUs;
+                response["cpuTimeUs"] = stats.totalCpuUs;
+            }
 
             returnResponse(true);
         }
@@ -804,6 +919,408 @@ namespace WPEFramework
             }
         }
 
+        static long long unsigned int nowUs(clockid_t clock)
+        {
+            struct timespec ts;
+            clock_gettime(clock, &ts);
+            return (long long unsigned int)ts.tv_sec * 1000000 + ts.tv_nsec / 1000;
+        }
+
+        ProcSampler::ProcSampler()
+        : m_discoveredUs(0)
+        , m_rediscover(true)
+        , m_haveChildren(false)
+        , m_haveRollup(0 == access("/proc/self/smaps_rollup", R_OK))
+        {
+            char name[64];
+            snprintf(name, sizeof(name), "/proc/%d/task/%d/children", getpid(), getpid());
+            m_haveChildren = (0 == access(name, R_OK));
+
+            m_buf.resize(4096);
+
+            LOGINFO("Sampling with%s children lists, with%s smaps_rollup", m_haveChildren ? "" : "out", m_haveRollup ? "" : "out");
+        }
+
+        ProcSampler::~ProcSampler()
+        {
+            for (std::map <unsigned int, Proc>::iterator it = m_procs.begin(); it != m_procs.end(); it++)
+                close(it->second);
+        }
+
+        void ProcSampler::setRoots(const std::vector<unsigned int> &roots)
+        {
+            m_roots = roots;
+            m_rediscover = true;
+        }
+
+        bool ProcSampler::open(unsigned int pid, Proc &proc)
+        {
+            char name[64];
+
+            snprintf(name, sizeof(name), "/proc/%u/stat", pid);
+            proc.statFd = ::open(name, O_RDONLY | O_CLOEXEC);
+            if (proc.statFd < 0)
+                return false;
+
+            snprintf(name, sizeof(name), "/proc/%u/%s", pid, m_haveRollup ? "smaps_rollup" : "smaps");
+            proc.smapsFd = ::open(name, O_RDONLY | O_CLOEXEC);
+
+            return true;
+        }
+
+        void ProcSampler::close(Proc &proc)
+        {
+            if (proc.statFd >= 0)
+                ::close(proc.statFd);
+            if (proc.smapsFd >= 0)
+                ::close(proc.smapsFd);
+
+            proc.statFd = proc.smapsFd = -1;
+        }
+
+        // Reads the whole file from the start into m_buf, zero terminated
+        bool ProcSampler::readAll(int fd)
+        {
+            size_t total = 0;
+
+            while (true)
+            {
+                if (m_buf.size() - total < 1024)
+                    m_buf.resize(m_buf.size() * 2);
+
+                ssize_t r = pread(fd, m_buf.data() + total, m_buf.size() - total - 1, total);
+                if (r < 0 && EINTR == errno)
+                    continue;
+                if (r < 0)
+                    return false;
+                if (0 == r)
+                    break;
+
+                total += r;
+            }
+
+            m_buf[total] = 0;
+
+            return total > 0;
+        }
+
+        bool ProcSampler::readStat(Proc &proc)
+        {
+            if (!readAll(proc.statFd))
+                return false;
+
+            // The command may contain spaces and parentheses, the fields start after the last ')'
+            char *p1 = strchr(m_buf.data(), '(');
+            char *p2 = strrchr(m_buf.data(), ')');
+            if (NULL == p1 || NULL == p2 || p2 < p1)
+                return false;
+
+            proc.cmd.assign(p1 + 1, p2 - p1 - 1);
+
+            long long unsigned int utime = 0, stime = 0, cutime = 0, cstime = 0;
+            long int threads = 0;
+
+            int vc = sscanf(p2 + 2,
+                            "%*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u " // state ... cmajflt
+                            "%llu %llu %llu %llu " // utime, stime, cutime, cstime
+                            "%*d %*d %ld", // priority, nice, num_threads
+                            &utime, &stime, &cutime, &cstime, &threads);
+            if (5 != vc)
+            {
+                LOGERR("Failed to parse cpu ticks from '%s', number of items matched: %d", m_buf.data(), vc);
+                return false;
+            }
+
+            proc.cpuTicks = utime + stime + cutime + cstime;
+            proc.threads = threads;
+
+            return true;
+        }
+
+        bool ProcSampler::readSmaps(Proc &proc)
+        {
+            proc.pvt = proc.shared = 0;
+
+            if (proc.smapsFd < 0 || !readAll(proc.smapsFd))
+                return false;
+
+            size_t shared = 0;
+            size_t pvt = 0;
+            size_t pss = 0;
+            bool withPss = false;
+
+            for (char *line = m_buf.data(); line && *line; )
+            {
+                char *next = strchr(line, '\n');
+
+                if (0 == strncmp(line, "Shared_", 7))
+                    shared += strtoul(line + strcspn(line, "0123456789"), NULL, 10);
+                else if (0 == strncmp(line, "Private_", 8))
+                    pvt += strtoul(line + strcspn(line, "0123456789"), NULL, 10);
+                else if (0 == strncmp(line, "Pss:", 4))
+                {
+                    withPss = true;
+                    pss += strtoul(line + 4, NULL, 10);
+                }
+
+                line = next ? next + 1 : NULL;
+            }
+
+            if (withPss)
+                shared = pss - pvt;
+
+            proc.pvt = pvt;
+            proc.shared = shared;
+
+            return true;
+        }
+
+        void ProcSampler::readChildren(unsigned int pid, std::vector <unsigned int> &children)
+        {
+            char name[64];
+            snprintf(name, sizeof(name), "/proc/%u/task", pid);
+
+            // A child is listed under the thread that forked it
+            DIR *d = opendir(name);
+            if (NULL == d)
+                return;
+
+            struct dirent *de;
+            while ((de = readdir(d)))
+            {
+                if ('.' == de->d_name[0])
+                    continue;
+
+                char childrenName[320];
+                snprintf(childrenName, sizeof(childrenName), "/proc/%u/task/%s/children", pid, de->d_name);
+
+                int fd = ::open(childrenName, O_RDONLY | O_CLOEXEC);
+                if (fd < 0)
+                    continue;
+
+                if (readAll(fd))
+                {
+                    char *p = m_buf.data(), *end;
+                    for (unsigned long child = strtoul(p, &end, 10); end != p; p = end, child = strtoul(p, &end, 10))
+                        children.push_back(child);
+                }
+
+                ::close(fd);
+            }
+
+            closedir(d);
+        }
+
+        // Without children lists, parents come from a pass over all of /proc
+        void ProcSampler::scanChildren(std::map <unsigned int, std::vector <unsigned int>> &children)
+        {
+            DIR *d = opendir("/proc");
+            if (NULL == d)
+                return;
+
+            struct dirent *de;
+            while ((de = readdir(d)))
+            {
+                char *end;
+                unsigned int pid = strtoul(de->d_name, &end, 10);
+                if (0 == de->d_name[0] || 0 != *end)
+                    continue;
+
+                char name[64];
+                snprintf(name, sizeof(name), "/proc/%u/stat", pid);
+
+                int fd = ::open(name, O_RDONLY | O_CLOEXEC);
+                if (fd < 0)
+                    continue;
+
+                if (readAll(fd))
+                {
+                    char *p2 = strrchr(m_buf.data(), ')');
+                    unsigned int ppid = 0;
+
+                    if (p2 && 1 == sscanf(p2 + 2, "%*c %u", &ppid) && 0 != ppid)
+                        children[ppid].push_back(pid);
+                }
+
+                ::close(fd);
+            }
+
+            closedir(d);
+        }
+
+        // Finds the roots and their descendants, pid -> root. A root inside the tree
+        // of another one is reported on its own, with its descendants.
+        void ProcSampler::discover(std::map <unsigned int, unsigned int> &found)
+        {
+            std::map <unsigned int, std::vector <unsigned int>> scanned;
+
+            if (!m_haveChildren)
+                scanChildren(scanned);
+
+            std::vector <unsigned int> roots;
+            for (unsigned int n = 0; n < m_roots.size(); n++)
+            {
+                if (found.insert(std::make_pair(m_roots[n], m_roots[n])).second)
+                    roots.push_back(m_roots[n]);
+            }
+
+            for (unsigned int n = 0; n < roots.size(); n++)
+            {
+                std::vector <unsigned int> level(1, roots[n]);
+
+                for (unsigned int depth = 0; !level.empty(); depth++)
+                {
+                    if (depth >= PROC_TREE_MAX_DEPTH)
+                    {
+                        LOGERR("Too many iterations for process tree");
+                        break;
+                    }
+
+                    std::vector <unsigned int> next;
+
+                    for (unsigned int i = 0; i < level.size(); i++)
+                    {
+                        // The root itself is in already, anything else seen is another root and its tree
+                        if (0 != depth && !found.insert(std::make_pair(level[i], roots[n])).second)
+                            continue;
+
+                        if (m_haveChildren)
+                            readChildren(level[i], next);
+                        else if (scanned.find(level[i]) != scanned.end())
+                            next.insert(next.end(), scanned[level[i]].begin(), scanned[level[i]].end());
+                    }
+
+                    level.swap(next);
+                }
+            }
+        }
+
+        void ProcSampler::sample(bool calcMem, bool calcCpu, std::vector<unsigned int> &pidsOut, std::vector <unsigned int> &memUsageOut, std::vector <long long unsigned int> &cpuUsageOut)
+        {
+            long long unsigned int startUs = nowUs(CLOCK_MONOTONIC);
+            long long unsigned int startCpuUs = nowUs(CLOCK_THREAD_CPUTIME_ID);
+
+            // The trees are walked again on a slow cadence, or as soon as a tracked process exits or changes its thread count
+            if (m_rediscover || startUs - m_discoveredUs >= PROC_REDISCOVER_SECONDS * 1000000ULL)
+            {
+                m_tree.clear();
+                discover(m_tree);
+
+                m_discoveredUs = startUs;
+                m_rediscover = false;
+                m_stats.discoveries++;
+            }
+
+            for (std::map <unsigned int, Proc>::iterator it = m_procs.begin(); it != m_procs.end(); it++)
+                it->second.alive = false;
+
+            std::map <std::string, unsigned int> cmdCount;
+
+            for (std::map <unsigned int, unsigned int>::const_iterator it = m_tree.begin(); it != m_tree.end(); it++)
+            {
+                std::map <unsigned int, Proc>::iterator pit = m_procs.find(it->first);
+
+                if (pit == m_procs.end())
+                {
+                    Proc proc;
+                    if (!open(it->first, proc))
+                        continue;
+
+                    pit = m_procs.insert(std::make_pair(it->first, proc)).first;
+                }
+
+                Proc &proc = pit->second;
+                long int threads = proc.threads;
+
+                // Fails for an exited process, also if its pid was taken by a new one since
+                if (!readStat(proc))
+                {
+                    m_rediscover = true;
+
+                    close(proc);
+                    m_procs.erase(pit);
+
+                    Proc fresh;
+                    if (!open(it->first, fresh) || !readStat(fresh))
+                    {
+                        close(fresh);
+                        continue;
+                    }
+
+                    pit = m_procs.insert(std::make_pair(it->first, fresh)).first;
+                }
+                else if (0 != threads && threads != proc.threads)
+                    m_rediscover = true; // children are listed per thread, and new threads often come with new children
+
+                if (calcMem)
+                    readSmaps(pit->second); // zero for kernel threads and processes we may not inspect
+
+                pit->second.root = it->second;
+                pit->second.alive = true;
+
+                if (calcMem)
+                    cmdCount[pit->second.cmd]++;
+            }
+
+            unsigned int openFiles = 0;
+
+            for (std::map <unsigned int, Proc>::iterator it = m_procs.begin(); it != m_procs.end(); )
+            {
+                if (!it->second.alive)
+                {
+                    close(it->second);
+                    m_procs.erase(it++);
+                    continue;
+                }
+
+                openFiles += (it->second.statFd >= 0) + (it->second.smapsFd >= 0);
+                it++;
+            }
+
+            for (unsigned int n = 0; n < m_roots.size(); n++)
+            {
+                unsigned int memUsage = 0;
+                long long unsigned int cpuUsage = 0;
+                bool seen = false;
+
+                for (std::map <unsigned int, Proc>::const_iterator it = m_procs.begin(); it != m_procs.end(); it++)
+                {
+                    if (it->second.root != m_roots[n])
+                        continue;
+
+                    seen = true;
+
+                    if (calcMem)
+                    {
+                        // Shared memory split between the tracked processes running the same command
+                        unsigned int cnt = cmdCount[it->second.cmd];
+                        memUsage += (it->second.pvt + it->second.shared / (cnt ? cnt : 1)) / 1024;
+                    }
+
+                    if (calcCpu)
+                        cpuUsage += it->second.cpuTicks;
+                }
+
+                if (seen)
+                {
+                    pidsOut.push_back(m_roots[n]);
+                    memUsageOut.push_back(memUsage);
+                    cpuUsageOut.push_back(cpuUsage);
+                }
+            }
+
+            long long unsigned int sampleUs = nowUs(CLOCK_MONOTONIC) - startUs;
+
+            m_stats.samples++;
+            m_stats.processes = m_procs.size();
+            m_stats.openFiles = openFiles;
+            m_stats.smapsRollup = m_haveRollup;
+            m_stats.lastSampleUs = sampleUs;
+            m_stats.maxSampleUs = std::max(m_stats.maxSampleUs, sampleUs);
+            m_stats.totalSampleUs += sampleUs;
+            m_stats.totalCpuUs += nowUs(CLOCK_THREAD_CPUTIME_ID) - startCpuUs;
+        }
+
         void ActivityMonitor::threadRun(ActivityMonitor *am)
         {
             am->monitoring();
@@ -839,11 +1356,16 @@ namespace WPEFramework
                 bool cpuCheck = m_monitorParams->cpuIntervalSeconds > 0 && elapsed.count() > m_monitorParams->cpuIntervalSeconds  - 0.01;
 
                 std::vector<unsigned int> pids;
-                std::vector <std::string> cmds;
                 std::vector <unsigned int> memUsage;
                 std::vector <long long unsigned int> cpuUsage;
 
-                MemoryInfo::getProcInfo(memCheck, cpuCheck, pids, cmds, memUsage, cpuUsage);
+                if (memCheck || cpuCheck)
+                {
+                    m_monitorParams->sampler.sample(memCheck, cpuCheck, pids, memUsage, cpuUsage);
+
+                    std::lock_guard<std::mutex> lock(m_monitoringMutex);
+                    m_monitorParams->samplerStats = m_monitorParams->sampler.stats();
+                }
 
                 long long unsigned int totalCpuUsage = 0;
 
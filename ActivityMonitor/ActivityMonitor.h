@@ -58,6 +58,7 @@ namespace WPEFramework {
             uint32_t getAllMemoryUsage(const JsonObject& parameters, JsonObject& response);
             uint32_t enableMonitoring(const JsonObject& parameters, JsonObject& response);
             uint32_t disableMonitoring(const JsonObject& parameters, JsonObject& response);
+            uint32_t getMonitoringStats(const JsonObject& parameters, JsonObject& response);
             //End methods
 
             //Begin events
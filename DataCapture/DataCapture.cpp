@@ -54,6 +54,60 @@ namespace WPEFramework {
             return true;
         }
 
+        static const unsigned int STREAM_CHUNK_SIZE = 16 * 1024;
+        static const size_t MAX_QUEUED_CLIPS = 4;
+        static const unsigned int MAX_READ_ATTEMPTS = 3;
+        static const unsigned int MAX_UPLOAD_ATTEMPTS = 3;
+        static const unsigned int RETRY_INITIAL_DELAY_MS = 1000;
+        static const unsigned int RETRY_MAX_DELAY_MS = 8000;
+        static const long UPLOAD_CONNECT_TIMEOUT_S = 30;
+        static const long UPLOAD_LOW_SPEED_TIME_S = 30; // below 1 byte/s for this long the server is considered stalled
+
+        struct StreamContext
+        {
+            socket_adaptor *socket;
+            const std::vector<char> *prefetch;
+            size_t offset;
+            size_t uploaded;
+            bool failed;
+            bool finished;
+        };
+
+        // Feeds the chunked upload straight from the socket, starting with the data read before the upload.
+        static size_t stream_read_callback(char *buffer, size_t size, size_t nitems, void *userdata)
+        {
+            StreamContext *context = static_cast<StreamContext *>(userdata);
+            size_t length = size * nitems;
+
+            if(context->offset < context->prefetch->size())
+            {
+                length = std::min(length, context->prefetch->size() - context->offset);
+                memcpy(buffer, context->prefetch->data() + context->offset, length);
+                context->offset += length;
+                context->uploaded += length;
+                return length;
+            }
+
+            int ret = context->socket->read_data(buffer, (unsigned int)length);
+            if(ret < 0)
+            {
+                context->failed = true;
+                return CURL_READFUNC_ABORT;
+            }
+            if(ret == 0)
+            {
+                context->finished = true;
+            }
+            context->uploaded += ret;
+            return (size_t)ret;
+        }
+
+        // Aborts the upload in flight when the plugin is going down.
+        static int upload_progress_callback(void *clientp, curl_off_t, curl_off_t, curl_off_t, curl_off_t)
+        {
+            return static_cast<std::atomic<bool> *>(clientp)->load() ? 1 : 0;
+        }
+
         static void cleanup_samples()
         {
             string path(AUDIOCAPTUREMGR_FILE_PATH AUDIOCAPTUREMGR_FILENAME_PREFIX "*");
@@ -72,7 +126,10 @@ namespace WPEFramework {
             , _session_id(-1)
             , _max_supported_duration(0)
             , _is_precapture(false)
+            , _is_streaming(false)
             , _duration(0)
+            , _curl(nullptr)
+            , _upload_stop(false)
         {
             LOGINFO("ctor");
 
@@ -92,6 +149,16 @@ namespace WPEFramework {
 
         const string DataCapture::Initialize(PluginHost::IShell* /* service */)
         {
+            curl_global_init(CURL_GLOBAL_ALL);
+            _curl = curl_easy_init();
+            if(!_curl)
+            {
+                LOGERR("could not init curl");
+            }
+
+            _upload_stop = false;
+            _upload_thread = std::thread(&DataCapture::uploadWorker, this);
+
             InitializeIARM();
             return "";
         }
@@ -99,6 +166,25 @@ namespace WPEFramework {
         void DataCapture::Deinitialize(PluginHost::IShell* /* service */)
         {
             DeinitializeIARM();
+
+            {
+                std::lock_guard<std::mutex> lock(_upload_mutex);
+                _upload_stop = true;
+                _upload_queue.clear();
+            }
+            _upload_cv.notify_all();
+            if(_upload_thread.joinable())
+            {
+                _upload_thread.join();
+            }
+
+            if(_curl)
+            {
+                curl_easy_cleanup(_curl);
+                _curl = nullptr;
+            }
+            curl_global_cleanup();
+
             delete _sock_adaptor;
             DataCapture::_instance = nullptr;
         }
@@ -301,6 +387,7 @@ namespace WPEFramework {
             _duration = (unsigned int)clipRequest["duration"].Number();
             const string& captureMode = clipRequest["captureMode"].String();
             _is_precapture = (captureMode == "preCapture");
+            _is_streaming = clipRequest.HasLabel("streaming") && clipRequest["streaming"].Boolean();
 
             LOGINFO("DataCaptureService calling getAudioClip: stream = %s, url = %s, duration = %d, captureMode = %s, session id = %d",
                          stream.c_str(), _destination_url.c_str(), _duration, captureMode.c_str(), _session_id);
@@ -398,75 +485,186 @@ namespace WPEFramework {
                 string dataLocator(payload->dataLocator);
                 string delimiter = "/";
                 size_t pos = 0;
-                string fileName;
+
+                UploadJob job;
                 pos = dataLocator.rfind(delimiter);
-                fileName = dataLocator.substr(pos + delimiter.length(), dataLocator.length());
-                int attemptsLeft = 2;
-                vector<unsigned char> data;
-                int time_wait_sec = 1;
+                job.fileName = dataLocator.substr(pos + delimiter.length(), dataLocator.length());
+                job.dataLocator = dataLocator;
+                job.url = _destination_url;
+                job.streaming = _is_streaming;
+                job.received = std::chrono::steady_clock::now();
+
+                // Only queue the clip, a slow upload must not hold up the IARM event thread.
+                bool dropped = false;
+                UploadJob oldest;
+                {
+                    std::lock_guard<std::mutex> lock(_upload_mutex);
+                    if(_upload_queue.size() >= MAX_QUEUED_CLIPS)
+                    {
+                        oldest = _upload_queue.front();
+                        _upload_queue.pop_front();
+                        dropped = true;
+                    }
+                    _upload_queue.push_back(job);
+                }
+                _upload_cv.notify_one();
 
-                JsonObject params;
-                params["fileName"] = fileName;
+                if(dropped)
+                {
+                    LOGWARN("Upload queue full, dropping clip %s", C_STR(oldest.fileName));
 
-                while (attemptsLeft) {
-                    if(0 == _sock_adaptor->connect_socket(payload->dataLocator))
-                    {
+                    JsonObject params;
+                    params["fileName"] = oldest.fileName;
+                    params["status"] = false;
+                    params["message"] = "Dropped: upload queue full";
+                    sendNotify(C_STR(EVT_ON_AUDIO_CLIP_READY), params);
+                }
+            }
+        }
+
+        void DataCapture::uploadWorker()
+        {
+            std::unique_lock<std::mutex> lock(_upload_mutex);
+
+            while(!_upload_stop)
+            {
+                if(_upload_queue.empty())
+                {
+                    _upload_cv.wait(lock);
+                    continue;
+                }
+
+                UploadJob job = _upload_queue.front();
+                _upload_queue.pop_front();
+
+                lock.unlock();
+                processClip(job);
+                lock.lock();
+            }
+        }
+
+        bool DataCapture::waitBeforeRetry(unsigned int attempt)
+        {
+            // Exponential backoff, returns false if the plugin is going down meanwhile.
+            unsigned int delay_ms = std::min(RETRY_INITIAL_DELAY_MS << attempt, RETRY_MAX_DELAY_MS);
+
+            std::unique_lock<std::mutex> lock(_upload_mutex);
+            return !_upload_cv.wait_for(lock, std::chrono::milliseconds(delay_ms), [this] { return _upload_stop.load(); });
+        }
+
+        void DataCapture::processClip(const UploadJob &job)
+        {
+            using namespace std::chrono;
+
+            vector<unsigned char> data;
+            vector<char> prefetch; // first chunk of a streamed clip
+            unsigned int attempt = 0;
+            size_t uploaded = 0;
+
+            JsonObject params;
+            params["fileName"] = job.fileName;
+
+            steady_clock::time_point started = steady_clock::now();
+
+            while (attempt < MAX_READ_ATTEMPTS) {
+                if(0 == _sock_adaptor->connect_socket(job.dataLocator))
+                {
+                    if (job.streaming) {
+                        // Only wait for the first chunk, the rest is read while uploading.
+                        prefetch.resize(STREAM_CHUNK_SIZE);
+                        int size = _sock_adaptor->read_data(&prefetch[0], prefetch.size());
+                        prefetch.resize(size > 0 ? size : 0);
+                        if (prefetch.size() > 0) {
+                            LOGINFO("Streaming a clip, first %zu bytes", prefetch.size());
+                            break;
+                        }
+                    } else {
                         _sock_adaptor->get_data(data); // closes the socket
                         if (data.size() > 0) {
-                            LOGINFO("Got a clip: %u bytes", data.size());
+                            LOGINFO("Got a clip: %zu bytes", data.size());
                             break;
-                        } else {
-                            LOGWARN("No data in the socket. One more attempt in %d sec", time_wait_sec);
-                            usleep(1000 * 1000 * time_wait_sec);
-                            --attemptsLeft;
-                            continue;
                         }
                     }
+                    LOGWARN("No data in the socket, attempt %u", attempt + 1);
+                } else {
+                    LOGWARN("Unable to connect to the socket, attempt %u", attempt + 1);
                 }
+                if(++attempt < MAX_READ_ATTEMPTS && !waitBeforeRetry(attempt - 1))
+                    break;
+            }
+
+            steady_clock::time_point fetched = steady_clock::now();
+            unsigned int uploadAttempts = 0;
 
-                if(data.size() > 0)
+            if(prefetch.size() > 0)
+            {
+                // The socket is consumed while streaming, so there is nothing left to retry with.
+                std::string error_str;
+                uploadAttempts = 1;
+                if (uploadStreamToUrl(prefetch, job.url.c_str(), error_str, uploaded))
                 {
-                    std::string error_str;
-                    if (uploadDataToUrl(data, _destination_url.c_str(), error_str))
-                    {
-                        params["status"] = true;
-                        params["message"] = "Success";
+                    LOGINFO("Streamed a clip: %zu bytes", uploaded);
+                    params["status"] = true;
+                    params["message"] = "Success";
+                } else {
+                    LOGERR("Upload failed: %s (cURL error)", C_STR(error_str));
+                    params["status"] = false;
+                    params["message"] = std::string("Upload Failed: ") + error_str;
+                }
+            }
+            else if(data.size() > 0)
+            {
+                std::string error_str;
+                bool retryable = false;
+                bool succeeded = false;
 
-                    } else {
-                        LOGERR("Upload failed: %s (cURL error)", C_STR(error_str));
-                        params["status"] = false;
-                        params["message"] = std::string("Upload Failed: ") + error_str;
-                    }
+                uploaded = data.size();
+                do
+                {
+                    error_str.clear();
+                    succeeded = uploadDataToUrl(data, job.url.c_str(), error_str, retryable);
+                    ++uploadAttempts;
+                    if(!succeeded)
+                        LOGWARN("Upload attempt %u failed: %s", uploadAttempts, C_STR(error_str));
+                } while(!succeeded && retryable && uploadAttempts < MAX_UPLOAD_ATTEMPTS && waitBeforeRetry(uploadAttempts - 1));
+
+                if (succeeded)
+                {
+                    params["status"] = true;
+                    params["message"] = "Success";
 
-                    // Optionally, we can save a file
-//                    FILE * pFile;
-//                    const char* path = strcat(payload->dataLocator, ".received.pcm");
-//                    pFile = fopen (path, "wb");
-//                    fwrite (&data[0] , sizeof(unsigned char), data.size(), pFile);
-//                    fclose (pFile);
-                    // now, upload it, then remove:
-//                    if (remove(path) != 0)
-//                    {
-//                        LOGERR("Unable to delete %s", path);
-//                    }
                 } else {
-                    LOGERR("Unable to read data from %s (connection error)", payload->dataLocator);
+                    LOGERR("Upload failed: %s (cURL error)", C_STR(error_str));
                     params["status"] = false;
-                    params["message"] = std::string("Unable to read data from  ") + string(payload->dataLocator);
+                    params["message"] = std::string("Upload Failed: ") + error_str;
                 }
-
-                string message;
-                params.ToString(message);
-                LOGINFO("Sending notification %s: %s", C_STR(EVT_ON_AUDIO_CLIP_READY), C_STR(message));
-                sendNotify(C_STR(EVT_ON_AUDIO_CLIP_READY), params);
+            } else {
+                LOGERR("Unable to read data from %s (connection error)", C_STR(job.dataLocator));
+                params["status"] = false;
+                params["message"] = std::string("Unable to read data from  ") + job.dataLocator;
             }
+
+            steady_clock::time_point finished = steady_clock::now();
+
+            // In streaming mode reading the clip overlaps with the upload and is part of "upload".
+            JsonObject timing;
+            timing["queued"] = (int64_t)duration_cast<milliseconds>(started - job.received).count();
+            timing["read"] = (int64_t)duration_cast<milliseconds>(fetched - started).count();
+            timing["upload"] = (int64_t)duration_cast<milliseconds>(finished - fetched).count();
+            timing["total"] = (int64_t)duration_cast<milliseconds>(finished - job.received).count();
+            timing["bytes"] = (uint64_t)uploaded;
+            timing["attempts"] = uploadAttempts;
+            params["timing"] = timing;
+
+            string message;
+            params.ToString(message);
+            LOGINFO("Sending notification %s: %s", C_STR(EVT_ON_AUDIO_CLIP_READY), C_STR(message));
+            sendNotify(C_STR(EVT_ON_AUDIO_CLIP_READY), params);
         }
 
-        bool DataCapture::uploadDataToUrl(std::vector<unsigned char> &data, const char *url, std::string &error_str)
+        bool DataCapture::uploadDataToUrl(std::vector<unsigned char> &data, const char *url, std::string &error_str, bool &retryable)
         {
-            CURL *curl;
-            CURLcode res;
-            bool call_succeeded = true;
+            retryable = false;
 
             if(!url || !strlen(url))
             {
@@ -476,41 +674,122 @@ namespace WPEFramework {
 
             LOGWARN("uploading pcm data of size %u to '%s'", data.size(), url);
 
-            //init curl
-            curl_global_init(CURL_GLOBAL_ALL);
-            curl = curl_easy_init();
+            //create header
+            struct curl_slist *chunk = NULL;
+            chunk = curl_slist_append(chunk, "Content-Type: audio/x-wav");
 
-            if(!curl)
+            //set url and data
+            bool call_succeeded = prepareUpload(url, chunk);
+            if(call_succeeded)
             {
-                LOGERR("could not init curl\n");
+                curl_easy_setopt(_curl, CURLOPT_POSTFIELDSIZE, data.size());
+                curl_easy_setopt(_curl, CURLOPT_POSTFIELDS, &data[0]);
+
+                call_succeeded = performUpload(error_str, retryable);
+            }
+
+            curl_slist_free_all(chunk);
+
+            return call_succeeded;
+        }
+
+        bool DataCapture::uploadStreamToUrl(const std::vector<char> &prefetch, const char *url, std::string &error_str, size_t &uploaded)
+        {
+            if(!url || !strlen(url))
+            {
+                LOGERR("no url given");
+                _sock_adaptor->disconnect_socket();
                 return false;
             }
 
-            //create header
+            LOGWARN("streaming pcm data to '%s'", url);
+
+            //create header, the size is not known up front
             struct curl_slist *chunk = NULL;
             chunk = curl_slist_append(chunk, "Content-Type: audio/x-wav");
+            chunk = curl_slist_append(chunk, "Transfer-Encoding: chunked");
 
-            //set url and data
-            curl_easy_setopt(curl, CURLOPT_URL, url);
-            curl_easy_setopt(curl, CURLOPT_HTTPHEADER, chunk);
-            curl_easy_setopt(curl, CURLOPT_POSTFIELDSIZE, data.size());
-            curl_easy_setopt(curl, CURLOPT_POSTFIELDS, &data[0]);
+            StreamContext context = { _sock_adaptor, &prefetch, 0, 0, false, false };
+
+            //set url and data source
+            bool call_succeeded = prepareUpload(url, chunk);
+            if(call_succeeded)
+            {
+                curl_easy_setopt(_curl, CURLOPT_POST, 1L);
+                curl_easy_setopt(_curl, CURLOPT_READFUNCTION, stream_read_callback);
+                curl_easy_setopt(_curl, CURLOPT_READDATA, &context);
+
+                bool retryable;
+                call_succeeded = performUpload(error_str, retryable);
+
+                if(context.failed)
+                {
+                    LOGERR("reading the clip from the socket failed after %zu bytes", context.uploaded);
+                    call_succeeded = false;
+                    if(error_str.empty())
+                        error_str = "socket read error";
+                }
+            }
+
+            if(!context.finished)
+            {
+                _sock_adaptor->disconnect_socket();
+            }
+            curl_slist_free_all(chunk);
+
+            uploaded = context.uploaded;
+            return call_succeeded;
+        }
+
+        bool DataCapture::prepareUpload(const char *url, struct curl_slist *headers)
+        {
+            if(!_curl)
+            {
+                _curl = curl_easy_init();
+            }
+
+            if(!_curl)
+            {
+                LOGERR("could not init curl\n");
+                return false;
+            }
+
+            // Reset the options of the previous upload, but keep its connection and DNS cache.
+            curl_easy_reset(_curl);
+            curl_easy_setopt(_curl, CURLOPT_URL, url);
+            curl_easy_setopt(_curl, CURLOPT_HTTPHEADER, headers);
+
+            // A stalled server must not block Deinitialize() joining the upload thread
+            curl_easy_setopt(_curl, CURLOPT_CONNECTTIMEOUT, UPLOAD_CONNECT_TIMEOUT_S);
+            curl_easy_setopt(_curl, CURLOPT_LOW_SPEED_LIMIT, 1L);
+            curl_easy_setopt(_curl, CURLOPT_LOW_SPEED_TIME, UPLOAD_LOW_SPEED_TIME_S);
+            curl_easy_setopt(_curl, CURLOPT_NOPROGRESS, 0L);
+            curl_easy_setopt(_curl, CURLOPT_XFERINFOFUNCTION, upload_progress_callback);
+            curl_easy_setopt(_curl, CURLOPT_XFERINFODATA, &_upload_stop);
+            return true;
+        }
+
+        bool DataCapture::performUpload(std::string &error_str, bool &retryable)
+        {
+            bool call_succeeded = true;
+            retryable = false;
 
             //perform blocking upload call
-            res = curl_easy_perform(curl);
+            CURLcode res = curl_easy_perform(_curl);
 
             //output success / failure log
             if(CURLE_OK == res)
             {
                 long response_code;
 
-                curl_easy_getinfo(curl, CURLINFO_RESPONSE_CODE, &response_code);
+                curl_easy_getinfo(_curl, CURLINFO_RESPONSE_CODE, &response_code);
 
                 if(600 > response_code && response_code >= 400)
                 {
                     LOGERR("uploading failed with response code %ld\n", response_code);
                     error_str = std::string("response code:") + std::to_string(response_code);
                     call_succeeded = false;
+                    retryable = (response_code >= 500); // the request itself is fine, the server may recover
                 }
                 else
                     LOGWARN("upload done");
@@ -520,10 +799,8 @@ namespace WPEFramework {
                 LOGERR("upload failed with error %d:'%s'", res, curl_easy_strerror(res));
                 error_str = std::to_string(res) + std::string(":'") + std::string(curl_easy_strerror(res)) + std::string("'");
                 call_succeeded = false;
+                retryable = (res != CURLE_ABORTED_BY_CALLBACK); // aborted on Deinitialize()
             }
-            //clean up curl object
-            curl_easy_cleanup(curl);
-            curl_slist_free_all(chunk);
 
             return call_succeeded;
         }
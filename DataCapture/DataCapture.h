@@ -24,6 +24,14 @@
 #include "AbstractPlugin.h"
 #include "libIBus.h"
 //#include "irMgr.h"
+#include <curl/curl.h>
+
+#include <atomic>
+#include <chrono>
+#include <condition_variable>
+#include <deque>
+#include <mutex>
+#include <thread>
 
 class socket_adaptor;
 
@@ -52,6 +60,16 @@ namespace WPEFramework {
             uint32_t enableAudioCaptureWrapper(const JsonObject& parameters, JsonObject& response);
             uint32_t getAudioClipWrapper(const JsonObject& parameters, JsonObject& response);
 
+        private/*internal types*/:
+            struct UploadJob
+            {
+                string fileName;
+                string dataLocator;
+                string url;
+                bool streaming;
+                std::chrono::steady_clock::time_point received;
+            };
+
         private/*internal methods*/:
             DataCapture(const DataCapture&) = delete;
             DataCapture& operator=(const DataCapture&) = delete;
@@ -63,7 +81,13 @@ namespace WPEFramework {
             int enableAudioCapture(unsigned int bufferMaxDuration);
             int getAudioClip(const JsonObject& clipRequest);
             void constructFormatString();
-            bool uploadDataToUrl(std::vector<unsigned char> &data, const char *url, std::string &error_str);
+            void uploadWorker();
+            void processClip(const UploadJob &job);
+            bool waitBeforeRetry(unsigned int attempt);
+            bool uploadDataToUrl(std::vector<unsigned char> &data, const char *url, std::string &error_str, bool &retryable);
+            bool uploadStreamToUrl(const std::vector<char> &prefetch, const char *url, std::string &error_str, size_t &uploaded);
+            bool prepareUpload(const char *url, struct curl_slist *headers);
+            bool performUpload(std::string &error_str, bool &retryable);
         private/*members*/:
             audiocapturemgr::session_id_t _session_id;
             unsigned int _max_supported_duration;
@@ -72,7 +96,14 @@ namespace WPEFramework {
             string _audio_format_string;
             string _destination_url;
             bool _is_precapture;
+            bool _is_streaming;
             unsigned int _duration;
+            CURL* _curl; // reused between uploads to keep the connection alive, upload thread only
+            std::deque<UploadJob> _upload_queue;
+            std::mutex _upload_mutex;
+            std::condition_variable _upload_cv;
+            std::thread _upload_thread;
+            std::atomic<bool> _upload_stop; // also polled by curl while an upload is in flight
             static pthread_mutex_t _mutex;
         };
     } // namespace Plugin
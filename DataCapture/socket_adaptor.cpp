@@ -81,6 +81,7 @@ int socket_adaptor::connect_socket(const std::string &path)
         } else {
             SA_ERR("connect() failed\n");
             close(m_read_fd);
+            m_read_fd = -1;
             ret = -1;
             return ret;
 
@@ -146,15 +147,46 @@ unsigned int socket_adaptor::fetch_data()
     }
     SA_WARN("%d bytes received in %u reads!\n", total_size, n);
 
-    close(m_read_fd);
+    disconnect_socket();
+
+    return total_size;
+}
+
+int socket_adaptor::read_data(char * buffer, const unsigned int size)
+{
+    if(m_read_fd < 0) {
+        SA_ERR("Unable to read data. Did you connect?");
+        return -1;
+    }
+
+    ssize_t size_recv;
+    do
+    {
+        size_recv = read(m_read_fd, buffer, size);
+    } while((size_recv < 0) && (EINTR == errno));
+
+    if(size_recv < 0)
+    {
+        SA_ERR("read() failed, errno: %d\n", errno);
+        disconnect_socket();
+        return -1;
+    }
+    else if(size_recv == 0)
+    {
+        disconnect_socket();
+    }
+    return (int)size_recv;
+}
+
+void socket_adaptor::disconnect_socket()
+{
     lock();
-    if(0 < m_read_fd)
+    if(0 <= m_read_fd)
     {
+        close(m_read_fd);
         m_read_fd = -1;
     }
     unlock();
-
-    return total_size;
 }
 
 void socket_adaptor::get_data(std::vector<unsigned char>& data)
@@ -167,8 +199,9 @@ void socket_adaptor::get_data(std::vector<unsigned char>& data)
             return;
         }
     }
-    data = m_fetch_buffer;
-    m_fetch_buffer.clear();
+    // Hand over the buffer instead of copying it, the clip can be large.
+    data.clear();
+    data.swap(m_fetch_buffer);
 }
 
 unsigned int socket_adaptor::get_data(char * buffer, const unsigned int size)
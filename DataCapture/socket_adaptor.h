@@ -133,6 +133,23 @@ class socket_adaptor
      */
     unsigned int get_data(char * buffer, const unsigned int size);
 
+    /**
+     *  @brief This api invokes unix read() once to read the next chunk of data from the socket, without buffering it.
+     *
+     *  The connection is closed at the end of the data or on an error.
+     *
+     *  @param[in] buffer Data buffer.
+     *  @param[in] size   Size of the buffer
+     *
+     *  @return Returns the number of bytes read, 0 at the end of the data or -1 in case of an error
+     */
+    int read_data(char * buffer, const unsigned int size);
+
+    /**
+     *  @brief This api closes the connection opened by connect_socket(), e.g. when reading stops before the end of the data.
+     */
+    void disconnect_socket();
+
     /**
      *  @brief This api invokes  close() to terminate the current connection.
      */
@@ -0,0 +1,53 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2020 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+#include "Module.h"
+#include <interfaces/IMessenger.h>
+#include "MessengerIds.h"
+#include <list>
+
+namespace WPEFramework {
+
+namespace Exchange {
+
+    // Room history kept by the room administrator, read on demand instead of being replayed to joining users.
+    // Local to this plugin and without a proxy, so it is only available with the administrator in process.
+    struct EXTERNAL IRoomHistory : virtual public Core::IUnknown {
+        enum { ID = ID_ROOMHISTORY };
+
+        struct Entry {
+            string User;
+            string Message;
+            bool Earlier; // sent before the user joined, so never notified to it
+        };
+
+        virtual ~IRoomHistory() {}
+
+        // Number of messages kept per room, 0 keeps none.
+        virtual void Depth(const uint16_t depth) = 0;
+
+        // The last messages, all kept ones if count is 0, of the room joined by the given user, oldest first.
+        virtual void History(const IRoomAdministrator::IRoom* room, const uint16_t count, std::list<Entry>& messages) const = 0;
+    };
+
+} // namespace Exchange
+
+} // namespace WPEFramework
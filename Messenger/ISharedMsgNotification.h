@@ -0,0 +1,43 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2020 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include "Module.h"
+#include "MessengerIds.h"
+#include <memory>
+
+namespace WPEFramework {
+
+namespace Exchange {
+
+    // Message sink taking the message by reference, so a message sent to a room is stored once however many
+    // users have it queued. Local to this plugin and without a proxy, so it is only used for in process sinks.
+    struct EXTERNAL ISharedMsgNotification : virtual public Core::IUnknown {
+        enum { ID = ID_ROOMSHAREDMSGNOTIFICATION };
+
+        virtual ~ISharedMsgNotification() {}
+
+        virtual void Message(const string& senderName, const std::shared_ptr<const string>& message) = 0;
+    };
+
+} // namespace Exchange
+
+} // namespace WPEFramework
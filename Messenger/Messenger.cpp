@@ -40,11 +40,25 @@ namespace Plugin {
         _service = service;
         _service->AddRef();
 
+        Config config;
+        config.FromString(_service->ConfigLine());
+
+        _highWaterMark = config.HighWaterMark.Value();
+        _coalesce = (config.Policy.Value() == _T("coalesce"));
+
         _roomAdmin = service->Root<Exchange::IRoomAdministrator>(_connectionId, 2000, _T("RoomMaintainer"));
         ASSERT(_roomAdmin != nullptr);
 
         _roomAdmin->Register(this);
 
+        _roomHistory = _roomAdmin->QueryInterface<Exchange::IRoomHistory>();
+        if (_roomHistory != nullptr) {
+            _roomHistory->Depth(config.History.Value());
+        }
+        else {
+            TRACE(Trace::Warning, (_T("Room history is not available, the history method is disabled")));
+        }
+
         return { };
     }
 
@@ -52,6 +66,11 @@ namespace Plugin {
     {
         ASSERT(service == _service);
 
+        // No notifications to this plugin from here on, including those still queued.
+        for (auto& sink : _sinks) {
+            sink.second->Revoke();
+        }
+
         // Exit all the rooms (if any) that were joined by this client
         for (auto& room : _roomIds) {
             room.second->Release();
@@ -59,6 +78,17 @@ namespace Plugin {
 
         _roomIds.clear();
 
+        for (auto& sink : _sinks) {
+            sink.second->Release();
+        }
+
+        _sinks.clear();
+
+        if (_roomHistory != nullptr) {
+            _roomHistory->Release();
+            _roomHistory = nullptr;
+        }
+
         _roomAdmin->Unregister(this);
         _rooms.clear();
 
@@ -77,7 +107,7 @@ namespace Plugin {
 
         string roomId = GenerateRoomId(roomName, userName);
 
-        MsgNotification* sink = Core::Service<MsgNotification>::Create<MsgNotification>(this, roomId);
+        MsgNotification* sink = Core::Service<MsgNotification>::Create<MsgNotification>(this, roomId, _highWaterMark, _coalesce);
         ASSERT(sink != nullptr);
 
         if (sink != nullptr) {
@@ -88,11 +118,15 @@ namespace Plugin {
 
                 _adminLock.Lock();
                 result = _roomIds.emplace(roomId, room).second;
-                _adminLock.Unlock();
                 ASSERT(result);
-            }
 
-            sink->Release(); // Make room the only owner of the notification object.
+                // Keep a reference for the queue statistics, released when leaving the room.
+                _sinks.emplace(roomId, sink);
+                _adminLock.Unlock();
+            }
+            else {
+                sink->Release();
+            }
         }
 
         return (result? roomId : string{});
@@ -131,6 +165,7 @@ namespace Plugin {
     bool Messenger::LeaveRoom(const string& roomId)
     {
         bool result = false;
+        MsgNotification* sink = nullptr;
 
         _adminLock.Lock();
 
@@ -142,25 +177,100 @@ namespace Plugin {
             // Invalidate the room ID.
             _roomIds.erase(it);
             result = true;
+
+            auto sit(_sinks.find(roomId));
+            if (sit != _sinks.end()) {
+                sink = (*sit).second;
+                _sinks.erase(sit);
+            }
         }
 
         _adminLock.Unlock();
 
+        if (sink != nullptr) {
+            // Waits for a notification in progress, so not under the lock.
+            sink->Revoke();
+            sink->Release();
+        }
+
         return result;
     }
 
     bool Messenger::SendMessage(const string& roomId, const string& message)
     {
-        bool result = false;
+        Exchange::IRoomAdministrator::IRoom* room = nullptr;
 
         _adminLock.Lock();
 
         auto it(_roomIds.find(roomId));
 
         if (it != _roomIds.end()) {
-            // Send the message to the room.
-            (*it).second->SendMessage(message);
-            result = true;
+            room = (*it).second;
+            room->AddRef();
+        }
+
+        _adminLock.Unlock();
+
+        if (room != nullptr) {
+            // Send the message to the room, without blocking other rooms while it is delivered.
+            room->SendMessage(message);
+            room->Release();
+        }
+
+        return (room != nullptr);
+    }
+
+    uint32_t Messenger::History(const string& roomId, const uint16_t count, Core::JSON::ArrayType<MessageData>& messages) const
+    {
+        uint32_t result = Core::ERROR_UNAVAILABLE;
+
+        if (_roomHistory != nullptr) {
+            Exchange::IRoomAdministrator::IRoom* room = nullptr;
+
+            _adminLock.Lock();
+
+            auto it(_roomIds.find(roomId));
+
+            if (it != _roomIds.end()) {
+                room = (*it).second;
+                room->AddRef();
+            }
+
+            _adminLock.Unlock();
+
+            result = Core::ERROR_UNKNOWN_KEY;
+
+            if (room != nullptr) {
+                // Read on demand and outside the lock, the history never goes through the message queues.
+                std::list<Exchange::IRoomHistory::Entry> history;
+                _roomHistory->History(room, count, history);
+                room->Release();
+
+                for (auto& entry : history) {
+                    MessageData& message(messages.Add());
+                    message.User = entry.User;
+                    message.Message = entry.Message;
+                    message.History = entry.Earlier;
+                }
+
+                result = Core::ERROR_NONE;
+            }
+        }
+
+        return (result);
+    }
+
+    bool Messenger::Queues(const string& roomId, Core::JSON::ArrayType<QueueData>& queues) const
+    {
+        bool result = roomId.empty();
+
+        _adminLock.Lock();
+
+        for (auto& sink : _sinks) {
+            if ((roomId.empty() == true) || (sink.first == roomId)) {
+                sink.second->Statistics(queues.Add());
+                result = true;
+            }
         }
 
         _adminLock.Unlock();
@@ -22,7 +22,10 @@
 #include "Module.h"
 #include <interfaces/IMessenger.h>
 #include <interfaces/json/JsonData_Messenger.h>
-#include <map>
+#include "IRoomHistory.h"
+#include "ISharedMsgNotification.h"
+#include <deque>
+#include <unordered_map>
 #include <set>
 #include <functional>
 
@@ -33,6 +36,167 @@ namespace Plugin {
     class Messenger : public PluginHost::IPlugin
                     , public Exchange::IRoomAdministrator::INotification
                     , public PluginHost::JSONRPCSupportsEventStatus {
+    public:
+        class Config : public Core::JSON::Container {
+        public:
+            Config(const Config&) = delete;
+            Config& operator=(const Config&) = delete;
+
+            Config()
+                : Core::JSON::Container()
+                , History(32)
+                , HighWaterMark(64)
+                , Policy(_T("drop"))
+            {
+                Add(_T("history"), &History);
+                Add(_T("highwatermark"), &HighWaterMark);
+                Add(_T("policy"), &Policy);
+            }
+
+            ~Config()
+            {
+            }
+
+        public:
+            Core::JSON::DecUInt16 History; // messages kept per room for the history method
+            Core::JSON::DecUInt16 HighWaterMark; // messages queued per subscriber before the policy kicks in
+            Core::JSON::String Policy; // "drop" the oldest queued message or "coalesce" it with the next one of the same user
+        };
+
+        // JSON-RPC parameters and results of the history and queues methods.
+        class HistoryParamsData : public Core::JSON::Container {
+        public:
+            HistoryParamsData(const HistoryParamsData&) = delete;
+            HistoryParamsData& operator=(const HistoryParamsData&) = delete;
+
+            HistoryParamsData()
+                : Core::JSON::Container()
+            {
+                Add(_T("roomid"), &Roomid);
+                Add(_T("count"), &Count);
+            }
+
+        public:
+            Core::JSON::String Roomid;
+            Core::JSON::DecUInt16 Count;
+        };
+
+        class MessageData : public Core::JSON::Container {
+        public:
+            MessageData& operator=(const MessageData&) = delete;
+
+            MessageData()
+                : Core::JSON::Container()
+            {
+                Add(_T("user"), &User);
+                Add(_T("message"), &Message);
+                Add(_T("history"), &History);
+            }
+
+            MessageData(const MessageData& copy)
+                : Core::JSON::Container()
+                , User(copy.User)
+                , Message(copy.Message)
+                , History(copy.History)
+            {
+                Add(_T("user"), &User);
+                Add(_T("message"), &Message);
+                Add(_T("history"), &History);
+            }
+
+        public:
+            Core::JSON::String User;
+            Core::JSON::String Message;
+            Core::JSON::Boolean History; // sent before the user joined, never notified to it
+        };
+
+        class HistoryResultData : public Core::JSON::Container {
+        public:
+            HistoryResultData(const HistoryResultData&) = delete;
+            HistoryResultData& operator=(const HistoryResultData&) = delete;
+
+            HistoryResultData()
+                : Core::JSON::Container()
+            {
+                Add(_T("messages"), &Messages);
+            }
+
+        public:
+            Core::JSON::ArrayType<MessageData> Messages;
+        };
+
+        class QueueData : public Core::JSON::Container {
+        public:
+            QueueData& operator=(const QueueData&) = delete;
+
+            QueueData()
+                : Core::JSON::Container()
+            {
+                Init();
+            }
+
+            QueueData(const QueueData& copy)
+                : Core::JSON::Container()
+                , Roomid(copy.Roomid)
+                , Depth(copy.Depth)
+                , Peak(copy.Peak)
+                , Delivered(copy.Delivered)
+                , Dropped(copy.Dropped)
+                , Coalesced(copy.Coalesced)
+            {
+                Init();
+            }
+
+        private:
+            void Init()
+            {
+                Add(_T("roomid"), &Roomid);
+                Add(_T("depth"), &Depth);
+                Add(_T("peak"), &Peak);
+                Add(_T("delivered"), &Delivered);
+                Add(_T("dropped"), &Dropped);
+                Add(_T("coalesced"), &Coalesced);
+            }
+
+        public:
+            Core::JSON::String Roomid;
+            Core::JSON::DecUInt32 Depth; // messages waiting to be notified
+            Core::JSON::DecUInt32 Peak; // highest depth seen
+            Core::JSON::DecUInt32 Delivered;
+            Core::JSON::DecUInt32 Dropped;
+            Core::JSON::DecUInt32 Coalesced;
+        };
+
+        class QueuesParamsData : public Core::JSON::Container {
+        public:
+            QueuesParamsData(const QueuesParamsData&) = delete;
+            QueuesParamsData& operator=(const QueuesParamsData&) = delete;
+
+            QueuesParamsData()
+                : Core::JSON::Container()
+            {
+                Add(_T("roomid"), &Roomid);
+            }
+
+        public:
+            Core::JSON::String Roomid;
+        };
+
+        class QueuesResultData : public Core::JSON::Container {
+        public:
+            QueuesResultData(const QueuesResultData&) = delete;
+            QueuesResultData& operator=(const QueuesResultData&) = delete;
+
+            QueuesResultData()
+                : Core::JSON::Container()
+            {
+                Add(_T("queues"), &Queues);
+            }
+
+        public:
+            Core::JSON::ArrayType<QueueData> Queues;
+        };
+
     public:
         Messenger(const Messenger&) = delete;
         Messenger& operator=(const Messenger&) = delete;
@@ -41,7 +205,11 @@ namespace Plugin {
             : _connectionId(0)
             , _service(nullptr)
             , _roomAdmin(nullptr)
+            , _roomHistory(nullptr)
             , _roomIds()
+            , _sinks()
+            , _highWaterMark(0)
+            , _coalesce(false)
             , _adminLock()
         {
             RegisterAll();
@@ -58,31 +226,155 @@ namespace Plugin {
         virtual string Information() const override  { return { }; }
 
         // Notification handling
-        class MsgNotification : public Exchange::IRoomAdministrator::IRoom::IMsgNotification {
+        // Messages are queued per subscriber and notified from the worker pool, so a slow JSON-RPC
+        // client never blocks the sender. Past the high water mark the oldest queued message is
+        // dropped, or with the coalesce policy merged with a newer one of the same user.
+        class MsgNotification : public Exchange::IRoomAdministrator::IRoom::IMsgNotification
+                              , public Exchange::ISharedMsgNotification {
+        private:
+            typedef std::pair<string, std::shared_ptr<const string>> Entry; // user, message shared by all subscribers
+
         public:
             MsgNotification(const MsgNotification&) = delete;
             MsgNotification& operator=(const MsgNotification&) = delete;
 
-            MsgNotification(Messenger* messenger, const string& roomId)
+            MsgNotification(Messenger* messenger, const string& roomId, const uint16_t highWaterMark, const bool coalesce)
                 : _messenger(messenger)
                 , _roomId(roomId)
+                , _highWaterMark(highWaterMark)
+                , _coalesce(coalesce)
+                , _queue()
+                , _peak(0)
+                , _delivered(0)
+                , _dropped(0)
+                , _coalesced(0)
+                , _lock()
+                , _job(*this)
             { /* empty */ }
 
+            ~MsgNotification()
+            {
+                _job.Revoke();
+            }
+
             // IRoom::Notification methods
             virtual void Message(const string& senderName, const string& message) override
             {
-                ASSERT(_messenger != nullptr);
-                _messenger->MessageHandler(_roomId, senderName, message);
+                Message(senderName, std::make_shared<const string>(message));
+            }
+
+            // ISharedMsgNotification methods
+            virtual void Message(const string& senderName, const std::shared_ptr<const string>& message) override
+            {
+                _lock.Lock();
+
+                if (_messenger == nullptr) {
+                    // Revoked, the messenger is going away.
+                    _lock.Unlock();
+                    return;
+                }
+
+                if ((_highWaterMark == 0) || (_queue.size() < _highWaterMark)) {
+                    _queue.emplace_back(senderName, message);
+                }
+                else if ((_coalesce == true) && (Coalesce(senderName, message) == true)) {
+                    _coalesced++;
+                }
+                else {
+                    _queue.pop_front();
+                    _queue.emplace_back(senderName, message);
+                    _dropped++;
+                }
+
+                if (_queue.size() > _peak) {
+                    _peak = static_cast<uint32_t>(_queue.size());
+                }
+
+                _lock.Unlock();
+
+                _job.Submit();
+            }
+
+            // Stops the notifications to the messenger, waiting for one in progress.
+            void Revoke()
+            {
+                _lock.Lock();
+                _messenger = nullptr;
+                _lock.Unlock();
+
+                _job.Revoke();
+            }
+
+            void Statistics(QueueData& data) const
+            {
+                _lock.Lock();
+
+                data.Roomid = _roomId;
+                data.Depth = static_cast<uint32_t>(_queue.size());
+                data.Peak = _peak;
+                data.Delivered = _delivered;
+                data.Dropped = _dropped;
+                data.Coalesced = _coalesced;
+
+                _lock.Unlock();
             }
 
             // QueryInterface implementation
             BEGIN_INTERFACE_MAP(Callback)
                 INTERFACE_ENTRY(Exchange::IRoomAdministrator::IRoom::IMsgNotification)
+                INTERFACE_ENTRY(Exchange::ISharedMsgNotification)
             END_INTERFACE_MAP
 
+        private:
+            friend Core::ThreadPool::JobType<MsgNotification&>;
+
+            // Appends the message to the newest queued one of the same user, if any. The queued text is
+            // shared with the other subscribers, so the merged one is a new string.
+            bool Coalesce(const string& senderName, const std::shared_ptr<const string>& message)
+            {
+                for (auto it = _queue.rbegin(); it != _queue.rend(); ++it) {
+                    if ((*it).first == senderName) {
+                        (*it).second = std::make_shared<const string>(*(*it).second + '\n' + *message);
+                        return (true);
+                    }
+                }
+                return (false);
+            }
+
+            void Dispatch()
+            {
+                _lock.Lock();
+
+                while ((_messenger != nullptr) && (_queue.empty() == false)) {
+                    Entry entry(std::move(_queue.front()));
+                    _queue.pop_front();
+                    _delivered++;
+
+                    Messenger* messenger = _messenger;
+
+                    _lock.Unlock();
+
+                    // Revoke() waits for this job, so the messenger outlives the call.
+                    messenger->MessageHandler(_roomId, entry.first, *entry.second);
+
+                    _lock.Lock();
+                }
+
+                _lock.Unlock();
+            }
+
         private:
             Messenger* _messenger;
             string _roomId;
+            const uint16_t _highWaterMark;
+            const bool _coalesce;
+            std::deque<Entry> _queue;
+            uint32_t _peak;
+            uint32_t _delivered;
+            uint32_t _dropped;
+            uint32_t _coalesced;
+            mutable Core::CriticalSection _lock;
+            Core::WorkerPool::JobType<MsgNotification&> _job;
         }; // class Notification
 
         // Callback handling
@@ -130,6 +422,8 @@ namespace Plugin {
         string JoinRoom(const string& roomId, const string& userName);
         bool LeaveRoom(const string& roomId);
         bool SendMessage(const string& roomId, const string& message);
+        uint32_t History(const string& roomId, const uint16_t count, Core::JSON::ArrayType<MessageData>& messages) const;
+        bool Queues(const string& roomId, Core::JSON::ArrayType<QueueData>& queues) const;
 
         void UserJoinedHandler(const string& roomId, const string& userName)
         {
@@ -177,6 +471,8 @@ namespace Plugin {
         uint32_t endpoint_join(const JsonData::Messenger::JoinParamsData& params, JsonData::Messenger::JoinResultInfo& response);
         uint32_t endpoint_leave(const JsonData::Messenger::JoinResultInfo& params);
         uint32_t endpoint_send(const JsonData::Messenger::SendParamsData& params);
+        uint32_t endpoint_history(const HistoryParamsData& params, HistoryResultData& response);
+        uint32_t endpoint_queues(const QueuesParamsData& params, QueuesResultData& response);
         void event_roomupdate(const string& room, const JsonData::Messenger::RoomupdateParamsData::ActionType& action);
         void event_userupdate(const string& id, const string& user, const JsonData::Messenger::UserupdateParamsData::ActionType& action);
         void event_message(const string& id, const string& user, const string& message);
@@ -184,7 +480,11 @@ namespace Plugin {
         uint32_t _connectionId;
         PluginHost::IShell* _service;
         Exchange::IRoomAdministrator* _roomAdmin;
-        std::map<string, Exchange::IRoomAdministrator::IRoom*> _roomIds;
+        Exchange::IRoomHistory* _roomHistory; // nullptr with the room administrator out of process
+        std::unordered_map<string, Exchange::IRoomAdministrator::IRoom*> _roomIds;
+        std::unordered_map<string, MsgNotification*> _sinks; // by room ID, for the history and queue statistics
+        uint16_t _highWaterMark;
+        bool _coalesce;
         std::set<string> _rooms;
         mutable Core::CriticalSection _adminLock;
     }; // class Messenger
@@ -0,0 +1,40 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2020 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+
+#pragma once
+
+#include "Module.h"
+#include <interfaces/Ids.h>
+
+namespace WPEFramework {
+
+namespace Exchange {
+
+    // IDs of the interfaces local to this plugin. They are not in interfaces/Ids.h, so they take a block of
+    // their own at the top of the range that header hands out, rather than an offset on another plugin's ID.
+    enum MessengerIDS {
+        ID_MESSENGER_LOCAL = ID_ENTRY + 0xFF00,
+        ID_ROOMHISTORY = ID_MESSENGER_LOCAL + 0x0001,
+        ID_ROOMSHAREDMSGNOTIFICATION = ID_MESSENGER_LOCAL + 0x0002
+    };
+
+} // namespace Exchange
+
+} // namespace WPEFramework
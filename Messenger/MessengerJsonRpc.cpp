@@ -49,10 +49,14 @@ namespace Plugin {
         Register<JoinParamsData,JoinResultInfo>(_T("join"), &Messenger::endpoint_join, this);
         Register<JoinResultInfo,void>(_T("leave"), &Messenger::endpoint_leave, this);
         Register<SendParamsData,void>(_T("send"), &Messenger::endpoint_send, this);
+        Register<HistoryParamsData,HistoryResultData>(_T("history"), &Messenger::endpoint_history, this);
+        Register<QueuesParamsData,QueuesResultData>(_T("queues"), &Messenger::endpoint_queues, this);
     }
 
     void Messenger::UnregisterAll()
     {
+        Unregister(_T("queues"));
+        Unregister(_T("history"));
         Unregister(_T("send"));
         Unregister(_T("leave"));
         Unregister(_T("join"));
@@ -115,6 +119,31 @@ namespace Plugin {
         return result? Core::ERROR_NONE : Core::ERROR_UNKNOWN_KEY;
     }
 
+    // Returns the last messages of a room, including those sent before the user joined.
+    // Return codes:
+    //  - ERROR_NONE: Success
+    //  - ERROR_UNKNOWN_KEY: The given room ID was invalid
+    //  - ERROR_UNAVAILABLE: The room history is not available
+    uint32_t Messenger::endpoint_history(const HistoryParamsData& params, HistoryResultData& response)
+    {
+        const string& roomid = params.Roomid.Value();
+
+        return History(roomid, params.Count.Value(), response.Messages);
+    }
+
+    // Returns the outbound queue statistics of one or, without a room ID, all joined users.
+    // Return codes:
+    //  - ERROR_NONE: Success
+    //  - ERROR_UNKNOWN_KEY: The given room ID was invalid
+    uint32_t Messenger::endpoint_queues(const QueuesParamsData& params, QueuesResultData& response)
+    {
+        const string& roomid = params.Roomid.Value();
+
+        bool result = Queues(roomid, response.Queues);
+
+        return result? Core::ERROR_NONE : Core::ERROR_UNKNOWN_KEY;
+    }
+
     // Notifies about room status updates.
     void Messenger::event_roomupdate(const string& room, const RoomupdateParamsData::ActionType& action)
     {
@@ -22,6 +22,7 @@
 #include "Module.h"
 #include <interfaces/IMessenger.h>
 #include "RoomMaintainer.h"
+#include "ISharedMsgNotification.h"
 
 namespace WPEFramework {
 
@@ -33,12 +34,14 @@ namespace Plugin {
         RoomImpl(const RoomImpl&) = delete;
         RoomImpl& operator=(const RoomImpl&) = delete;
 
-        RoomImpl(RoomMaintainer* admin, const string& roomId, const string& userId, IMsgNotification* messageSink)
+        RoomImpl(RoomMaintainer* admin, const string& roomId, const string& userId, IMsgNotification* messageSink, const uint64_t joined)
             : _roomId(roomId)
             , _userId(userId)
+            , _joined(joined)
             , _roomAdmin(admin)
             , _callback(nullptr)
             , _messageSink(messageSink)
+            , _sharedMessageSink(nullptr)
             , _adminLock()
         {
             ASSERT(admin != nullptr);
@@ -47,6 +50,9 @@ namespace Plugin {
 
             if (_messageSink) {
                 _messageSink->AddRef();
+
+                // Only found on sinks in this process
+                _sharedMessageSink = _messageSink->QueryInterface<Exchange::ISharedMsgNotification>();
             }
 
             if (userId.size() == 0) {
@@ -63,6 +69,10 @@ namespace Plugin {
             // Release the callback if necessary.
             SetCallback(nullptr);
 
+            if (_sharedMessageSink) {
+                _sharedMessageSink->Release();
+            }
+
             if (_messageSink) {
                 _messageSink->Release();
             }
@@ -135,16 +145,16 @@ namespace Plugin {
             _adminLock.Unlock();
         }
 
-        void MessageReceived(const string& userId, const string& message)
-        {
-            if (_messageSink != nullptr) {
-                _messageSink->Message(userId, message);
-            }
-        }
+        // Set at construction and never changed, so it can be read without the lock.
+        Exchange::IRoomAdministrator::IRoom::IMsgNotification* MessageSink() const { return _messageSink; }
+        Exchange::ISharedMsgNotification* SharedMessageSink() const { return _sharedMessageSink; }
 
         const string& UserId() const { return _userId; }
         const string& RoomId() const { return _roomId; }
 
+        // Number of messages sent to the room before this user joined.
+        uint64_t Joined() const { return _joined; }
+
         // QueryInterface implementation
         BEGIN_INTERFACE_MAP(RoomImpl)
             INTERFACE_ENTRY(Exchange::IRoomAdministrator::IRoom)
@@ -153,9 +163,11 @@ namespace Plugin {
     private:
         string _roomId;
         string _userId;
+        uint64_t _joined;
         RoomMaintainer* _roomAdmin;
         Exchange::IRoomAdministrator::IRoom::ICallback* _callback;
         Exchange::IRoomAdministrator::IRoom::IMsgNotification* _messageSink;
+        Exchange::ISharedMsgNotification* _sharedMessageSink;
         mutable Core::CriticalSection _adminLock;
     };
 
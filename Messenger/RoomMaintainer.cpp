@@ -40,8 +40,9 @@ namespace Plugin {
 
         if (it == _roomMap.end()) {
             // Room not found, so create one, already emplacing the first user.
-            newRoomUser = Core::Service<RoomImpl>::Create<RoomImpl>(this, roomId, userId, messageSink);
-            it = _roomMap.emplace(roomId, std::list<RoomImpl*>({newRoomUser})).first;
+            newRoomUser = Core::Service<RoomImpl>::Create<RoomImpl>(this, roomId, userId, messageSink, 0);
+            it = _roomMap.emplace(roomId, Room()).first;
+            (*it).second.users.emplace(userId, newRoomUser);
 
             TRACE(Trace::Information, (_T("Room Maintainer: Room '%s' created"), roomId.c_str()));
             if (roomId.size() == 0) {
@@ -55,18 +56,20 @@ namespace Plugin {
         }
         else {
             // Room already created; try to add another user.
-            std::list<RoomImpl*>& users = (*it).second;
+            Users& users = (*it).second.users;
 
-            if (std::find_if(users.begin(), users.end(), [&userId](const RoomImpl* user) { return (user->UserId() == userId);}) == users.end()) {
-                newRoomUser = Core::Service<RoomImpl>::Create<RoomImpl>(this, roomId, userId, messageSink);
+            if (users.find(userId) == users.end()) {
+                newRoomUser = Core::Service<RoomImpl>::Create<RoomImpl>(this, roomId, userId, messageSink, (*it).second.sent);
 
                 // Notify the room about a joining user.
                 // No point in sending the notification to the joining user as it cannot have its callback registered yet.
                 for (auto& user : users) {
-                    user->UserJoined(userId);
+                    user.second->UserJoined(userId);
                 }
 
-                users.push_back(newRoomUser);
+                users.emplace(userId, newRoomUser);
+
+                // Earlier messages are not replayed, the user fetches them through IRoomHistory.
             }
             else {
                 TRACE(Trace::Error, (_T("Room Maintainer: User '%s' has already joined room '%s'"),
@@ -95,18 +98,18 @@ namespace Plugin {
         ASSERT(it != _roomMap.end());
 
         if (it != _roomMap.end()) {
-            std::list<RoomImpl*>& users = (*it).second;
+            Users& users = (*it).second.users;
 
-            auto uit(std::find(users.begin(), users.end(), roomUser));
-            ASSERT(uit != users.end());
+            auto uit(users.find(roomUser->UserId()));
+            ASSERT((uit != users.end()) && ((*uit).second == roomUser));
 
-            if (uit != users.end()) {
+            if ((uit != users.end()) && ((*uit).second == roomUser)) {
                 TRACE(Trace::Information, (_T("Room Maintainer: User '%s' is leaving room '%s'"),
                         roomUser->UserId().c_str(), roomUser->RoomId().c_str()));
 
                 // Notify the room members about a leaving user.
                 for (auto& user : users) {
-                    user->UserLeft(roomUser->UserId());
+                    user.second->UserLeft(roomUser->UserId());
                 }
 
                 users.erase(uit);
@@ -138,8 +141,8 @@ namespace Plugin {
         ASSERT(it != _roomMap.end());
 
         if (it != _roomMap.end()) {
-            for (auto& user : (*it).second) {
-                roomUser->UserJoined(user->UserId());
+            for (auto& user : (*it).second.users) {
+                roomUser->UserJoined(user.first);
             }
         }
 
@@ -150,14 +153,98 @@ namespace Plugin {
     {
         ASSERT(roomUser != nullptr);
 
+        // The lock is only held to collect the recipients, so a slow message sink does not stall
+        // joins, exits and other rooms. Sinks in this process all queue the same copy of the message.
+        std::vector<Exchange::IRoomAdministrator::IRoom::IMsgNotification*> sinks;
+        std::vector<Exchange::ISharedMsgNotification*> sharedSinks;
+        const std::shared_ptr<const string> shared(std::make_shared<const string>(message));
+
         _adminLock.Lock();
 
         auto it(_roomMap.find(roomUser->RoomId()));
         ASSERT(it != _roomMap.end());
 
         if (it != _roomMap.end()) {
-            for (RoomImpl* user : (*it).second) {
-                user->MessageReceived(roomUser->UserId(), message);
+            Room& room = (*it).second;
+
+            if (_historyDepth > 0) {
+                room.history.emplace_back(room.sent, roomUser->UserId(), message);
+                if (room.history.size() > _historyDepth) {
+                    room.history.pop_front();
+                }
+            }
+
+            room.sent++;
+
+            sinks.reserve((*it).second.users.size());
+
+            for (auto& user : (*it).second.users) {
+                Exchange::ISharedMsgNotification* sharedSink = user.second->SharedMessageSink();
+                Exchange::IRoomAdministrator::IRoom::IMsgNotification* sink = user.second->MessageSink();
+
+                // Keeps the sink alive should the user leave the room while the message is being delivered.
+                if (sharedSink != nullptr) {
+                    sharedSink->AddRef();
+                    sharedSinks.push_back(sharedSink);
+                }
+                else if (sink != nullptr) {
+                    sink->AddRef();
+                    sinks.push_back(sink);
+                }
+            }
+        }
+
+        _adminLock.Unlock();
+
+        for (auto& sink : sharedSinks) {
+            sink->Message(roomUser->UserId(), shared);
+            sink->Release();
+        }
+
+        for (auto& sink : sinks) {
+            sink->Message(roomUser->UserId(), message);
+            sink->Release();
+        }
+    }
+
+    /* virtual */ void RoomMaintainer::Depth(const uint16_t depth)
+    {
+        _adminLock.Lock();
+
+        _historyDepth = depth;
+
+        for (auto& room : _roomMap) {
+            std::deque<Sent>& history = room.second.history;
+
+            while (history.size() > _historyDepth) {
+                history.pop_front();
+            }
+        }
+
+        _adminLock.Unlock();
+    }
+
+    /* virtual */ void RoomMaintainer::History(const IRoom* room, const uint16_t count, std::list<Exchange::IRoomHistory::Entry>& messages) const
+    {
+        ASSERT(room != nullptr);
+
+        // Only handed out in process, so the room is one of ours.
+        const RoomImpl* roomUser = static_cast<const RoomImpl*>(room);
+
+        _adminLock.Lock();
+
+        auto it(_roomMap.find(roomUser->RoomId()));
+
+        if (it != _roomMap.end()) {
+            const std::deque<Sent>& history = (*it).second.history;
+
+            auto index(history.cbegin());
+            if ((count > 0) && (count < history.size())) {
+                index += (history.size() - count);
+            }
+
+            for (; index != history.cend(); ++index) {
+                messages.push_back({ (*index).userId, (*index).message, ((*index).number < roomUser->Joined()) });
             }
         }
 
@@ -21,6 +21,9 @@
 
 #include "Module.h"
 #include <interfaces/IMessenger.h>
+#include "IRoomHistory.h"
+#include <deque>
+#include <unordered_map>
 
 namespace WPEFramework {
 
@@ -28,7 +31,8 @@ namespace Plugin {
 
     class RoomImpl;
 
-    class RoomMaintainer : public Exchange::IRoomAdministrator {
+    class RoomMaintainer : public Exchange::IRoomAdministrator
+                         , public Exchange::IRoomHistory {
     public:
         RoomMaintainer(const RoomMaintainer&) = delete;
         RoomMaintainer& operator=(const RoomMaintainer&) = delete;
@@ -36,6 +40,7 @@ namespace Plugin {
         RoomMaintainer()
             : _observers()
             , _roomMap()
+            , _historyDepth(32)
             , _adminLock()
         { /* empty */}
 
@@ -44,6 +49,10 @@ namespace Plugin {
         virtual void Register(INotification* sink) override;
         virtual void Unregister(const INotification* sink) override;
 
+        // IRoomHistory methods
+        virtual void Depth(const uint16_t depth) override;
+        virtual void History(const IRoom* room, const uint16_t count, std::list<Exchange::IRoomHistory::Entry>& messages) const override;
+
         // RoomMaintainer methods
         void Exit(const RoomImpl* roomUser);
         void Send(const string& message, RoomImpl* roomUser);
@@ -52,11 +61,41 @@ namespace Plugin {
         // QueryInterface implementation
         BEGIN_INTERFACE_MAP(RoomMaintainer)
             INTERFACE_ENTRY(Exchange::IRoomAdministrator)
+            INTERFACE_ENTRY(Exchange::IRoomHistory)
         END_INTERFACE_MAP
 
     private:
+        // Room members by user ID, rooms by room ID.
+        typedef std::unordered_map<string, RoomImpl*> Users;
+
+        // A sent message, numbered in its room so the history can tell the ones sent before a user joined.
+        struct Sent {
+            Sent(const uint64_t index, const string& user, const string& text)
+                : number(index)
+                , userId(user)
+                , message(text)
+            { /* empty */ }
+
+            uint64_t number;
+            string userId;
+            string message;
+        };
+
+        struct Room {
+            Room()
+                : users()
+                , sent(0)
+                , history()
+            { /* empty */ }
+
+            Users users;
+            uint64_t sent; // messages sent to the room so far
+            std::deque<Sent> history; // oldest first, at most _historyDepth messages
+        };
+
         std::list<INotification*> _observers;
-        std::map<string, std::list<RoomImpl*>> _roomMap;
+        std::unordered_map<string, Room> _roomMap;
+        uint16_t _historyDepth;
         mutable Core::CriticalSection _adminLock;
     };
 
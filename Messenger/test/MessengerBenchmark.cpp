@@ -0,0 +1,230 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+// Fan-out benchmark for the Messenger plugin.
+// N rooms with M users each; one user per room sends messages carrying their send time, every user listens
+// on its own JSON-RPC link. Reports the send call latency and the send-to-delivery latency as p50/p99/max.
+//
+// Usage: MessengerBenchmark [rooms] [users per room] [messages per room] [message size]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <mutex>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Module.h"
+
+using namespace std;
+using namespace WPEFramework;
+
+#define CALLSIGN "Messenger.1"
+#define SERVER_DETAILS "127.0.0.1:9998"
+#define DELIVERY_TIMEOUT_MS 30000
+
+/* Declare module name */
+MODULE_NAME_DECLARATION(BUILD_REFERENCE)
+
+typedef JSONRPC::LinkType<Core::JSON::IElement> Link;
+
+static mutex deliveryLock;
+static vector<uint32_t> deliveries; // microseconds
+static atomic<uint32_t> received(0);
+
+static uint64_t Now()
+{
+    return (chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// The message starts with its send time, the rest is padding.
+static void OnMessage(const JsonObject& params)
+{
+    const uint64_t now = Now();
+    const uint64_t sent = strtoull(params["message"].String().c_str(), nullptr, 10);
+
+    {
+        lock_guard<mutex> lock(deliveryLock);
+        deliveries.push_back(static_cast<uint32_t>(now - sent));
+    }
+
+    received++;
+}
+
+static void Sender(const string* roomId, uint32_t messages, uint32_t size, vector<uint32_t>* latencies, uint32_t* failed)
+{
+    Link link(_T(CALLSIGN), _T(""));
+
+    latencies->reserve(messages);
+
+    for (uint32_t n = 0; n < messages; n++) {
+        JsonObject params;
+        JsonObject result;
+        const uint64_t start = Now();
+        string message(to_string(start));
+
+        message.resize(max<size_t>(size, message.size() + 1), ' ');
+
+        params["roomid"] = *roomId;
+        params["message"] = message;
+
+        if (link.Invoke<JsonObject, JsonObject>(2000, _T("send"), params, result) != Core::ERROR_NONE) {
+            (*failed)++;
+        }
+
+        latencies->push_back(static_cast<uint32_t>(Now() - start));
+    }
+}
+
+static void Report(const char name[], vector<uint32_t>& samples, double seconds)
+{
+    if (samples.empty() == true) {
+        printf("%-9s none\n", name);
+        return;
+    }
+
+    sort(samples.begin(), samples.end());
+
+    printf("%-9s %7zu  %9.0f/s  p50 %7u us  p99 %7u us  max %7u us\n", name, samples.size(), samples.size() / seconds,
+        samples[samples.size() / 2], samples[(samples.size() * 99) / 100], samples.back());
+}
+
+static void Run(const vector<vector<string>>& roomIds, uint32_t messages, uint32_t size, uint32_t expected)
+{
+    const uint32_t rooms = static_cast<uint32_t>(roomIds.size());
+
+    deliveries.reserve(expected);
+
+    vector<vector<uint32_t>> latencies(rooms);
+    vector<uint32_t> failed(rooms, 0);
+    vector<thread> senders;
+
+    const uint64_t start = Now();
+
+    for (uint32_t r = 0; r < rooms; r++) {
+        senders.emplace_back(Sender, &roomIds[r][0], messages, size, &latencies[r], &failed[r]);
+    }
+    for (auto& sender : senders) {
+        sender.join();
+    }
+
+    const uint64_t sent = Now();
+
+    while ((received < expected) && ((Now() - sent) < (DELIVERY_TIMEOUT_MS * 1000ULL))) {
+        SleepMs(10);
+    }
+
+    const double seconds = (Now() - start) / 1000000.0;
+
+    vector<uint32_t> total;
+    uint32_t sendFailures = 0;
+    for (uint32_t r = 0; r < rooms; r++) {
+        total.insert(total.end(), latencies[r].begin(), latencies[r].end());
+        sendFailures += failed[r];
+    }
+
+    Report("send", total, (sent - start) / 1000000.0);
+    {
+        lock_guard<mutex> lock(deliveryLock);
+        Report("delivery", deliveries, seconds);
+    }
+    printf("failed sends %u, delivered %u of %u, total %.2f s\n", sendFailures, received.load(), expected, seconds);
+}
+
+static int Benchmark(int argc, char** argv)
+{
+    const uint32_t rooms = (argc > 1 ? max(1, atoi(argv[1])) : 4);
+    const uint32_t users = (argc > 2 ? max(1, atoi(argv[2])) : 8);
+    const uint32_t messages = (argc > 3 ? max(1, atoi(argv[3])) : 100);
+    const uint32_t size = (argc > 4 ? max(1, atoi(argv[4])) : 64);
+    const uint32_t expected = rooms * users * messages;
+
+    printf("%u rooms x %u users, %u messages of %u bytes per room\n", rooms, users, messages, size);
+
+    Link control(_T(CALLSIGN), _T(""));
+
+    // Room IDs are per user, and messages are notified to the designators starting with the ID of the receiving user.
+    vector<vector<string>> roomIds(rooms, vector<string>(users));
+    vector<Link*> listeners;
+    bool joined = true;
+
+    for (uint32_t r = 0; (r < rooms) && (joined == true); r++) {
+        for (uint32_t u = 0; (u < users) && (joined == true); u++) {
+            JsonObject params;
+            JsonObject result;
+            params["user"] = "user" + to_string(u);
+            params["room"] = "benchmark" + to_string(r);
+
+            if (control.Invoke<JsonObject, JsonObject>(2000, _T("join"), params, result) != Core::ERROR_NONE) {
+                printf("join failed, is %s activated and the room free?\n", CALLSIGN);
+                joined = false;
+                continue;
+            }
+
+            roomIds[r][u] = result["roomid"].String();
+
+            const string designator(roomIds[r][u] + ".client");
+            Link* listener = new Link(_T(CALLSIGN), designator.c_str());
+
+            if (listener->Subscribe<JsonObject>(1000, _T("message"), &OnMessage) != Core::ERROR_NONE) {
+                printf("subscribing to the messages of %s failed\n", designator.c_str());
+            }
+
+            listeners.push_back(listener);
+        }
+    }
+
+    if (joined == true) {
+        Run(roomIds, messages, size, expected);
+    }
+
+    for (auto& listener : listeners) {
+        listener->Unsubscribe(1000, _T("message"));
+        delete listener;
+    }
+
+    for (auto& room : roomIds) {
+        for (auto& roomId : room) {
+            if (roomId.empty() == true) {
+                continue;
+            }
+
+            JsonObject params;
+            JsonObject result;
+            params["roomid"] = roomId;
+            control.Invoke<JsonObject, JsonObject>(2000, _T("leave"), params, result);
+        }
+    }
+
+    return (joined == true ? 0 : 1);
+}
+
+int main(int argc, char** argv)
+{
+    Core::SystemInfo::SetEnvironment(_T("THUNDER_ACCESS"), (_T(SERVER_DETAILS)));
+
+    // The links are gone by the time the singletons are disposed
+    int result = Benchmark(argc, argv);
+
+    Core::Singleton::Dispose();
+
+    return (result);
+}
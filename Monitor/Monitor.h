@@ -25,6 +25,10 @@
 #include <interfaces/json/JsonData_Monitor.h>
 #include <limits>
 #include <string>
+#include <fstream>
+#include <sstream>
+#include <dirent.h>
+#include <unistd.h>
 
 static uint32_t gcd(uint32_t a, uint32_t b)
 {
@@ -69,6 +73,11 @@ namespace Plugin {
                 , _allocated()
                 , _shared()
                 , _process()
+                , _cpu()
+                , _contextSwitches()
+                , _readBytes()
+                , _writeBytes()
+                , _threads()
                 , _operational(false)
             {
             }
@@ -77,6 +86,11 @@ namespace Plugin {
                 , _allocated(copy._allocated)
                 , _shared(copy._shared)
                 , _process(copy._process)
+                , _cpu(copy._cpu)
+                , _contextSwitches(copy._contextSwitches)
+                , _readBytes(copy._readBytes)
+                , _writeBytes(copy._writeBytes)
+                , _threads(copy._threads)
                 , _operational(copy._operational)
             {
             }
@@ -92,6 +106,14 @@ namespace Plugin {
                 _shared.Set(memInterface->Shared());
                 _process.Set(memInterface->Processes());
             }
+            void Measure(const uint64_t cpu, const uint64_t contextSwitches, const uint64_t readBytes, const uint64_t writeBytes, const uint64_t threads)
+            {
+                _cpu.Set(cpu);
+                _contextSwitches.Set(contextSwitches);
+                _readBytes.Set(readBytes);
+                _writeBytes.Set(writeBytes);
+                _threads.Set(threads);
+            }
             void Operational(const bool operational)
             {
                 _operational = operational;
@@ -102,6 +124,11 @@ namespace Plugin {
                 _allocated.Reset();
                 _shared.Reset();
                 _process.Reset();
+                _cpu.Reset();
+                _contextSwitches.Reset();
+                _readBytes.Reset();
+                _writeBytes.Reset();
+                _threads.Reset();
             }
 
         public:
@@ -121,6 +148,26 @@ namespace Plugin {
             {
                 return (_process);
             }
+            inline const Core::MeasurementType<uint64_t>& Cpu() const
+            {
+                return (_cpu);
+            }
+            inline const Core::MeasurementType<uint64_t>& ContextSwitches() const
+            {
+                return (_contextSwitches);
+            }
+            inline const Core::MeasurementType<uint64_t>& ReadBytes() const
+            {
+                return (_readBytes);
+            }
+            inline const Core::MeasurementType<uint64_t>& WriteBytes() const
+            {
+                return (_writeBytes);
+            }
+            inline const Core::MeasurementType<uint64_t>& Threads() const
+            {
+                return (_threads);
+            }
             inline bool Operational() const
             {
                 return (_operational);
@@ -131,9 +178,209 @@ namespace Plugin {
             Core::MeasurementType<uint64_t> _allocated;
             Core::MeasurementType<uint64_t> _shared;
             Core::MeasurementType<uint8_t> _process;
+            Core::MeasurementType<uint64_t> _cpu; //!< percentage of one core
+            Core::MeasurementType<uint64_t> _contextSwitches; //!< per second, all threads
+            Core::MeasurementType<uint64_t> _readBytes; //!< storage reads in bytes per second
+            Core::MeasurementType<uint64_t> _writeBytes; //!< storage writes in bytes per second
+            Core::MeasurementType<uint64_t> _threads;
             bool _operational;
         };
 
+        // Samples /proc/<pid>/stat, io and task of the out-of-process host of a plugin. The host is
+        // found by its "-C <callsign>" argument, so in-process plugins yield no samples. /proc is
+        // scanned once per activation: a plugin without a host, or whose host exited, is not looked
+        // up again until Reset() is called for the next activation.
+        class ProcessObserver {
+        public:
+            ProcessObserver() = delete;
+            ProcessObserver& operator=(const ProcessObserver&) = delete;
+
+            ProcessObserver(const string& callsign)
+                : _callsign(callsign)
+                , _pid(0)
+                , _searched(false)
+                , _time(0)
+                , _ticks(0)
+                , _contextSwitches(0)
+                , _readBytes(0)
+                , _writeBytes(0)
+            {
+            }
+            ProcessObserver(const ProcessObserver& copy)
+                : _callsign(copy._callsign)
+                , _pid(copy._pid)
+                , _searched(copy._searched)
+                , _time(copy._time)
+                , _ticks(copy._ticks)
+                , _contextSwitches(copy._contextSwitches)
+                , _readBytes(copy._readBytes)
+                , _writeBytes(copy._writeBytes)
+            {
+            }
+            ~ProcessObserver()
+            {
+            }
+
+        public:
+            inline void Reset()
+            {
+                _pid = 0;
+                _searched = false;
+                _time = 0;
+            }
+            // Returns false until two consecutive samples of the same process are available.
+            bool Sample(uint64_t& cpu, uint64_t& contextSwitches, uint64_t& readBytes, uint64_t& writeBytes, uint64_t& threads)
+            {
+                uint64_t ticks = 0;
+                uint64_t switches = 0;
+                uint64_t reads = 0;
+                uint64_t writes = 0;
+
+                if ((_pid == 0) && (_searched == false)) {
+                    _searched = true;
+                    _pid = Find();
+                }
+
+                if ((_pid == 0) || (Read(_pid, ticks, threads, switches, reads, writes) == false)) {
+                    _pid = 0;
+                    _time = 0;
+                    return (false);
+                }
+
+                uint64_t now = Core::Time::Now().Ticks();
+                bool result = false;
+
+                if ((_time != 0) && (now > _time)) {
+                    static const uint64_t ticksPerSecond = sysconf(_SC_CLK_TCK);
+                    uint64_t elapsed = now - _time; // microseconds
+
+                    cpu = (Delta(ticks, _ticks) * 100 * 1000000) / (ticksPerSecond * elapsed);
+                    contextSwitches = (Delta(switches, _contextSwitches) * 1000000) / elapsed;
+                    readBytes = (Delta(reads, _readBytes) * 1000000) / elapsed;
+                    writeBytes = (Delta(writes, _writeBytes) * 1000000) / elapsed;
+                    result = true;
+                }
+
+                _time = now;
+                _ticks = ticks;
+                _contextSwitches = switches;
+                _readBytes = reads;
+                _writeBytes = writes;
+
+                return (result);
+            }
+
+        private:
+            static inline uint64_t Delta(const uint64_t current, const uint64_t previous)
+            {
+                // Counters of exited threads disappear from the task sum.
+                return (current > previous ? current - previous : 0);
+            }
+            static uint64_t Field(const string& content, const string& label)
+            {
+                size_t position = content.find(label);
+                return (position == string::npos ? 0 : strtoull(content.c_str() + position + label.length(), nullptr, 10));
+            }
+            static bool Load(const string& path, string& content)
+            {
+                std::ifstream file(path);
+                if (file.is_open() == false) {
+                    return (false);
+                }
+                std::stringstream buffer;
+                buffer << file.rdbuf();
+                content = buffer.str();
+                return (true);
+            }
+            static bool Read(const pid_t pid, uint64_t& ticks, uint64_t& threads, uint64_t& switches, uint64_t& reads, uint64_t& writes)
+            {
+                const string base(_T("/proc/") + std::to_string(pid));
+                string content;
+
+                if (Load(base + _T("/stat"), content) == false) {
+                    return (false);
+                }
+
+                // The command name may contain spaces, fields are counted from the closing parenthesis.
+                size_t position = content.rfind(')');
+                if (position == string::npos) {
+                    return (false);
+                }
+                std::istringstream fields(content.substr(position + 2));
+                string field;
+                uint64_t utime = 0, stime = 0;
+                for (uint8_t index = 3; (index <= 20) && (fields >> field); index++) {
+                    if (index == 14) {
+                        utime = strtoull(field.c_str(), nullptr, 10);
+                    } else if (index == 15) {
+                        stime = strtoull(field.c_str(), nullptr, 10);
+                    } else if (index == 20) {
+                        threads = strtoull(field.c_str(), nullptr, 10);
+                    }
+                }
+                ticks = utime + stime;
+
+                reads = 0;
+                writes = 0;
+                if (Load(base + _T("/io"), content) == true) {
+                    reads = Field(content, _T("read_bytes:"));
+                    writes = Field(content, _T("write_bytes:"));
+                }
+
+                switches = 0;
+                DIR* tasks = opendir((base + _T("/task")).c_str());
+                if (tasks != nullptr) {
+                    struct dirent* task;
+                    while ((task = readdir(tasks)) != nullptr) {
+                        if (task->d_name[0] != '.') {
+                            if (Load(base + _T("/task/") + task->d_name + _T("/status"), content) == true) {
+                                switches += Field(content, _T("voluntary_ctxt_switches:"));
+                                switches += Field(content, _T("nonvoluntary_ctxt_switches:"));
+                            }
+                        }
+                    }
+                    closedir(tasks);
+                }
+
+                return (true);
+            }
+            pid_t Find() const
+            {
+                pid_t result = 0;
+                DIR* processes = opendir(_T("/proc"));
+
+                if (processes != nullptr) {
+                    struct dirent* process;
+                    while ((result == 0) && ((process = readdir(processes)) != nullptr)) {
+                        if ((process->d_name[0] < '0') || (process->d_name[0] > '9')) {
+                            continue;
+                        }
+                        string cmdline;
+                        if (Load(string(_T("/proc/")) + process->d_name + _T("/cmdline"), cmdline) == true) {
+                            // Arguments are NUL separated.
+                            const string needle(string("-C") + '\0' + _callsign + '\0');
+                            if (cmdline.find(needle) != string::npos) {
+                                result = static_cast<pid_t>(atoi(process->d_name));
+                            }
+                        }
+                    }
+                    closedir(processes);
+                }
+
+                return (result);
+            }
+
+        private:
+            const string _callsign;
+            pid_t _pid;
+            bool _searched;
+            uint64_t _time;
+            uint64_t _ticks;
+            uint64_t _contextSwitches;
+            uint64_t _readBytes;
+            uint64_t _writeBytes;
+        };
+
         class Data : public Core::JSON::Container {
         public:
             class MetaData : public Core::JSON::Container {
@@ -237,32 +484,22 @@ namespace Plugin {
                     , Resident()
                     , Shared()
                     , Process()
+                    , Cpu()
+                    , ContextSwitches()
+                    , ReadBytes()
+                    , WriteBytes()
+                    , Threads()
                     , Operational()
                     , Count()
                 {
-                    Add(_T("allocated"), &Allocated);
-                    Add(_T("resident"), &Resident);
-                    Add(_T("shared"), &Shared);
-                    Add(_T("process"), &Process);
-                    Add(_T("operational"), &Operational);
-                    Add(_T("count"), &Count);
+                    Init();
                 }
                 MetaData(const Monitor::MetaData& input)
                     : Core::JSON::Container()
                 {
-                    Add(_T("allocated"), &Allocated);
-                    Add(_T("resident"), &Resident);
-                    Add(_T("shared"), &Shared);
-                    Add(_T("process"), &Process);
-                    Add(_T("operational"), &Operational);
-                    Add(_T("count"), &Count);
+                    Init();
 
-                    Allocated = input.Allocated();
-                    Resident = input.Resident();
-                    Shared = input.Shared();
-                    Process = input.Process();
-                    Operational = input.Operational();
-                    Count = input.Allocated().Measurements();
+                    *this = input;
                 }
                 MetaData(const MetaData& copy)
                     : Core::JSON::Container()
@@ -270,15 +507,15 @@ namespace Plugin {
                     , Resident(copy.Resident)
                     , Shared(copy.Shared)
                     , Process(copy.Process)
+                    , Cpu(copy.Cpu)
+                    , ContextSwitches(copy.ContextSwitches)
+                    , ReadBytes(copy.ReadBytes)
+                    , WriteBytes(copy.WriteBytes)
+                    , Threads(copy.Threads)
                     , Operational(copy.Operational)
                     , Count(copy.Count)
                 {
-                    Add(_T("allocated"), &Allocated);
-                    Add(_T("resident"), &Resident);
-                    Add(_T("shared"), &Shared);
-                    Add(_T("process"), &Process);
-                    Add(_T("operational"), &Operational);
-                    Add(_T("count"), &Count);
+                    Init();
                 }
                 ~MetaData()
                 {
@@ -290,6 +527,11 @@ namespace Plugin {
                     Resident = RHS.Resident;
                     Shared = RHS.Shared;
                     Process = RHS.Process;
+                    Cpu = RHS.Cpu;
+                    ContextSwitches = RHS.ContextSwitches;
+                    ReadBytes = RHS.ReadBytes;
+                    WriteBytes = RHS.WriteBytes;
+                    Threads = RHS.Threads;
                     Operational = RHS.Operational;
                     Count = RHS.Count;
 
@@ -301,17 +543,45 @@ namespace Plugin {
                     Resident = RHS.Resident();
                     Shared = RHS.Shared();
                     Process = RHS.Process();
+                    if (RHS.Cpu().Measurements() > 0) {
+                        Cpu = RHS.Cpu();
+                        ContextSwitches = RHS.ContextSwitches();
+                        ReadBytes = RHS.ReadBytes();
+                        WriteBytes = RHS.WriteBytes();
+                        Threads = RHS.Threads();
+                    }
                     Operational = RHS.Operational();
                     Count = RHS.Allocated().Measurements();
 
                     return (*this);
                 }
 
+            private:
+                void Init()
+                {
+                    Add(_T("allocated"), &Allocated);
+                    Add(_T("resident"), &Resident);
+                    Add(_T("shared"), &Shared);
+                    Add(_T("process"), &Process);
+                    Add(_T("cpu"), &Cpu);
+                    Add(_T("contextswitches"), &ContextSwitches);
+                    Add(_T("readbytes"), &ReadBytes);
+                    Add(_T("writebytes"), &WriteBytes);
+                    Add(_T("threads"), &Threads);
+                    Add(_T("operational"), &Operational);
+                    Add(_T("count"), &Count);
+                }
+
             public:
                 Measurement Allocated;
                 Measurement Resident;
                 Measurement Shared;
                 Measurement Process;
+                Measurement Cpu;
+                Measurement ContextSwitches;
+                Measurement ReadBytes;
+                Measurement WriteBytes;
+                Measurement Threads;
                 Core::JSON::Boolean Operational;
                 Core::JSON::DecUInt32 Count;
             };
@@ -391,6 +661,8 @@ namespace Plugin {
                     Add(_T("callsign"), &Callsign);
                     Add(_T("memory"), &MetaData);
                     Add(_T("memorylimit"), &MetaDataLimit);
+                    Add(_T("cpulimit"), &CpuLimit);
+                    Add(_T("cpuperiod"), &CpuPeriod);
                     Add(_T("operational"), &Operational);
                     Add(_T("restart"), &Restart);
                 }
@@ -399,12 +671,16 @@ namespace Plugin {
                     , Callsign(copy.Callsign)
                     , MetaData(copy.MetaData)
                     , MetaDataLimit(copy.MetaDataLimit)
+                    , CpuLimit(copy.CpuLimit)
+                    , CpuPeriod(copy.CpuPeriod)
                     , Operational(copy.Operational)
                     , Restart(copy.Restart)
                 {
                     Add(_T("callsign"), &Callsign);
                     Add(_T("memory"), &MetaData);
                     Add(_T("memorylimit"), &MetaDataLimit);
+                    Add(_T("cpulimit"), &CpuLimit);
+                    Add(_T("cpuperiod"), &CpuPeriod);
                     Add(_T("operational"), &Operational);
                     Add(_T("restart"), &Restart);
                 }
@@ -416,6 +692,8 @@ namespace Plugin {
                 Core::JSON::String Callsign;
                 Core::JSON::DecUInt32 MetaData;
                 Core::JSON::DecUInt32 MetaDataLimit;
+                Core::JSON::DecUInt32 CpuLimit; //!< percentage of one core, 0 disables the check
+                Core::JSON::DecUInt8 CpuPeriod; //!< consecutive measurements above cpulimit before acting
                 Core::JSON::DecSInt32 Operational;
                 RestartInfo Restart;
             };
@@ -450,7 +728,8 @@ namespace Plugin {
                 enum evaluation {
                     SUCCESFULL = 0x00,
                     NOT_OPERATIONAL = 0x01,
-                    EXCEEDED_MEMORY = 0x02
+                    EXCEEDED_MEMORY = 0x02,
+                    EXCEEDED_CPU = 0x04
                 };
 
                 typedef struct {
@@ -460,16 +739,22 @@ namespace Plugin {
 
             public:
                 MonitorObject(
+                    const string& callsign,
                     const bool actOnOperational,
                     const uint32_t operationalInterval,
                     const uint32_t memoryInterval,
                     const uint64_t memoryThreshold,
+                    const uint32_t cpuThreshold,
+                    const uint8_t cpuPeriod,
                     const uint64_t absTime,
                     const uint16_t restartWindow,
                     const uint8_t restartLimit)
                     : _operationalInterval(operationalInterval)
                     , _memoryInterval(memoryInterval)
                     , _memoryThreshold(memoryThreshold * 1024)
+                    , _cpuThreshold(cpuThreshold)
+                    , _cpuPeriod(cpuPeriod == 0 ? 1 : cpuPeriod)
+                    , _cpuExceeded(0)
                     , _operationalSlots(operationalInterval)
                     , _memorySlots(memoryInterval)
                     , _nextSlot(absTime)
@@ -478,6 +763,7 @@ namespace Plugin {
                     , _restartCount(0)
                     , _restartLimit(restartLimit)
                     , _measurement()
+                    , _process(callsign)
                     , _operationalEvaluate(actOnOperational)
                     , _source(nullptr)
                     , _active{ false }
@@ -489,6 +775,9 @@ namespace Plugin {
                     : _operationalInterval(copy._operationalInterval)
                     , _memoryInterval(copy._memoryInterval)
                     , _memoryThreshold(copy._memoryThreshold)
+                    , _cpuThreshold(copy._cpuThreshold)
+                    , _cpuPeriod(copy._cpuPeriod)
+                    , _cpuExceeded(copy._cpuExceeded)
                     , _operationalSlots(copy._operationalSlots)
                     , _memorySlots(copy._memorySlots)
                     , _nextSlot(copy._nextSlot)
@@ -497,6 +786,7 @@ namespace Plugin {
                     , _restartCount(copy._restartCount)
                     , _restartLimit(copy._restartLimit)
                     , _measurement(copy._measurement)
+                    , _process(copy._process)
                     , _operationalEvaluate(copy._operationalEvaluate)
                     , _source(copy._source)
                     , _interval(copy._interval)
@@ -593,6 +883,10 @@ namespace Plugin {
                         _source->AddRef();
                     }
 
+                    // The hosting process changes with every activation.
+                    _process.Reset();
+                    _cpuExceeded = 0;
+
                     _measurement.Operational(_source != nullptr);
                 }
                 inline uint32_t Evaluate()
@@ -618,6 +912,21 @@ namespace Plugin {
                                 status |= EXCEEDED_MEMORY;
                                 TRACE(Trace::Error, (_T("Status MetaData Exceeded. %d"), __LINE__));
                             }
+
+                            uint64_t cpu, contextSwitches, readBytes, writeBytes, threads;
+                            if (_process.Sample(cpu, contextSwitches, readBytes, writeBytes, threads) == true) {
+                                _measurement.Measure(cpu, contextSwitches, readBytes, writeBytes, threads);
+
+                                if ((_cpuThreshold != 0) && (cpu > _cpuThreshold)) {
+                                    if (++_cpuExceeded >= _cpuPeriod) {
+                                        status |= EXCEEDED_CPU;
+                                        _cpuExceeded = 0;
+                                        TRACE(Trace::Error, (_T("Status CPU Exceeded. %d"), __LINE__));
+                                    }
+                                } else {
+                                    _cpuExceeded = 0;
+                                }
+                            }
                             _memorySlots = _memoryInterval;
                         }
                     }
@@ -631,6 +940,9 @@ namespace Plugin {
                 const uint32_t _operationalInterval; //!< Interval (s) to check the monitored processes
                 const uint32_t _memoryInterval; //!<  Interval (s) for a memory measurement.
                 const uint64_t _memoryThreshold; //!< MetaData threshold in bytes for all processes.
+                const uint32_t _cpuThreshold; //!< CPU threshold in percent of one core for the hosting process.
+                const uint8_t _cpuPeriod; //!< Consecutive measurements over _cpuThreshold before acting.
+                uint8_t _cpuExceeded;
                 uint32_t _operationalSlots;
                 uint32_t _memorySlots;
                 uint64_t _nextSlot;
@@ -639,6 +951,7 @@ namespace Plugin {
                 uint32_t _restartCount;
                 uint8_t _restartLimit;
                 MetaData _measurement;
+                ProcessObserver _process;
                 bool _operationalEvaluate;
                 Exchange::IMemory* _source;
                 uint32_t _interval; //!< The greatest possible interval to check both memory and processes.
@@ -701,6 +1014,8 @@ namespace Plugin {
                     Config::Entry& element(index.Current());
                     string callSign(element.Callsign.Value());
                     uint64_t memoryThreshold(element.MetaDataLimit.Value());
+                    uint32_t cpuThreshold(element.CpuLimit.Value());
+                    uint8_t cpuPeriod(element.CpuPeriod.IsSet() ? element.CpuPeriod.Value() : 3);
                     uint32_t interval = abs(element.Operational.Value());
                     interval = interval * 1000 * 1000; // Move from Seconds to MicroSecond
                     uint32_t memory(element.MetaData.Value() * 1000 * 1000); // Move from Seconds to MicroSeconds
@@ -715,10 +1030,13 @@ namespace Plugin {
                     if ((interval != 0) || (memory != 0)) {
                         _monitor.insert(
                             std::pair<string, MonitorObject>(callSign, MonitorObject(
+                                callSign,
                                 element.Operational.Value() >= 0, 
                                 interval, 
                                 memory, 
                                 memoryThreshold, 
+                                cpuThreshold,
+                                cpuPeriod,
                                 baseTime, 
                                 restartWindow, 
                                 restartLimit)));
@@ -814,6 +1132,21 @@ namespace Plugin {
 
                 _adminLock.Unlock();
             }
+            void Snapshot(const string& callsign, Core::JSON::ArrayType<Monitor::Data>& snapshot)
+            {
+                _adminLock.Lock();
+
+                std::map<string, MonitorObject>::iterator element(_monitor.begin());
+
+                while (element != _monitor.end()) {
+                    if (((callsign.empty() == true) || (element->first == callsign)) && (element->second.HasMeasurement() == true)) {
+                        snapshot.Add(Monitor::Data(element->first, element->second.Measurement()));
+                    }
+                    element++;
+                }
+
+                _adminLock.Unlock();
+            }
             bool Snapshot(const string& name, Monitor::MetaData& result)
             {
                 bool found = false;
@@ -938,18 +1271,20 @@ namespace Plugin {
                     if (info.TimeSlot() <= scheduledTime) {
                         uint32_t value(info.Evaluate());
 
-                        if ((value & (MonitorObject::NOT_OPERATIONAL | MonitorObject::EXCEEDED_MEMORY)) != 0) {
+                        if ((value & (MonitorObject::NOT_OPERATIONAL | MonitorObject::EXCEEDED_MEMORY | MonitorObject::EXCEEDED_CPU)) != 0) {
                             PluginHost::IShell* plugin(_service->QueryInterfaceByCallsign<PluginHost::IShell>(index->first));
 
                             if (plugin != nullptr) {
+                                // There is no CPU specific reason, a runaway process is restarted as a FAILURE.
                                 Core::EnumerateType<PluginHost::IShell::reason> why(((value & MonitorObject::EXCEEDED_MEMORY) != 0) ? PluginHost::IShell::MEMORY_EXCEEDED : PluginHost::IShell::FAILURE);
+                                const string reason((((value & (MonitorObject::EXCEEDED_MEMORY | MonitorObject::EXCEEDED_CPU)) == MonitorObject::EXCEEDED_CPU) ? _T("CPU_EXCEEDED") : why.Data()));
 
-                                const string message("{\"callsign\": \"" + plugin->Callsign() + "\", \"action\": \"Deactivate\", \"reason\": \"" + why.Data() + "\" }");
-                                SYSLOG(Trace::Fatal, (_T("FORCED Shutdown: %s by reason: %s."), plugin->Callsign().c_str(), why.Data()));
+                                const string message("{\"callsign\": \"" + plugin->Callsign() + "\", \"action\": \"Deactivate\", \"reason\": \"" + reason + "\" }");
+                                SYSLOG(Trace::Fatal, (_T("FORCED Shutdown: %s by reason: %s."), plugin->Callsign().c_str(), reason.c_str()));
 
                                 _service->Notify(message);
 
-                                _parent.event_action(plugin->Callsign(), "Deactivate", why.Data());
+                                _parent.event_action(plugin->Callsign(), "Deactivate", reason);
 
                                 Core::IWorkerPool::Instance().Submit(PluginHost::IShell::Job::Create(plugin, PluginHost::IShell::DEACTIVATED, why.Value()));
 
@@ -1069,6 +1404,7 @@ namespace Plugin {
         uint32_t endpoint_restartlimits(const JsonData::Monitor::RestartlimitsParamsData& params);
         uint32_t endpoint_resetstats(const JsonData::Monitor::ResetstatsParamsData& params, JsonData::Monitor::InfoInfo& response);
         uint32_t get_status(const string& index, Core::JSON::ArrayType<JsonData::Monitor::InfoInfo>& response) const;
+        uint32_t get_resources(const string& index, Core::JSON::ArrayType<Monitor::Data>& response) const;
         void event_action(const string& callsign, const string& action, const string& reason);
     };
 }
@@ -35,6 +35,7 @@ namespace Plugin {
         Register<RestartlimitsParamsData,void>(_T("restartlimits"), &Monitor::endpoint_restartlimits, this);
         Register<ResetstatsParamsData,InfoInfo>(_T("resetstats"), &Monitor::endpoint_resetstats, this);
         Property<Core::JSON::ArrayType<InfoInfo>>(_T("status"), &Monitor::get_status, nullptr, this);
+        Property<Core::JSON::ArrayType<Monitor::Data>>(_T("resources"), &Monitor::get_resources, nullptr, this);
     }
 
     void Monitor::UnregisterAll()
@@ -42,6 +43,7 @@ namespace Plugin {
         Unregister(_T("resetstats"));
         Unregister(_T("restartlimits"));
         Unregister(_T("status"));
+        Unregister(_T("resources"));
     }
 
     // API implementation
@@ -85,6 +87,16 @@ namespace Plugin {
         return Core::ERROR_NONE;
     }
 
+    // Property: resources - The memory, CPU, I/O and thread statistics either for a single plugin or all plugins watched by the Monitor
+    // Return codes:
+    //  - ERROR_NONE: Success
+    uint32_t Monitor::get_resources(const string& index, Core::JSON::ArrayType<Monitor::Data>& response) const
+    {
+        const string& callsign = index;
+        _monitor->Snapshot(callsign, response);
+        return Core::ERROR_NONE;
+    }
+
     // Event: action - Signals action taken by the monitor
     void Monitor::event_action(const string& callsign, const string& action, const string& reason)
     {
@@ -109,7 +109,9 @@ namespace Plugin {
             uint32_t _systems;
         };
 
-        typedef Core::IteratorType<const std::list<KeyId>, const KeyId&, std::list<KeyId>::const_iterator> Iterator;
+        // A session carries a handful of key ids, a flat vector is faster to search than a list
+        typedef std::vector<KeyId> KeyIds;
+        typedef Core::IteratorType<const KeyIds, const KeyId&, KeyIds::const_iterator> Iterator;
 
     public:
         CommonEncryptionData(const uint8_t data[], const uint16_t length)
@@ -134,7 +136,7 @@ namespace Plugin {
         {
             ::OCDM::ISession::KeyStatus result(::OCDM::ISession::StatusPending);
             if (key.IsValid() == true) {
-                std::list<KeyId>::const_iterator index(std::find(_keyIds.begin(), _keyIds.end(), key));
+                KeyIds::const_iterator index(std::find(_keyIds.begin(), _keyIds.end(), key));
                 if (index != _keyIds.end()) {
                     result = index->Status();
                 }
@@ -151,7 +153,7 @@ namespace Plugin {
         }
         inline void AddKeyId(const KeyId& key)
         {
-            std::list<KeyId>::iterator index(std::find(_keyIds.begin(), _keyIds.end(), key));
+            KeyIds::iterator index(std::find(_keyIds.begin(), _keyIds.end(), key));
 
             if (index == _keyIds.end()) {
                 TRACE(Trace::Information, (_T("Added key: %s for system: %02X\n"), key.ToString().c_str(), key.Systems()));
@@ -161,13 +163,14 @@ namespace Plugin {
                 index->Flag(key.Systems());
             }
         }
+        // The returned entry is only valid until the next key is added
         inline const KeyId* UpdateKeyStatus(::OCDM::ISession::KeyStatus status, const KeyId& key)
         {
             KeyId* entry = nullptr;
 
             ASSERT(key.IsValid() == true);
 
-            std::list<KeyId>::iterator index(std::find(_keyIds.begin(), _keyIds.end(), key));
+            KeyIds::iterator index(std::find(_keyIds.begin(), _keyIds.end(), key));
 
             if (index == _keyIds.end()) {
                 _keyIds.emplace_back(key);
@@ -183,17 +186,10 @@ namespace Plugin {
         {
 
             bool result = true;
-            std::list<KeyId>::const_iterator requested(keys._keyIds.begin());
+            KeyIds::const_iterator requested(keys._keyIds.begin());
 
             while ((requested != keys._keyIds.end()) && (result == true)) {
-                std::list<KeyId>::const_iterator index(_keyIds.begin());
-
-                while ((index != _keyIds.end()) && (*index != *requested)) {
-                    index++;
-                }
-
-                result = (index != _keyIds.end());
-
+                result = (std::find(_keyIds.begin(), _keyIds.end(), *requested) != _keyIds.end());
                 requested++;
             }
 
@@ -477,7 +473,7 @@ namespace Plugin {
         }
 
     private:
-        std::list<KeyId> _keyIds;
+        KeyIds _keyIds;
     };
 }
 } // namespace WPEFramework::Plugin
@@ -0,0 +1,80 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2020 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+// Layout of a batch of samples in the data area of the session DataExchange
+// buffer. This header is shared between the OCDM plugin and the client
+// library, so it must not depend on the framework.
+//
+// A client marks a request as a batch by leaving the IV of the exchange empty
+// and starting the data area with a Header. The worker decrypts all samples
+// on one RequestConsume/Consumed handshake instead of one per sample:
+//
+//  +--------+--------------------+---------------------+---------------------+
+//  | Header | Sample[count]      | subsample maps      | sample data         |
+//  +--------+--------------------+---------------------+---------------------+
+//
+// Offsets are relative to the start of the data area and sample data must lie
+// after the Sample descriptors. A subsample map is an array of subSamples
+// (clear, encrypted) uint32_t pairs, as taken by
+// CDMi::IMediaKeySession::Decrypt. The clear data is written back in place
+// of the encrypted data, length and status are updated per sample and the
+// exchange status is the first failing sample status, 0 when all succeeded.
+// All fields are in the byte order of the writer.
+
+#include <stdint.h>
+
+namespace WPEFramework {
+namespace Plugin {
+namespace DecryptBatch {
+
+    static constexpr char Magic[8] = { 'O', 'C', 'D', 'M', 'B', 'A', 'T', '\0' };
+    static constexpr uint32_t Version = 1;
+    static constexpr uint8_t MaxIVLength = 16;
+    static constexpr uint8_t MaxKeyIdLength = 16;
+
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t count; // number of samples following this header
+    };
+
+    struct Sample {
+        uint32_t offset; // sample data
+        uint32_t length; // encrypted length, clear length on return
+        uint32_t subSampleOffset; // subsample map, unused if subSamples is 0
+        uint32_t subSamples; // number of (clear, encrypted) pairs
+        int32_t status; // CDMi result, filled in by the worker
+        uint8_t ivLength;
+        uint8_t keyIdLength;
+        uint8_t initWithLast15;
+        uint8_t reserved;
+        uint8_t iv[MaxIVLength];
+        uint8_t keyId[MaxKeyIdLength];
+    };
+
+    static constexpr uint32_t Size(const uint32_t count)
+    {
+        return (sizeof(Header) + (count * sizeof(Sample)));
+    }
+
+} // namespace DecryptBatch
+} // namespace Plugin
+} // namespace WPEFramework
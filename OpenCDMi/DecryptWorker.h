@@ -0,0 +1,192 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2020 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+// Decrypts the request a client placed in the data area of a session buffer,
+// a single sample or a DecryptBatch of samples, see DecryptBatch.h.
+//
+// EXCHANGE is the server side of the buffer, the ::OCDM::DataExchange of the
+// session in the plugin. It is a template argument so the decrypt path can be
+// driven without the shared memory, as the decrypt benchmark in test does.
+
+#include <string.h>
+#include <vector>
+
+#include <interfaces/IDRM.h>
+
+#include "DecryptBatch.h"
+
+namespace WPEFramework {
+namespace Plugin {
+
+    template <typename EXCHANGE>
+    class DecryptWorker {
+    public:
+        DecryptWorker() = delete;
+        DecryptWorker(const DecryptWorker&) = delete;
+        DecryptWorker& operator=(const DecryptWorker&) = delete;
+
+        DecryptWorker(CDMi::IMediaKeySession* mediaKeys)
+            : _mediaKeys(mediaKeys)
+            , _sessionKey(nullptr)
+            , _sessionKeyLength(0)
+            , _subSamples()
+        {
+        }
+        ~DecryptWorker() = default;
+
+    public:
+        // Returns the status for the exchange, 0 on success
+        uint32_t Decrypt(EXCHANGE& exchange)
+        {
+            DecryptBatch::Header header;
+            uint32_t result;
+
+            // A batch has no IV of its own, each sample carries one
+            if ((exchange.IVKeyLength() == 0) && (exchange.BytesWritten() >= sizeof(header)) && (::memcmp(exchange.Buffer(), DecryptBatch::Magic, sizeof(DecryptBatch::Magic)) == 0)) {
+                ::memcpy(&header, exchange.Buffer(), sizeof(header));
+                result = DecryptSamples(exchange, header);
+            } else {
+                result = DecryptSample(exchange);
+            }
+
+            return (result);
+        }
+
+    private:
+        uint32_t DecryptSample(EXCHANGE& exchange)
+        {
+            uint32_t clearContentSize = 0;
+            uint8_t* clearContent = nullptr;
+            uint8_t keyIdLength = 0;
+            const uint8_t* keyIdData = exchange.KeyId(keyIdLength);
+
+            int cr = _mediaKeys->Decrypt(
+                _sessionKey,
+                _sessionKeyLength,
+                nullptr, //subsamples
+                0, //number of subsamples
+                exchange.IVKey(),
+                exchange.IVKeyLength(),
+                exchange.Buffer(),
+                exchange.BytesWritten(),
+                &clearContentSize,
+                &clearContent,
+                keyIdLength,
+                keyIdData,
+                exchange.InitWithLast15());
+            if ((cr == 0) && (clearContentSize != 0)) {
+                if (clearContentSize != exchange.BytesWritten()) {
+                    TRACE(Trace::Information, (_T("Returned clear sample size (%d) differs from encrypted buffer size (%d)"), clearContentSize, exchange.BytesWritten()));
+                    exchange.Size(clearContentSize);
+                }
+
+                // Adjust the buffer on our sied (this process) on what we will write back
+                exchange.SetBuffer(0, clearContentSize, clearContent);
+            }
+
+            return (static_cast<uint32_t>(cr));
+        }
+
+        uint32_t DecryptSamples(EXCHANGE& exchange, const DecryptBatch::Header& header)
+        {
+            const uint32_t available = exchange.BytesWritten();
+            uint32_t result = CDMi::CDMi_SUCCESS;
+
+            if ((header.version != DecryptBatch::Version) || (header.count == 0) || (header.count > (available / sizeof(DecryptBatch::Sample))) || (DecryptBatch::Size(header.count) > available)) {
+                TRACE(Trace::Error, (_T("Invalid decrypt batch, version %d with %d samples in %d bytes"), header.version, header.count, available));
+                return (CDMi::CDMi_INVALID_ARG);
+            }
+
+            // Sample data starts after the descriptors, as the clear data is written back in place
+            const uint32_t first = DecryptBatch::Size(header.count);
+
+            for (uint32_t index = 0; index < header.count; index++) {
+                const uint32_t position = DecryptBatch::Size(index);
+                DecryptBatch::Sample sample;
+
+                ::memcpy(&sample, &(exchange.Buffer()[position]), sizeof(sample));
+
+                sample.status = DecryptBatchSample(exchange, sample, first, available);
+
+                if ((sample.status != CDMi::CDMi_SUCCESS) && (result == CDMi::CDMi_SUCCESS)) {
+                    result = static_cast<uint32_t>(sample.status);
+                }
+
+                exchange.SetBuffer(position, sizeof(sample), reinterpret_cast<const uint8_t*>(&sample));
+            }
+
+            return (result);
+        }
+
+        int32_t DecryptBatchSample(EXCHANGE& exchange, DecryptBatch::Sample& sample, const uint32_t first, const uint32_t available)
+        {
+            if ((sample.offset < first) || (sample.offset > available) || (sample.length > (available - sample.offset)) || (sample.ivLength > DecryptBatch::MaxIVLength) || (sample.keyIdLength > DecryptBatch::MaxKeyIdLength) || (sample.subSamples > ((available / (2 * sizeof(uint32_t))))) || ((sample.subSamples != 0) && ((sample.subSampleOffset > available) || ((sample.subSamples * 2 * sizeof(uint32_t)) > (available - sample.subSampleOffset))))) {
+                TRACE(Trace::Error, (_T("Invalid sample in decrypt batch, %d bytes at %d"), sample.length, sample.offset));
+                return (CDMi::CDMi_INVALID_ARG);
+            }
+
+            // The map may not be aligned in the buffer, the reused copy avoids an allocation per sample
+            _subSamples.resize(sample.subSamples * 2);
+            if (sample.subSamples != 0) {
+                ::memcpy(_subSamples.data(), &(exchange.Buffer()[sample.subSampleOffset]), sample.subSamples * 2 * sizeof(uint32_t));
+            }
+
+            uint32_t clearContentSize = 0;
+            uint8_t* clearContent = nullptr;
+
+            int cr = _mediaKeys->Decrypt(
+                _sessionKey,
+                _sessionKeyLength,
+                (sample.subSamples != 0 ? _subSamples.data() : nullptr),
+                sample.subSamples,
+                sample.iv,
+                sample.ivLength,
+                &(exchange.Buffer()[sample.offset]),
+                sample.length,
+                &clearContentSize,
+                &clearContent,
+                sample.keyIdLength,
+                (sample.keyIdLength != 0 ? sample.keyId : nullptr),
+                (sample.initWithLast15 != 0));
+
+            if ((cr == 0) && (clearContentSize != 0)) {
+                if (clearContentSize > sample.length) {
+                    // Does not fit in place, the other samples would be overwritten
+                    TRACE(Trace::Error, (_T("Returned clear sample size (%d) exceeds encrypted sample size (%d)"), clearContentSize, sample.length));
+                    return (CDMi::CDMi_BUFFER_TOO_SMALL);
+                }
+
+                exchange.SetBuffer(sample.offset, clearContentSize, clearContent);
+                sample.length = clearContentSize;
+            }
+
+            return (cr);
+        }
+
+    private:
+        CDMi::IMediaKeySession* _mediaKeys;
+        uint8_t* _sessionKey;
+        uint32_t _sessionKeyLength;
+        std::vector<uint32_t> _subSamples;
+    };
+
+} // namespace Plugin
+} // namespace WPEFramework
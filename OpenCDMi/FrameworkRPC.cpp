@@ -23,6 +23,7 @@
 
 #include "Module.h"
 #include "CENCParser.h"
+#include "DecryptWorker.h"
 
 // Get in the definitions required for access to the sepcific
 // DRM engines.
@@ -247,8 +248,7 @@ namespace Plugin {
                         , Core::Thread(Core::Thread::DefaultStackSize(), _T("DRMSessionThread"))
                         , _mediaKeys(mediaKeys)
                         , _mediaKeysExt(dynamic_cast<CDMi::IMediaKeySessionExt*>(mediaKeys))
-                        , _sessionKey(nullptr)
-                        , _sessionKeyLength(0)
+                        , _decryptor(mediaKeys)
                     {
                         Core::Thread::Run();
                         TRACE(Trace::Information, (_T("Constructing buffer server side: %p - %s"), this, name.c_str()));
@@ -271,41 +271,10 @@ namespace Plugin {
 
                         while (IsRunning() == true) {
 
-                            uint32_t clearContentSize = 0;
-                            uint8_t* clearContent = nullptr;
-
                             RequestConsume(Core::infinite);
 
                             if (IsRunning() == true) {
-                                uint8_t keyIdLength = 0;
-                                const uint8_t* keyIdData = KeyId(keyIdLength);
-
-                                int cr = _mediaKeys->Decrypt(
-                                    _sessionKey,
-                                    _sessionKeyLength,
-                                    nullptr, //subsamples
-                                    0, //number of subsamples
-                                    IVKey(),
-                                    IVKeyLength(),
-                                    Buffer(),
-                                    BytesWritten(),
-                                    &clearContentSize,
-                                    &clearContent,
-                                    keyIdLength,
-                                    keyIdData,
-                                    InitWithLast15());
-                                if ((cr == 0) && (clearContentSize != 0)) {
-                                    if (clearContentSize != BytesWritten()) {
-                                        TRACE(Trace::Information, (_T("Returned clear sample size (%d) differs from encrypted buffer size (%d)"), clearContentSize, BytesWritten()));
-                                        Size(clearContentSize);
-                                    }
-
-                                    // Adjust the buffer on our sied (this process) on what we will write back
-                                    SetBuffer(0, clearContentSize, clearContent);
-                                }
-
-                                // Store the status we have for the other side.
-                                Status(static_cast<uint32_t>(cr));
+                                Status(_decryptor.Decrypt(*this));
 
                                 // Whatever the result, we are done with the buffer..
                                 Consumed();
@@ -318,8 +287,7 @@ namespace Plugin {
                 private:
                     CDMi::IMediaKeySession* _mediaKeys;
                     CDMi::IMediaKeySessionExt* _mediaKeysExt;
-                    uint8_t* _sessionKey;
-                    uint32_t _sessionKeyLength;
+                    DecryptWorker<DataExchange> _decryptor;
                 };
 
                 // IMediaKeys defines the MediaKeys interface.
@@ -399,12 +367,12 @@ namespace Plugin {
                         else
                             key = ::OCDM::ISession::InternalError;
 
-                        const CommonEncryptionData::KeyId* updated = _parent._cencData.UpdateKeyStatus(key, keyId);
+                        CommonEncryptionData::KeyId updated;
 
-                        ASSERT (updated != nullptr);
+                        _parent.UpdateKeyStatus(key, keyId, updated);
 
                         if (_callback != nullptr) {
-                            _callback->OnKeyStatusUpdate(updated->Id(), updated->Length(), key);
+                            _callback->OnKeyStatusUpdate(updated.Id(), updated.Length(), key);
                         }
                     }
                     void Revoke(::OCDM::ISession::ICallback* callback)
@@ -445,6 +413,7 @@ namespace Plugin {
                     , _mediaKeySessionExt(dynamic_cast<CDMi::IMediaKeySessionExt*>(mediaKeySession))
                     , _sink(this, callback)
                     , _buffer(nullptr)
+                    , _keyLock()
                     , _cencData(*sessionData)
                 {
                     ASSERT(parent != nullptr);
@@ -470,6 +439,7 @@ namespace Plugin {
                     , _mediaKeySessionExt(mediaKeySession)
                     , _sink(this, callback)
                     , _buffer(nullptr)
+                    , _keyLock()
                     , _cencData(*sessionData)
                 {
                     ASSERT(parent != nullptr);
@@ -502,13 +472,39 @@ namespace Plugin {
                 }
 
             public:
+                // _cencData is guarded by _keyLock, it is updated from the DRM system and read
+                // by the accessor and the clients. Never take the accessor lock while holding it.
                 inline bool IsSupported(const CommonEncryptionData& keyIds, const string& keySystem) const
                 {
-                    return ((keySystem == _keySystem) && (_cencData.IsSupported(keyIds) == true));
+                    if (keySystem != _keySystem) {
+                        return (false);
+                    }
+
+                    _keyLock.Lock();
+                    bool result = _cencData.IsSupported(keyIds);
+                    _keyLock.Unlock();
+
+                    return (result);
                 }
                 inline bool HasKeyId(const OCDM::KeyId& keyId) const
                 {
-                    return (_cencData.HasKeyId(keyId));
+                    _keyLock.Lock();
+                    bool result = _cencData.HasKeyId(keyId);
+                    _keyLock.Unlock();
+
+                    return (result);
+                }
+                inline void UpdateKeyStatus(const ::OCDM::ISession::KeyStatus status, const CommonEncryptionData::KeyId& keyId, CommonEncryptionData::KeyId& updated)
+                {
+                    _keyLock.Lock();
+
+                    const CommonEncryptionData::KeyId* entry = _cencData.UpdateKeyStatus(status, keyId);
+
+                    ASSERT(entry != nullptr);
+
+                    updated = *entry;
+
+                    _keyLock.Unlock();
                 }
                 virtual std::string SessionId() const override
                 {
@@ -522,12 +518,22 @@ namespace Plugin {
 
                 virtual ::OCDM::ISession::KeyStatus Status() const override
                 {
-                    return (_cencData.Status());
+                    _keyLock.Lock();
+                    ::OCDM::ISession::KeyStatus result = _cencData.Status();
+                    _keyLock.Unlock();
+
+                    return (result);
                 }
 
                 ::OCDM::ISession::KeyStatus Status(const uint8_t keyId[], const uint8_t length) const override
                 {
-                    return (_cencData.Status(CommonEncryptionData::KeyId(static_cast<CommonEncryptionData::systemType>(0), keyId, length)));
+                    const CommonEncryptionData::KeyId key(static_cast<CommonEncryptionData::systemType>(0), keyId, length);
+
+                    _keyLock.Lock();
+                    ::OCDM::ISession::KeyStatus result = _cencData.Status(key);
+                    _keyLock.Unlock();
+
+                    return (result);
                 }
 
                 ::OCDM::OCDM_RESULT CreateSessionBuffer(std::string& bufferID) override {
@@ -663,6 +669,7 @@ namespace Plugin {
                 CDMi::IMediaKeySessionExt* _mediaKeySessionExt;
                 Core::Sink<Sink> _sink;
                 DataExchange* _buffer;
+                mutable Core::CriticalSection _keyLock;
                 CommonEncryptionData _cencData;
             };
 
@@ -750,16 +757,15 @@ namespace Plugin {
                                  _adminLock.Lock();
 
                                  _sessionList.push_front(newEntry);
-                                
-                                if(false == keyIds.IsEmpty())
-                                {
-                                    CommonEncryptionData::Iterator index(keyIds.Keys());
-                                    while (index.Next() == true) {
-                                        const CommonEncryptionData::KeyId& entry(index.Current());
-                                        callback->OnKeyStatusUpdate( entry.Id(), entry.Length(), ::OCDM::ISession::StatusPending);
-                                    }
-                                }
-                                _adminLock.Unlock();
+
+                                 _adminLock.Unlock();
+
+                                 // Calls into the client, no need to hold up the other sessions for that
+                                 CommonEncryptionData::Iterator index(keyIds.Keys());
+                                 while (index.Next() == true) {
+                                     const CommonEncryptionData::KeyId& entry(index.Current());
+                                     callback->OnKeyStatusUpdate( entry.Id(), entry.Length(), ::OCDM::ISession::StatusPending);
+                                 }
                          }
                      }
                  }
@@ -936,6 +942,8 @@ namespace Plugin {
             {
                 ::OCDM::ISession* result = nullptr;
 
+                _adminLock.Lock();
+
                 std::list<SessionImplementation*>::const_iterator index(_sessionList.begin());
 
                 while ((index != _sessionList.end()) && (result == nullptr)) {
@@ -947,15 +955,31 @@ namespace Plugin {
                         index++;
                     }
                 }
+
+                _adminLock.Unlock();
+
                 return (result);
             }
             void Remove(SessionImplementation* session, const string& keySystem, CDMi::IMediaKeySession* mediaKeySession)
             {
+                ASSERT(session != nullptr);
 
-                _adminLock.Lock();
+                if (session != nullptr) {
 
-                ASSERT(session != nullptr);
+                    _adminLock.Lock();
+
+                    std::list<SessionImplementation*>::iterator index(std::find(_sessionList.begin(), _sessionList.end(), session));
+
+                    ASSERT(index != _sessionList.end());
 
+                    if (index != _sessionList.end()) {
+                        _sessionList.erase(index);
+                    }
+
+                    _adminLock.Unlock();
+                }
+
+                // The session can no longer be found, tear it down without holding up the others
                 if (mediaKeySession != nullptr) {
 
                     mediaKeySession->Run(nullptr);
@@ -975,23 +999,7 @@ namespace Plugin {
                     if( bufferid.empty() == false ) {
                         _administrator.ReleaseBuffer(bufferid);
                     }
-
-                    std::list<SessionImplementation*>::iterator index(_sessionList.begin());
-
-                    while ((index != _sessionList.end()) && (session != (*index))) {
-                        index++;
-                    }
-
-                    ASSERT(index != _sessionList.end());
-
-                    if (index != _sessionList.end()) {
-                        const string sessionId(session->SessionId());
-                        // Before we remove it here, release it.
-                        _sessionList.erase(index);
-                    }
                 }
-
-                _adminLock.Unlock();
             }
 
         private:
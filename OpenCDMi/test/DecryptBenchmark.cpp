@@ -0,0 +1,294 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2020 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Decrypt throughput benchmark of the OCDM session worker, one sample per
+// request against DecryptBatch requests, with a stub CDMi::IMediaKeySession
+// that copies the data. The shared memory buffer is replaced by an in-process
+// stand-in with a request/response handshake between two threads, so this
+// measures the decrypt path and a thread wake-up per request; the semaphore
+// round trip between processes costs more, the gain of batching is larger.
+//
+// Usage: DecryptBenchmark [samples] [sample size] [samples per batch] [subsamples]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <algorithm>
+#include <chrono>
+#include <condition_variable>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "Module.h"
+
+#include "DecryptWorker.h"
+
+using namespace std;
+using namespace WPEFramework;
+using namespace WPEFramework::Plugin;
+
+/* Declare module name */
+MODULE_NAME_DECLARATION(BUILD_REFERENCE)
+
+// Returns the encrypted data as the clear data, from memory it owns like most CDMs.
+class StubSession : public CDMi::IMediaKeySession {
+public:
+    StubSession(const StubSession&) = delete;
+    StubSession& operator=(const StubSession&) = delete;
+
+    StubSession()
+        : _clear()
+        , _decrypts(0)
+    {
+    }
+    ~StubSession() override = default;
+
+    void Run(const CDMi::IMediaKeySessionCallback*) override {}
+    CDMi::CDMi_RESULT Load() override { return (CDMi::CDMi_SUCCESS); }
+    void Update(const uint8_t*, uint32_t) override {}
+    CDMi::CDMi_RESULT Remove() override { return (CDMi::CDMi_SUCCESS); }
+    CDMi::CDMi_RESULT Close() override { return (CDMi::CDMi_SUCCESS); }
+    const char* GetSessionId() const override { return ("benchmark"); }
+    const char* GetKeySystem() const override { return ("org.benchmark.stub"); }
+
+    CDMi::CDMi_RESULT Decrypt(const uint8_t*, uint32_t, const uint32_t*, uint32_t, const uint8_t*, uint32_t,
+        const uint8_t* data, uint32_t length, uint32_t* clearLength, uint8_t** clear, const uint8_t, const uint8_t*, bool) override
+    {
+        _clear.resize(length);
+        ::memcpy(_clear.data(), data, length);
+        _decrypts++;
+
+        *clearLength = length;
+        *clear = _clear.data();
+
+        return (CDMi::CDMi_SUCCESS);
+    }
+
+    CDMi::CDMi_RESULT ReleaseClearContent(const uint8_t*, uint32_t, const uint32_t, uint8_t*) override
+    {
+        return (CDMi::CDMi_SUCCESS);
+    }
+
+    uint32_t Decrypts() const
+    {
+        return (_decrypts);
+    }
+
+private:
+    std::vector<uint8_t> _clear;
+    uint32_t _decrypts;
+};
+
+// The calls the worker makes on the session buffer, on process memory, plus
+// the produce/consume handshake of the real buffer.
+class Exchange {
+public:
+    Exchange(const Exchange&) = delete;
+    Exchange& operator=(const Exchange&) = delete;
+
+    Exchange(const uint32_t size)
+        : _data(size)
+        , _written(0)
+        , _ivLength(0)
+        , _status(0)
+        , _produced(false)
+        , _stop(false)
+        , _lock()
+        , _signal()
+    {
+        ::memset(_iv, 0, sizeof(_iv));
+    }
+
+public:
+    // Worker side
+    uint8_t IVKeyLength() const { return (_ivLength); }
+    const uint8_t* IVKey() const { return (_iv); }
+    const uint8_t* KeyId(uint8_t& length) const { length = 0; return (nullptr); }
+    bool InitWithLast15() const { return (false); }
+    uint32_t BytesWritten() const { return (_written); }
+    uint8_t* Buffer() { return (_data.data()); }
+    void Size(const uint32_t size) { _written = size; }
+    void SetBuffer(const uint32_t position, const uint32_t size, const uint8_t* data) { ::memcpy(&(_data[position]), data, size); }
+
+    // Blocks until a request was produced, false when stopped
+    bool RequestConsume()
+    {
+        unique_lock<mutex> lock(_lock);
+        _signal.wait(lock, [this]() { return ((_produced == true) || (_stop == true)); });
+        return (_stop == false);
+    }
+    void Consumed(const uint32_t status)
+    {
+        lock_guard<mutex> lock(_lock);
+        _status = status;
+        _produced = false;
+        _signal.notify_all();
+    }
+    void Stop()
+    {
+        lock_guard<mutex> lock(_lock);
+        _stop = true;
+        _signal.notify_all();
+    }
+
+    // Client side
+    void Write(const uint32_t length, const uint8_t ivLength)
+    {
+        _written = length;
+        _ivLength = ivLength;
+    }
+    uint32_t Request()
+    {
+        unique_lock<mutex> lock(_lock);
+        _produced = true;
+        _signal.notify_all();
+        _signal.wait(lock, [this]() { return (_produced == false); });
+        return (_status);
+    }
+
+private:
+    std::vector<uint8_t> _data;
+    uint32_t _written;
+    uint8_t _iv[DecryptBatch::MaxIVLength];
+    uint8_t _ivLength;
+    uint32_t _status;
+    bool _produced;
+    bool _stop;
+    mutex _lock;
+    condition_variable _signal;
+};
+
+static uint64_t Now()
+{
+    return (chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now().time_since_epoch()).count());
+}
+
+// Lays out count samples as a DecryptBatch in the data area, returns its size.
+static uint32_t Batch(uint8_t buffer[], const uint32_t count, const uint32_t size, const uint32_t subSamples)
+{
+    const uint32_t maps = DecryptBatch::Size(count);
+    const uint32_t data = maps + (count * subSamples * 2 * sizeof(uint32_t));
+
+    DecryptBatch::Header header;
+    ::memcpy(header.magic, DecryptBatch::Magic, sizeof(header.magic));
+    header.version = DecryptBatch::Version;
+    header.count = count;
+    ::memcpy(buffer, &header, sizeof(header));
+
+    for (uint32_t index = 0; index < count; index++) {
+        DecryptBatch::Sample sample;
+        ::memset(&sample, 0, sizeof(sample));
+
+        sample.offset = data + (index * size);
+        sample.length = size;
+        sample.subSampleOffset = maps + (index * subSamples * 2 * sizeof(uint32_t));
+        sample.subSamples = subSamples;
+        sample.ivLength = 8;
+        ::memset(sample.iv, index & 0xFF, sample.ivLength);
+
+        // Clear headers, the rest encrypted
+        for (uint32_t entry = 0; entry < subSamples; entry++) {
+            const uint32_t part = size / subSamples;
+            const uint32_t map[2] = { std::min<uint32_t>(16, part), part - std::min<uint32_t>(16, part) };
+            ::memcpy(&(buffer[sample.subSampleOffset + (entry * sizeof(map))]), map, sizeof(map));
+        }
+
+        ::memcpy(&(buffer[DecryptBatch::Size(index)]), &sample, sizeof(sample));
+    }
+
+    return (data + (count * size));
+}
+
+static void Report(const char name[], vector<uint32_t>& requests, const uint32_t samples, const uint32_t size, const double seconds)
+{
+    sort(requests.begin(), requests.end());
+
+    printf("%-7s %7zu requests  %9.0f samples/s  %8.1f MB/s  request p50 %6u us  p99 %6u us\n", name, requests.size(),
+        samples / seconds, (static_cast<double>(samples) * size) / (seconds * 1024 * 1024),
+        requests[requests.size() / 2], requests[(requests.size() * 99) / 100]);
+}
+
+static bool Run(const char name[], const uint32_t samples, const uint32_t size, const uint32_t perRequest, const uint32_t subSamples)
+{
+    StubSession session;
+    Exchange exchange(DecryptBatch::Size(perRequest) + (perRequest * (size + (subSamples * 2 * sizeof(uint32_t)))));
+    DecryptWorker<Exchange> decryptor(&session);
+
+    thread worker([&]() {
+        while (exchange.RequestConsume() == true) {
+            exchange.Consumed(decryptor.Decrypt(exchange));
+        }
+    });
+
+    vector<uint32_t> requests;
+    uint32_t failed = 0;
+    uint32_t done = 0;
+
+    requests.reserve((samples / perRequest) + 1);
+
+    const uint64_t start = Now();
+
+    while (done < samples) {
+        const uint32_t count = std::min(perRequest, samples - done);
+        const uint64_t begin = Now();
+
+        // A single sample is the plain data with the IV in the exchange, as the client library sends it
+        if (perRequest == 1) {
+            exchange.Write(size, 8);
+        } else {
+            exchange.Write(Batch(exchange.Buffer(), count, size, subSamples), 0);
+        }
+
+        if (exchange.Request() != 0) {
+            failed++;
+        }
+
+        requests.push_back(static_cast<uint32_t>(Now() - begin));
+        done += count;
+    }
+
+    const double seconds = (Now() - start) / 1000000.0;
+
+    exchange.Stop();
+    worker.join();
+
+    Report(name, requests, samples, size, seconds);
+
+    if ((failed != 0) || (session.Decrypts() != samples)) {
+        printf("%s: %u failed requests, %u of %u samples decrypted\n", name, failed, session.Decrypts(), samples);
+    }
+
+    return ((failed == 0) && (session.Decrypts() == samples));
+}
+
+int main(int argc, char** argv)
+{
+    const uint32_t samples = (argc > 1 ? max(1, atoi(argv[1])) : 20000);
+    const uint32_t size = (argc > 2 ? max(32, atoi(argv[2])) : 16384);
+    const uint32_t perBatch = (argc > 3 ? max(2, atoi(argv[3])) : 8);
+    const uint32_t subSamples = (argc > 4 ? max(1, atoi(argv[4])) : 2);
+
+    printf("%u samples of %u bytes, batches of %u samples with %u subsamples each\n", samples, size, perBatch, subSamples);
+
+    bool result = Run("single", samples, size, 1, subSamples);
+    result = Run("batch", samples, size, perBatch, subSamples) && result;
+
+    Core::Singleton::Dispose();
+
+    return (result == true ? 0 : 1);
+}
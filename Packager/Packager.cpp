@@ -156,11 +156,16 @@ namespace {
         params["status"] = std::to_string( status );
         params["code"]   = std::to_string( code );
 
+        if(status == Exchange::IPackager::DOWNLOADING && code > 0)
+        {
+            params["progress"] = std::to_string( code ); // percent
+        }
+
         std::string str("empty");
 
         switch(status)
         {
-            case Exchange::IPackager::DOWNLOADING:         str = "onDownloadCommence";    break;
+            case Exchange::IPackager::DOWNLOADING:         str = (code > 0) ? "onDownloadProgress" : "onDownloadCommence"; break;
             case Exchange::IPackager::DOWNLOADED:          str = "onDownloadComplete";    break;
             case Exchange::IPackager::VERIFYING:           str = "onExtractCommence";     break;
             case Exchange::IPackager::VERIFIED:            str = "onExtractComplete";     break;
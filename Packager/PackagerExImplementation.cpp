@@ -50,6 +50,8 @@
 
 #define TEMPFILE_PATTERN  "/opt/tmpApp%08d.%s"
 
+#define INSTALL_ABORTED   88   // shut down half way, the checkpoint is kept for the next start
+
 #define MB_in_BYTES  1000000
 
 const uint64_t WPEFramework::Plugin::PackagerImplementation::STORE_BYTES_QUOTA = 10 * MB_in_BYTES;
@@ -80,9 +82,7 @@ namespace Plugin {
 
     if(success)
     {
-#ifdef USE_THREAD_POOL
-      PackagerExUtils::setupThreadQ(this); // start thread Q
-#endif
+      // NOTE: The thread Q is started from Configure(), it is sized by the config.
 
 //JUNK JUNK JUNK JUNK JUNK JUNK JUNK JUNK JUNK JUNK JUNK JUNK
 //JUNK JUNK JUNK JUNK JUNK JUNK JUNK JUNK JUNK JUNK JUNK JUNK
@@ -163,9 +163,16 @@ LOGINFO("########## NOW ? hasPkgRow('TestApp0123456') == %s\n",
       return 9; // FAIL  //PackagerExUtils::DACrc_t::dac_FAIL;
     }
 
-    Core::InterlockedIncrement(_taskNumber);
+    if(PackagerExUtils::claimPkg(pkgId) == false)
+    {
+      LOGERR(" - %s ... ALREADY being installed", pkgId.c_str());
+
+      return 10; // FAIL
+    }
+
+    uint32_t taskId = Core::InterlockedIncrement(_taskNumber);
 
-    JobMeta_t job( _taskNumber, pkgId, type, url, token, listener);
+    JobMeta_t job( taskId, pkgId, type, url, token, listener);
 
     auto func = [this, job]
     {
@@ -182,17 +189,39 @@ LOGINFO("########## NOW ? hasPkgRow('TestApp0123456') == %s\n",
    threadObj.detach();
 #endif
 
-    return _taskNumber;
+    return taskId;
+  }
+
+  // Installs that did not complete before the last shut down
+  void PackagerImplementation::ResumeInstalls()
+  {
+    std::vector<JobMeta_t> jobs = PackagerExUtils::loadCheckpoints();
+
+    for(const JobMeta_t& job : jobs)
+    {
+      LOGINFO(" ... RESUME >>>  %s", job.pkgId.c_str());
+
+      Install(job.pkgId, job.type, job.url, job.token, job.listener);
+    }
   }
 
   uint32_t PackagerImplementation::doInstall(const JobMeta_t &job)
   {
-    return doInstall(job.taskId,
-                     job.pkgId,
-                     job.type,
-                     job.url,
-                     job.token,
-                     job.listener);
+    uint32_t rc = doInstall(job.taskId,
+                            job.pkgId,
+                            job.type,
+                            job.url,
+                            job.token,
+                            job.listener);
+
+    if(rc != INSTALL_ABORTED)
+    {
+      PackagerExUtils::dropCheckpoint(job); // done, one way or the other
+    }
+
+    PackagerExUtils::releasePkg(job.pkgId);
+
+    return rc;
   }
 
   uint32_t PackagerImplementation::doInstall(
@@ -216,6 +245,7 @@ LOGINFO("########## NOW ? hasPkgRow('TestApp0123456') == %s\n",
     std::string install_url  = url;      // Default: No JSON manifest - just a .tgz
     std::string install_name = pkgId;    // dummy defaults
     std::string install_ver  = "1.2.3";  // dummy defaults
+    std::string install_sha  = "";       // optional, verified on the fly
 
 //    NotifyInstallStep(INSTALL_START);
 
@@ -234,7 +264,9 @@ LOGINFO("########## NOW ? hasPkgRow('TestApp0123456') == %s\n",
 
         // Download JSON manifest...
         //
-        if(PackagerExUtils::downloadJSON(install_url.c_str(), download_name) != PackagerExUtils::DACrc_t::dac_OK)
+        JsonObject cfg;
+
+        if(PackagerExUtils::downloadJSON(install_url.c_str(), download_name, cfg) != PackagerExUtils::DACrc_t::dac_OK)
         {
             LOGERR(" ... ERROR:  Failed to download JSON >> %s \n", install_url.c_str());
 
@@ -246,13 +278,15 @@ LOGINFO("########## NOW ? hasPkgRow('TestApp0123456') == %s\n",
         PackagerExUtils::fileRemove(download_name); // Cleanup JSON
 
         // Parse JSON for meta...
-        install_url  = PackagerExUtils::mPackageCfg["install"].String(); // update install from URL
-        install_name = PackagerExUtils::mPackageCfg["name"].String();
-        install_ver  = PackagerExUtils::mPackageCfg["version"].String();
+        install_url  = cfg["install"].String(); // update install from URL
+        install_name = cfg["name"].String();
+        install_ver  = cfg["version"].String();
+        install_sha  = cfg["sha256"].String();
 
-        // Update download temp name...
-        std::string ext = PackagerExUtils::fileExtension(install_url);
-        snprintf(download_name, PATH_MAX, TEMPFILE_PATTERN, taskId, ext.c_str() );
+        if(install_sha == "null")
+        {
+            install_sha.clear(); // no checksum in manifest
+        }
 
         // Check NOT empty/exist
         if(install_url.empty()  || install_url  == "null" ||
@@ -288,92 +322,129 @@ LOGINFO("########## NOW ? hasPkgRow('TestApp0123456') == %s\n",
     NotifyInstallStep(Exchange::IPackager::DOWNLOADING, taskId, pkgId);
 JUNK_SLEEP_MS(200);
 
-    // Download TGZ package...
+    // Get UUID ...
+    std::string uuid_str = PackagerExUtils::getGUID();
+
+    // Create path ... APPS_ROOT_PATH / {UUID} / {app}
+    snprintf(uuid_path, PATH_MAX, "%s/%s/", APPS_ROOT_PATH, uuid_str.c_str());
+
+    // DOWNLOAD + VERIFY + EXTRACT
+    //
+    // The package is streamed from the network straight into the bundle folder,
+    // hashed on the way. No temporary copy, the size is counted while extracting.
     //
     LOGINFO(" ... DOWNLOAD >>>  %s\n", install_url.c_str());
 
-    if(PackagerExUtils::downloadURL(install_url.c_str(), download_name) != PackagerExUtils::DACrc_t::dac_OK)
-    {
-      NotifyInstallStep(Exchange::IPackager::DOWNLOAD_FAILED, 0, pkgId, -5);
-JUNK_SLEEP_MS(200);
+    const JobMeta_t job(taskId, pkgId, type, url, token, listener);
 
-      LOGERR(" ... DOWNLOAD (%s)>>>  FAILED\n", install_url.c_str());
-      return 55; // FAIL
-    }
-    else
+    // Written once, an interrupted install is started over on the next start
+    PackagerExUtils::saveCheckpoint(job, uuid_path);
+
+    // Progress ... an event per percent, or per MB if the size is unknown
+    //
+    uint64_t     lastStep = 0;
+
+    auto progress = [this, &job, &lastStep](uint64_t received, uint64_t total)
     {
-        NotifyInstallStep(Exchange::IPackager::DOWNLOADED, taskId, pkgId);
- JUNK_SLEEP_MS(200);
+        uint64_t step = (total > 0) ? ((received * 100) / total) : (received / MB_in_BYTES);
 
-        NotifyInstallStep(Exchange::IPackager::VERIFYING, taskId, pkgId);  // aka "onExtractCommence"
-JUNK_SLEEP_MS(200);
+        if(step != lastStep)
+        {
+            lastStep = step;
+
+            if(total > 0)
+            {
+                PackagerExUtils::setProgress(job.taskId, static_cast<uint32_t>(step));
+
+                NotifyInstallStep(Exchange::IPackager::DOWNLOADING, job.taskId, job.pkgId, static_cast<int32_t>(step));
+            }
+        }
+    };
 
-        // Get UUID ...
-        std::string uuid_str = PackagerExUtils::getGUID();
+    uint64_t    bytes = 0;
+    std::string digest;
 
-        // Create path ... APPS_ROOT_PATH / {UUID} / {app}
-        snprintf(uuid_path, PATH_MAX, "%s/%s/", APPS_ROOT_PATH, uuid_str.c_str());
+    PackagerExUtils::InstallRc_t rc = PackagerExUtils::installURL(install_url.c_str(), uuid_path, install_sha, bytes, digest, progress);
 
-        // EXTRACT
-        //
-        if(PackagerExUtils::extractPKG(download_name, uuid_path) != PackagerExUtils::DACrc_t::dac_OK)
+    if(rc == PackagerExUtils::InstallRc_t::install_ABORTED)
+    {
+        LOGWARN(" ... DOWNLOAD (%s)>>>  ABORTED, resumed on next start\n", install_url.c_str());
+        return INSTALL_ABORTED;
+    }
+
+    if(rc != PackagerExUtils::InstallRc_t::install_OK)
+    {
+        PackagerExUtils::removeFolder(uuid_path);   // Remove debris
+
+        if(rc == PackagerExUtils::InstallRc_t::install_DOWNLOAD_FAIL)
         {
-          // Clean up failed extraction
-          //
-          LOGERR(" ... EXTRACT >>>  FAILED\n");
+            LOGERR(" ... DOWNLOAD (%s)>>>  FAILED\n", install_url.c_str());
 
-          NotifyInstallStep(Exchange::IPackager::EXTRACTION_FAILED, taskId, pkgId, -1);
+            NotifyInstallStep(Exchange::IPackager::DOWNLOAD_FAILED, 0, pkgId, -5);
+            return 55; // FAIL
+        }
+        else if(rc == PackagerExUtils::InstallRc_t::install_VERIFY_FAIL)
+        {
+            LOGERR(" ... VERIFY (%s)>>>  FAILED\n", install_url.c_str());
 
-          PackagerExUtils::fileRemove(download_name); // Always cleanup
-          PackagerExUtils::removeFolder(uuid_path);   // Remove debris
+            NotifyInstallStep(Exchange::IPackager::VERIFICATION_FAILED, taskId, pkgId, -1);
+            return 77; // FAIL
+        }
+        else
+        {
+            LOGERR(" ... EXTRACT >>>  FAILED\n");
 
-          return 66; // FAIL
+            NotifyInstallStep(Exchange::IPackager::EXTRACTION_FAILED, taskId, pkgId, -1);
+            return 66; // FAIL
         }
+    }
 
-        NotifyInstallStep(Exchange::IPackager::VERIFIED, taskId, pkgId);
+    NotifyInstallStep(Exchange::IPackager::DOWNLOADED, taskId, pkgId);
 JUNK_SLEEP_MS(200);
 
-        // TODO: look for JSON meta in app bundle...
-        //
-        LOGINFO(" ... INSTALLED >>> [ %s ]\n", install_name.c_str());
-
-        NotifyInstallStep(Exchange::IPackager::INSTALLING, taskId, pkgId);
+    NotifyInstallStep(Exchange::IPackager::VERIFYING, taskId, pkgId);  // aka "onExtractCommence"
 JUNK_SLEEP_MS(200);
 
-        // INSTALL
-        //
-        PackagerExUtils::fileRemove(download_name); // Always cleanup
+    LOGINFO(" ... sha256: %s %s\n", digest.c_str(), install_sha.empty() ? "(not checked)" : "(verified)");
 
-        NotifyInstallStep(Exchange::IPackager::INSTALLING, taskId, pkgId);
+    NotifyInstallStep(Exchange::IPackager::VERIFIED, taskId, pkgId);
 JUNK_SLEEP_MS(200);
 
-        time_t rawtime;
-        time(&rawtime);
-        std::string strtime = ctime(&rawtime); 
+    // TODO: look for JSON meta in app bundle...
+    //
+    LOGINFO(" ... INSTALLED >>> [ %s ]\n", install_name.c_str());
 
-        strtime.pop_back();  // NOTE:  Remove trailing '\n' >> illegal in JSON
+    NotifyInstallStep(Exchange::IPackager::INSTALLING, taskId, pkgId);
+JUNK_SLEEP_MS(200);
 
-        uint64_t bytes = PackagerExUtils::folderSize(uuid_path);
+    // INSTALL
+    //
+    time_t rawtime;
+    time(&rawtime);
+    std::string strtime = ctime(&rawtime);
 
-        PackageInfoEx* pkg = Core::Service<PackageInfoEx>::Create<PackageInfoEx>();
+    strtime.pop_back();  // NOTE:  Remove trailing '\n' >> illegal in JSON
 
-        pkg->setPkgId(pkgId);
-        pkg->setName(install_name);
-        pkg->setBundlePath(uuid_path);
-        pkg->setVersion(install_ver);
-        pkg->setInstalled( strtime );
-        pkg->setSizeInBytes(bytes);
-        pkg->setType(type);
+    PackageInfoEx* pkg = Core::Service<PackageInfoEx>::Create<PackageInfoEx>();
 
-        PackagerExUtils::addPkgRow(pkg); // add to SQL
+    pkg->setPkgId(pkgId);
+    pkg->setName(install_name);
+    pkg->setBundlePath(uuid_path);
+    pkg->setVersion(install_ver);
+    pkg->setInstalled( strtime );
+    pkg->setSizeInBytes(bytes);
+    pkg->setType(type);
 
-        pkg->Release();
+    PackagerExUtils::addPkgRow(pkg); // add to SQL
+
+    pkg->Release();
 
 JUNK_SLEEP_MS(200);
 
-        NotifyInstallStep(Exchange::IPackager::INSTALLED, taskId, pkgId);
-        LOGINFO(" ... COMPLETE (%s) --------------------------------------------------------\n\n\n", install_url.c_str());
-    }
+    PackagerExUtils::setProgress(taskId, 100);
+
+    NotifyInstallStep(Exchange::IPackager::INSTALLED, taskId, pkgId);
+    LOGINFO(" ... COMPLETE (%s) --------------------------------------------------------\n\n\n", install_url.c_str());
 
     return 0; // no error
   }
@@ -428,12 +499,9 @@ JUNK_SLEEP_MS(200);
 
   uint32_t PackagerImplementation::GetInstallProgress(const string& task)
   {
-    DDD();
-
-   NotifyInstallStep(Exchange::IPackager::state::IDLE);
+    uint32_t taskId = strtoul(task.c_str(), nullptr, 10);
 
-    // TODO:
-    return 42;
+    return PackagerExUtils::getProgress(taskId); // percent of the download
   }
 
   PackageInfoEx::IIterator* PackagerImplementation::GetInstalled()
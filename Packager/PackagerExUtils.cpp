@@ -36,19 +36,28 @@
 #include <fstream>
 #include <streambuf>
 #include <regex>
+#include <vector>
+#include <algorithm>
+#include <chrono>
+#include <thread>
 
 #include <inttypes.h>
 #include <dirent.h>
 #include <sys/stat.h>
+#include <fcntl.h>
 
 #include <iostream>
 #include <cstring>
+#include <cctype>
+#include <strings.h>
 #include <cstdlib>
 
 #include "PackagerExUtils.h"
 
 #include "PackagerExImplementation.h"
 
+#include "cryptalgo/Hash.h"
+
 
 #ifndef SQLITE_FILE_HEADER
 #define SQLITE_FILE_HEADER "SQLite format 3"
@@ -67,7 +76,6 @@ static PackageInfoEx* row2pkg(sqlite3_stmt *stmt); // private fwd
 //
 const uint64_t                        PackagerExUtils::MAX_SIZE_BYTES       = 1000000;
 const uint64_t                        PackagerExUtils::MAX_VALUE_SIZE_BYTES = 1000;
-JsonObject                            PackagerExUtils::mPackageCfg;
 
 // std::list<PackageInfoEx *>           PackagerExUtils::mPackages;
 //std::list<PackageInfoEx *>::iterator PackagerExUtils::mPkgIter;
@@ -75,6 +83,15 @@ JsonObject                            PackagerExUtils::mPackageCfg;
 std::vector<std::thread>             PackagerExUtils::mThreadPool; // thread pool
 WPEFramework::Plugin::JobPool        PackagerExUtils::mJobPool;
 Core::CriticalSection                PackagerExUtils::mThreadLock;
+std::set<string>                     PackagerExUtils::mPkgsInFlight;
+std::map<uint32_t, uint32_t>         PackagerExUtils::mProgress;
+
+// Downloads
+//
+static std::atomic<bool>                      sAbort(false);     // set on shutdown, checkpoints are kept
+static std::mutex                             sBandwidthLock;
+static uint64_t                               sBandwidth = 0;    // bytes per second, 0 is unlimited
+static std::chrono::steady_clock::time_point  sBandwidthNext;    // when the bytes granted so far are paid for
 
 void*                                PackagerExUtils::mData = nullptr;
 
@@ -977,7 +994,7 @@ success = true;
     //
     // ARCHIVE CODE
     static int
-    copy_data(struct archive *ar, struct archive *aw)
+    copy_data(struct archive *ar, struct archive *aw, uint64_t *written)
     {
       int r;
       const void *buff;
@@ -1006,18 +1023,44 @@ success = true;
           //     archive_error_string(aw));
           return (r);
         }
+        *written += size;
       }
     }
 
-    PackagerExUtils::DACrc_t PackagerExUtils::extractPKG(const char *filename, const char *to_path /* = nullptr */)
+    // An archive entry name is only accepted when it stays below the extraction directory.
+    static bool is_contained_path(const char *name)
+    {
+      if (name == nullptr || name[0] == '/')
+      {
+        return false;
+      }
+
+      for (const char *p = name; *p != '\0'; )
+      {
+        const char *end = strchr(p, '/');
+        size_t      len = (end != nullptr) ? (size_t) (end - p) : strlen(p);
+
+        if (len == 2 && p[0] == '.' && p[1] == '.')
+        {
+          return false;
+        }
+
+        p += len;
+        while (*p == '/') p++;
+      }
+
+      return true;
+    }
+
+    // Extract all entries of an opened archive below 'to_path', counting the bytes written.
+    static PackagerExUtils::DACrc_t extract_all(struct archive *a, const char *to_path, uint64_t &bytes)
     {
-      struct archive *a;
       struct archive *ext;
       struct archive_entry *entry;
       int flags;
       int r;
 
-LOGINFO(" ... Extracting >>>  '%s' ", filename);
+      PackagerExUtils::DACrc_t rc = PackagerExUtils::DACrc_t::dac_OK;
 
       // Select which attributes we want to restore.
       flags =  ARCHIVE_EXTRACT_TIME;
@@ -1025,21 +1068,37 @@ LOGINFO(" ... Extracting >>>  '%s' ", filename);
       flags |= ARCHIVE_EXTRACT_ACL;
       flags |= ARCHIVE_EXTRACT_FFLAGS;
 
-      a = archive_read_new();
-      archive_read_support_format_all(a);
-    //   archive_read_support_compression_all(a); // DEPRECATED ?
-      archive_read_support_filter_all(a);
+      // Packages are written to disk before their digest is checked, so nothing may land outside 'to_path'.
+      // Prefixing 'to_path' makes every name absolute, hence absolute entry names are refused below instead
+      // of by ARCHIVE_EXTRACT_SECURE_NOABSOLUTEPATHS.
+      flags |= ARCHIVE_EXTRACT_SECURE_NODOTDOT;
+      flags |= ARCHIVE_EXTRACT_SECURE_SYMLINKS;
+
+      if (to_path == nullptr)
+      {
+        flags |= ARCHIVE_EXTRACT_SECURE_NOABSOLUTEPATHS;
+      }
+
+      // Symlinks in the prefix itself are trusted, only the ones created from the archive are not
+      char resolved[PATH_MAX];
+      std::string targetPath;
+
+      if (to_path != nullptr)
+      {
+        targetPath = (realpath(to_path, resolved) != nullptr) ? resolved : to_path;
+
+        if (targetPath.empty() || targetPath.back() != '/')
+        {
+          targetPath += '/';
+        }
+      }
 
       ext = archive_write_disk_new();
 
       archive_write_disk_set_options(ext, flags);
       archive_write_disk_set_standard_lookup(ext);
 
-      if ((r = archive_read_open_filename(a, filename, 10240)))
-      {
-        LOGERR("  >>>  FATAL - '%s' NOT found.", filename);
-        return DACrc_t::dac_FAIL;
-      }
+      bytes = 0;
 
       int read_count = 0;
       for (;;)
@@ -1052,7 +1111,7 @@ LOGINFO(" ... Extracting >>>  '%s' ", filename);
           if(read_count == 0)
           {
             LOGERR(" .. Next Header ... Empty / Bad file > ARCHIVE_EOF\n");
-            return DACrc_t::dac_FAIL;
+            rc = PackagerExUtils::DACrc_t::dac_FAIL;
           }
 
           break; // complete
@@ -1065,16 +1124,35 @@ LOGINFO(" ... Extracting >>>  '%s' ", filename);
         if (r < ARCHIVE_WARN)
         {
             LOGERR(" .. Next Header ... Unexpected > ARCHIVE_WARN\n");
-            return DACrc_t::dac_FAIL;
+            rc = PackagerExUtils::DACrc_t::dac_FAIL;
+            break;
         }
 
         if(to_path != nullptr)
         {
-            std::string targetFilepath(to_path);// = "/opt/";
-            targetFilepath += archive_entry_pathname(entry);
+            const char *name = archive_entry_pathname(entry);
+            const char *link = archive_entry_hardlink(entry);
+
+            if (!is_contained_path(name) || (link != nullptr && !is_contained_path(link)))
+            {
+              LOGERR(" .. Entry '%s' escapes '%s' ... refused", (name != nullptr) ? name : "", to_path);
+              rc = PackagerExUtils::DACrc_t::dac_FAIL;
+              break;
+            }
+
+            std::string targetFilepath(targetPath);// = "/opt/";
+            targetFilepath += name;
 
             archive_entry_set_pathname(entry, targetFilepath.c_str());
 
+            if (link != nullptr)
+            {
+              std::string targetLinkpath(targetPath);
+              targetLinkpath += link;
+
+              archive_entry_set_hardlink(entry, targetLinkpath.c_str());
+            }
+
 //          LOGINFO(" EXTRACT >>>  entry: %s", targetFilepath.c_str());
         }
 
@@ -1085,9 +1163,16 @@ LOGINFO(" ... Extracting >>>  '%s' ", filename);
         {
           LOGERR("%s", archive_error_string(ext));
         }
+
+        if (r < ARCHIVE_WARN)
+        {
+          LOGERR(" .. Write Header ... Unexpected > ARCHIVE_WARN");
+          rc = PackagerExUtils::DACrc_t::dac_FAIL;
+          break;
+        }
         else if (archive_entry_size(entry) > 0)
         {
-          r = copy_data(a, ext);
+          r = copy_data(a, ext, &bytes);
           if (r < ARCHIVE_OK)
           {
             LOGERR("%s", archive_error_string(ext));
@@ -1096,7 +1181,8 @@ LOGINFO(" ... Extracting >>>  '%s' ", filename);
           if (r < ARCHIVE_WARN)
           {
             LOGERR(" ... Entry Size ... Unexpected > ARCHIVE_WARN");
-            return DACrc_t::dac_FAIL;
+            rc = PackagerExUtils::DACrc_t::dac_FAIL;
+            break;
           }
         }
 
@@ -1108,16 +1194,409 @@ LOGINFO(" ... Extracting >>>  '%s' ", filename);
         if (r < ARCHIVE_WARN)
         {
           LOGERR("  ...  Write Finish ... Unexpected > ARCHIVE_WARN");
-          return DACrc_t::dac_FAIL;
+          rc = PackagerExUtils::DACrc_t::dac_FAIL;
+          break;
         }
       }
 
-      archive_read_close(a);
-      archive_read_free(a);
       archive_write_close(ext);
       archive_write_free(ext);
 
-      return DACrc_t::dac_OK; // success
+      return rc;
+    }
+
+    PackagerExUtils::DACrc_t PackagerExUtils::extractPKG(const char *filename, const char *to_path /* = nullptr */)
+    {
+      struct archive *a;
+      uint64_t bytes = 0;
+
+LOGINFO(" ... Extracting >>>  '%s' ", filename);
+
+      a = archive_read_new();
+      archive_read_support_format_all(a);
+    //   archive_read_support_compression_all(a); // DEPRECATED ?
+      archive_read_support_filter_all(a);
+
+      if (archive_read_open_filename(a, filename, 10240))
+      {
+        LOGERR("  >>>  FATAL - '%s' NOT found.", filename);
+        archive_read_free(a);
+        return DACrc_t::dac_FAIL;
+      }
+
+      DACrc_t rc = extract_all(a, to_path, bytes);
+
+      archive_read_close(a);
+      archive_read_free(a);
+
+      return rc;
+    }
+
+    // Memory pipe between the curl write callback and the libarchive read callback.
+    // libarchive pulls its input, so the transfer is driven from the read callback
+    // through the curl multi interface. The transfer is paused while a block is
+    // waiting for libarchive, so at most STREAM_BLOCK_SIZE is held in memory
+    // (file:// can not be paused, local files are taken in one go).
+    #define STREAM_BLOCK_SIZE (256 * 1024)
+    #define STREAM_RETRIES    5
+
+    struct StreamPipe
+    {
+        StreamPipe() : multi(nullptr), curl(nullptr), received(0), total(0), retries(0), running(true),
+                       pausable(true), paused(false), connected(false), rangeRefused(false), result(CURLE_OK) {}
+
+        CURLM*            multi;
+        CURL*             curl;
+        std::vector<char> pending;   // filled by curl
+        std::vector<char> current;   // handed to libarchive
+        Crypto::SHA256    digest;
+        uint64_t          received;
+        uint64_t          total;     // 0 if unknown
+        uint32_t          retries;
+        bool              running;
+        bool              pausable;
+        bool              paused;
+        bool              connected; // first data of the current connection seen
+        bool              rangeRefused;
+        CURLcode          result;
+        ProgressFunc_t    progress;
+    };
+
+    // All downloads share one budget: every block moves the shared clock on by
+    // its transfer time at the configured rate, the caller sleeps until then.
+    static void throttle(uint64_t bytes)
+    {
+        std::chrono::steady_clock::time_point until;
+
+        {
+            std::lock_guard<std::mutex> lock(sBandwidthLock);
+
+            if (sBandwidth == 0 || bytes == 0)
+            {
+                return;
+            }
+
+            std::chrono::steady_clock::time_point now = std::chrono::steady_clock::now();
+
+            if (sBandwidthNext < now)
+            {
+                sBandwidthNext = now; // no credit for idle time, no bursts
+            }
+
+            sBandwidthNext += std::chrono::microseconds((bytes * 1000000) / sBandwidth);
+            until = sBandwidthNext;
+        }
+
+        std::this_thread::sleep_until(until);
+    }
+
+    void PackagerExUtils::setBandwidth(uint64_t bytesPerSecond)
+    {
+        std::lock_guard<std::mutex> lock(sBandwidthLock);
+
+        sBandwidth = bytesPerSecond;
+
+        LOGINFO(" ... Bandwidth: %" PRIu64 " bytes/s %s", sBandwidth, (sBandwidth ? "" : "(unlimited)"));
+    }
+
+    static size_t stream_write(void *ptr, size_t size, size_t nmemb, void *userdata)
+    {
+        StreamPipe *pipe = static_cast<StreamPipe *>(userdata);
+        const uint8_t *data = static_cast<const uint8_t *>(ptr);
+        size_t length = size * nmemb;
+
+        if (pipe->connected == false)
+        {
+            pipe->connected = true;
+
+            long code = 0;
+            curl_easy_getinfo(pipe->curl, CURLINFO_RESPONSE_CODE, &code);
+
+            if (pipe->received > 0 && code != 206)
+            {
+                // Server sent the whole package again, what is extracted already can not be undone
+                LOGERR("... resume: server ignored the range request (HTTP %ld)", code);
+                pipe->rangeRefused = true;
+                return 0;
+            }
+
+            curl_off_t remaining = -1;
+            curl_easy_getinfo(pipe->curl, CURLINFO_CONTENT_LENGTH_DOWNLOAD_T, &remaining);
+
+            pipe->total = (remaining > 0) ? (pipe->received + remaining) : 0;
+        }
+
+        if (pipe->pausable && !pipe->pending.empty() && (pipe->pending.size() + length) > STREAM_BLOCK_SIZE)
+        {
+            // Offered again once libarchive took the pending block
+            pipe->paused = true;
+            return CURL_WRITEFUNC_PAUSE;
+        }
+
+        pipe->pending.insert(pipe->pending.end(), data, data + length);
+        pipe->received += length;
+
+        // Hash on the fly, the input takes at most 64K at a time
+        for (size_t done = 0; done < length; )
+        {
+            uint16_t chunk = static_cast<uint16_t>(std::min<size_t>(length - done, 0xFFFF));
+            pipe->digest.Input(&data[done], chunk);
+            done += chunk;
+        }
+
+        if (pipe->progress)
+        {
+            pipe->progress(pipe->received, pipe->total);
+        }
+
+        return length;
+    }
+
+    static bool stream_retryable(const StreamPipe *pipe)
+    {
+        if (pipe->rangeRefused || sAbort || pipe->retries >= STREAM_RETRIES)
+        {
+            return false;
+        }
+
+        switch (pipe->result)
+        {
+            case CURLE_COULDNT_RESOLVE_HOST:
+            case CURLE_COULDNT_CONNECT:
+            case CURLE_PARTIAL_FILE:
+            case CURLE_OPERATION_TIMEDOUT:
+            case CURLE_GOT_NOTHING:
+            case CURLE_SEND_ERROR:
+            case CURLE_RECV_ERROR:
+                return true;
+
+            default:
+                return false; // HTTP errors and the like, trying again will not help
+        }
+    }
+
+    // Pick up a dropped connection where it left off.
+    static void stream_resume(StreamPipe *pipe)
+    {
+        pipe->retries++;
+
+        LOGWARN("... resume: %s, retry %u at %" PRIu64 " bytes", curl_easy_strerror(pipe->result), pipe->retries, pipe->received);
+
+        std::this_thread::sleep_for(std::chrono::seconds(1 << (pipe->retries - 1)));
+
+        curl_multi_remove_handle(pipe->multi, pipe->curl);
+        curl_easy_setopt(pipe->curl, CURLOPT_RESUME_FROM_LARGE, static_cast<curl_off_t>(pipe->received));
+        curl_multi_add_handle(pipe->multi, pipe->curl);
+
+        pipe->connected = false;
+        pipe->paused    = false;
+        pipe->running   = true;
+        pipe->result    = CURLE_OK;
+    }
+
+    // One step of the transfer, returns false on a transport error.
+    static bool stream_pump(StreamPipe *pipe)
+    {
+        int running = 0;
+
+        if (sAbort)
+        {
+            pipe->result  = CURLE_ABORTED_BY_CALLBACK;
+            pipe->running = false;
+            return false;
+        }
+
+        if (pipe->paused)
+        {
+            // May deliver the held back data right away
+            pipe->paused = false;
+            curl_easy_pause(pipe->curl, CURLPAUSE_CONT);
+        }
+
+        uint64_t before = pipe->received;
+
+        if (curl_multi_perform(pipe->multi, &running) != CURLM_OK)
+        {
+            pipe->result  = CURLE_FAILED_INIT;
+            pipe->running = false;
+            return false;
+        }
+
+        throttle(pipe->received - before);
+
+        if (running == 0)
+        {
+            CURLMsg *msg;
+            int      left;
+
+            while ((msg = curl_multi_info_read(pipe->multi, &left)) != nullptr)
+            {
+                if (msg->msg == CURLMSG_DONE)
+                {
+                    pipe->result = msg->data.result;
+                }
+            }
+
+            pipe->running = false;
+
+            if (pipe->result != CURLE_OK && stream_retryable(pipe))
+            {
+                stream_resume(pipe);
+            }
+        }
+        else if (pipe->pending.empty() && !pipe->paused)
+        {
+            curl_multi_wait(pipe->multi, nullptr, 0, 1000, nullptr);
+        }
+
+        return (pipe->result == CURLE_OK);
+    }
+
+    static la_ssize_t stream_read(struct archive *a, void *client, const void **buff)
+    {
+        StreamPipe *pipe = static_cast<StreamPipe *>(client);
+
+        pipe->current.clear(); // libarchive is done with the previous block
+
+        while (pipe->pending.empty() && pipe->running)
+        {
+            if (stream_pump(pipe) == false)
+            {
+                archive_set_error(a, EIO, "download failed: %s", curl_easy_strerror(pipe->result));
+                return (-1);
+            }
+        }
+
+        pipe->current.swap(pipe->pending);
+
+        *buff = pipe->current.data();
+
+        return (static_cast<la_ssize_t>(pipe->current.size()));
+    }
+
+    static string toHex(const uint8_t *data, size_t length)
+    {
+        static const char hex[] = "0123456789abcdef";
+        string result;
+
+        for (size_t i = 0; i < length; i++)
+        {
+            result += hex[data[i] >> 4];
+            result += hex[data[i] & 0x0F];
+        }
+
+        return result;
+    }
+
+    PackagerExUtils::InstallRc_t PackagerExUtils::installURL(const char *url, const char *to_path, const string& sha256,
+                                                             uint64_t &installedBytes, string &digest,
+                                                             const ProgressFunc_t& progress /* = nullptr */)
+    {
+      installedBytes = 0;
+      digest.clear();
+
+      if(!url || !to_path)
+      {
+          LOGERR("... ERROR: BAD args ... nullptr");
+          return InstallRc_t::install_DOWNLOAD_FAIL;
+      }
+
+      LOGINFO(" ... Installing >>> '%s' ... to '%s' ", url, to_path);
+
+      StreamPipe pipe;
+
+      pipe.pausable = (strncasecmp(url, "file:", 5) != 0);
+      pipe.progress = progress;
+
+      pipe.curl  = curl_easy_init();
+      pipe.multi = curl_multi_init();
+
+      if(!pipe.curl || !pipe.multi)
+      {
+          LOGERR("... install: '%s' - curl init FAILED", url);
+
+          if(pipe.curl)  curl_easy_cleanup(pipe.curl);
+          if(pipe.multi) curl_multi_cleanup(pipe.multi);
+
+          return InstallRc_t::install_DOWNLOAD_FAIL;
+      }
+
+      curl_easy_setopt(pipe.curl, CURLOPT_URL, url);
+      curl_easy_setopt(pipe.curl, CURLOPT_WRITEFUNCTION, stream_write);
+      curl_easy_setopt(pipe.curl, CURLOPT_WRITEDATA, &pipe);
+      curl_easy_setopt(pipe.curl, CURLOPT_FAILONERROR, true);
+      curl_easy_setopt(pipe.curl, CURLOPT_USERAGENT, "Packager/1.0");
+      curl_easy_setopt(pipe.curl, CURLOPT_CONNECTTIMEOUT, 30L);
+      curl_easy_setopt(pipe.curl, CURLOPT_LOW_SPEED_LIMIT, 1L);    // a stalled connection ...
+      curl_easy_setopt(pipe.curl, CURLOPT_LOW_SPEED_TIME, 60L);    // ... times out and is resumed
+
+      curl_multi_add_handle(pipe.multi, pipe.curl);
+
+      struct archive *a = archive_read_new();
+      archive_read_support_format_all(a);
+      archive_read_support_filter_all(a);
+
+      InstallRc_t rc = InstallRc_t::install_OK;
+
+      if (archive_read_open(a, &pipe, nullptr, stream_read, nullptr) != ARCHIVE_OK)
+      {
+          LOGERR("... install: '%s' - open FAILED: %s", url, archive_error_string(a));
+          rc = (pipe.result != CURLE_OK) ? InstallRc_t::install_DOWNLOAD_FAIL : InstallRc_t::install_EXTRACT_FAIL;
+      }
+      else
+      {
+          if (extract_all(a, to_path, installedBytes) != DACrc_t::dac_OK)
+          {
+              rc = (pipe.result != CURLE_OK) ? InstallRc_t::install_DOWNLOAD_FAIL : InstallRc_t::install_EXTRACT_FAIL;
+          }
+
+          archive_read_close(a);
+      }
+      archive_read_free(a);
+
+      if (sAbort)
+      {
+          rc = InstallRc_t::install_ABORTED;
+      }
+
+      if (rc == InstallRc_t::install_OK)
+      {
+          // The archive can end before the download does (tar padding), the digest covers all of it
+          while (pipe.running)
+          {
+              pipe.pending.clear();
+              stream_pump(&pipe);
+          }
+
+          if (pipe.result == CURLE_ABORTED_BY_CALLBACK)
+          {
+              rc = InstallRc_t::install_ABORTED;
+          }
+          else if (pipe.result != CURLE_OK)
+          {
+              LOGERR("... install: '%s' - download FAILED: %s", url, curl_easy_strerror(pipe.result));
+              rc = InstallRc_t::install_DOWNLOAD_FAIL;
+          }
+          else
+          {
+              digest = toHex(pipe.digest.Result(), Crypto::SHA256::Length);
+
+              if (!sha256.empty() && !iequals(sha256, digest))
+              {
+                  LOGERR("... install: '%s' - sha256 mismatch, expected %s got %s", url, sha256.c_str(), digest.c_str());
+                  rc = InstallRc_t::install_VERIFY_FAIL;
+              }
+          }
+      }
+
+      curl_multi_remove_handle(pipe.multi, pipe.curl);
+      curl_easy_cleanup(pipe.curl);
+      curl_multi_cleanup(pipe.multi);
+
+      LOGINFO("... install: '%s' - %s  received: %" PRIu64 "  installed: %" PRIu64 " bytes", url,
+              (rc == InstallRc_t::install_OK) ? "OK" : "FAILED", pipe.received, installedBytes);
+
+      return rc;
     }
 
     void example_function()
@@ -1126,11 +1605,16 @@ LOGINFO(" ... Extracting >>>  '%s' ", filename);
     }
 
 #ifdef USE_THREAD_POOL
-    void PackagerExUtils::setupThreadQ(PackagerImplementation *ptr)
+    void PackagerExUtils::setupThreadQ(uint32_t threads, const JobFunc_t& handler)
     {
-        int num_threads = max<int>(1, std::thread::hardware_concurrency() / 2); // be nice
+        // Installs mostly wait on the network, be nice but keep a few going
+        int num_threads = (threads > 0) ? threads : max<int>(2, std::thread::hardware_concurrency() / 2);
+
+        LOGINFO(" ... install threads  tt: %d \n", num_threads);
 
-        LOGINFO(" ... hardware_concurrency()  tt: %d \n", num_threads);
+        sAbort = false;
+        mJobPool.setHandler(handler);
+        mJobPool.start(); // stopped by an earlier killThreadQ()
 
         for (int i = 0; i < num_threads; i++)
         {
@@ -1141,6 +1625,8 @@ LOGINFO(" ... Extracting >>>  '%s' ", filename);
 
     void PackagerExUtils::killThreadQ()
     {
+        sAbort = true; // running downloads stop, their checkpoints are kept
+
         PackagerExUtils::mJobPool.done();
 
         // Kill workers
@@ -1149,6 +1635,8 @@ LOGINFO(" ... Extracting >>>  '%s' ", filename);
             LOGINFO(" ... Killing WORKER  i: %d\n", i);
             PackagerExUtils::mThreadPool.at(i).join();
         }
+
+        PackagerExUtils::mThreadPool.clear();
     }
 #endif // USE_THREAD_POOL
 
@@ -1156,11 +1644,177 @@ LOGINFO(" ... Extracting >>>  '%s' ", filename);
     // void PackagerExUtils::addJob( FOO_T &job )
     {
         mJobPool.push( job );
+    }
 
-        // for (int i = 0; i < 10; i++)
-        // {
-        //     LOGINFO(" ... Adding JOB  i: %d \n", i);
-        // }
+    bool PackagerExUtils::claimPkg(const string& pkgId)
+    {
+        mThreadLock.Lock();
+        bool claimed = mPkgsInFlight.insert(pkgId).second;
+        mThreadLock.Unlock();
+
+        return claimed;
+    }
+
+    void PackagerExUtils::releasePkg(const string& pkgId)
+    {
+        mThreadLock.Lock();
+        mPkgsInFlight.erase(pkgId);
+        mThreadLock.Unlock();
+    }
+
+    void PackagerExUtils::setProgress(uint32_t taskId, uint32_t percent)
+    {
+        mThreadLock.Lock();
+        mProgress[taskId] = percent;
+        mThreadLock.Unlock();
+    }
+
+    uint32_t PackagerExUtils::getProgress(uint32_t taskId)
+    {
+        mThreadLock.Lock();
+        std::map<uint32_t, uint32_t>::const_iterator it = mProgress.find(taskId);
+        uint32_t percent = (it != mProgress.end()) ? it->second : 0;
+        mThreadLock.Unlock();
+
+        return percent;
+    }
+
+    // One file per package, the name must be safe for the file system and unique per package:
+    // anything else than [A-Za-z0-9-.] is written as _XX, '_' included
+    static string checkpointName(const string& pkgId)
+    {
+        static const char hex[] = "0123456789abcdef";
+
+        string name(JOBS_ROOT_PATH "/");
+
+        for (char c : pkgId)
+        {
+            unsigned char u = static_cast<unsigned char>(c);
+
+            if (isalnum(u) || c == '-' || c == '.')
+            {
+                name += c;
+            }
+            else
+            {
+                name += '_';
+                name += hex[u >> 4];
+                name += hex[u & 0x0F];
+            }
+        }
+
+        return name + ".json";
+    }
+
+    bool PackagerExUtils::saveCheckpoint(const JobMeta_t& job, const string& bundle)
+    {
+        JsonObject cp;
+
+        cp["pkgId"]    = job.pkgId;
+        cp["type"]     = job.type;
+        cp["url"]      = job.url;
+        // No token: it is a credential, the resumed install goes ahead without it
+        cp["listener"] = job.listener;
+        cp["bundle"]   = bundle;
+
+        string txt;
+        cp.ToString(txt);
+
+        // URLs may carry signed queries, keep the checkpoints to ourselves
+        g_mkdir_with_parents(JOBS_ROOT_PATH, 0700);
+        chmod(JOBS_ROOT_PATH, 0700); // created 0745 by earlier versions
+
+        // Written aside and renamed, a checkpoint is always complete
+        string file = checkpointName(job.pkgId);
+        string temp = file + ".tmp";
+
+        int fd = open(temp.c_str(), O_CREAT | O_WRONLY | O_TRUNC | O_CLOEXEC, 0600);
+        if (fd < 0)
+        {
+            LOGWARN("... checkpoint: cannot create %s", temp.c_str());
+            return false;
+        }
+
+        bool written = (write(fd, txt.data(), txt.size()) == static_cast<ssize_t>(txt.size()));
+
+        if (close(fd) != 0 || !written)
+        {
+            LOGWARN("... checkpoint: cannot write %s", temp.c_str());
+            fileRemove(temp.c_str());
+            return false;
+        }
+
+        if (rename(temp.c_str(), file.c_str()) != 0)
+        {
+            LOGWARN("... checkpoint: cannot rename %s", temp.c_str());
+            fileRemove(temp.c_str());
+            return false;
+        }
+
+        return true;
+    }
+
+    void PackagerExUtils::dropCheckpoint(const JobMeta_t& job)
+    {
+        fileRemove(checkpointName(job.pkgId).c_str());
+    }
+
+    std::vector<JobMeta_t> PackagerExUtils::loadCheckpoints()
+    {
+        std::vector<JobMeta_t> jobs;
+
+        DIR *dir = opendir(JOBS_ROOT_PATH);
+        if (!dir)
+        {
+            return jobs;
+        }
+
+        struct dirent *ent;
+        while ((ent = readdir(dir)) != NULL)
+        {
+            string name(ent->d_name);
+            string file = string(JOBS_ROOT_PATH "/") + name;
+
+            if (fileEndsWith(name, "tmp"))
+            {
+                fileRemove(file.c_str()); // left over from an interrupted write
+                continue;
+            }
+
+            if (!fileEndsWith(name, "json"))
+            {
+                continue;
+            }
+
+            std::ifstream t(file);
+            std::string txt((std::istreambuf_iterator<char>(t)),
+                             std::istreambuf_iterator<char>());
+
+            JsonObject cp(txt);
+
+            JobMeta_t job(0, cp["pkgId"].String(), cp["type"].String(), cp["url"].String(),
+                          "", cp["listener"].String());
+
+            string bundle = cp["bundle"].String();
+
+            LOGINFO(" ... checkpoint: '%s' interrupted", job.pkgId.c_str());
+
+            // The extraction can not be picked up half way, start the package over
+            if (!bundle.empty() && bundle != "null" && bundle.compare(0, strlen(APPS_ROOT_PATH), APPS_ROOT_PATH) == 0)
+            {
+                removeFolder(bundle);
+            }
+
+            fileRemove(file.c_str());
+
+            if (!job.pkgId.empty() && job.pkgId != "null" && !job.url.empty() && job.url != "null")
+            {
+                jobs.push_back(job);
+            }
+        }
+        closedir(dir);
+
+        return jobs;
     }
 
     size_t write_data(void *ptr, size_t size, size_t nmemb, FILE *stream)
@@ -1170,7 +1824,7 @@ LOGINFO(" ... Extracting >>>  '%s' ", filename);
         return written;
     }
 
-    PackagerExUtils::DACrc_t PackagerExUtils::downloadJSON(const char *url, const char *tempName)
+    PackagerExUtils::DACrc_t PackagerExUtils::downloadJSON(const char *url, const char *tempName, JsonObject &cfg)
     {
         // Download JSON manifest...
         //
@@ -1182,7 +1836,7 @@ LOGINFO(" ... Extracting >>>  '%s' ", filename);
                              std::istreambuf_iterator<char>());
 
             // Parse the text to JSON ... and get install URL.
-            mPackageCfg = JsonObject(txt);
+            cfg = JsonObject(txt);
 
             return DACrc_t::dac_OK;
         }
@@ -1303,6 +1957,12 @@ LOGINFO(" ... Extracting >>>  '%s' ", filename);
         mDataCondition.notify_one();
     }
 
+    void JobPool::start()
+    {
+        std::unique_lock<std::mutex> lock(mLock);
+        mAcceptJobs = true;
+    }
+
     void JobPool::done()
     {
         std::unique_lock<std::mutex> lock(mLock);
@@ -1344,12 +2004,10 @@ LOGINFO(" ... Extracting >>>  '%s' ", filename);
 
             }//release the lock - scope !
 
-            LOGINFO("CALLING JOB");
-            LOGINFO("CALLING JOB");
-            LOGINFO("CALLING JOB");
-//            func();
-
-            // doInstall( job )
+            if (mHandler)
+            {
+                mHandler(job);
+            }
         }
     }
   }  // namespace Plugin
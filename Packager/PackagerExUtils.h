@@ -25,6 +25,9 @@
 #include <functional>
 #include <mutex>
 #include <condition_variable>
+#include <map>
+#include <set>
+#include <vector>
 
 #include "utils.h"
 
@@ -39,6 +42,7 @@
 
 #define TMP_FILENAME    "/opt/tmpApp.tgz"
 #define APPS_ROOT_PATH  "/opt/dac_apps"
+#define JOBS_ROOT_PATH  "/opt/persistent/dac_jobs"   // checkpoints of installs in progress
 
 namespace WPEFramework {
 namespace Plugin {
@@ -78,6 +82,9 @@ namespace Plugin {
 
     } JobMeta_t;
 
+    typedef std::function<void (const JobMeta_t&)>   JobFunc_t;
+    typedef std::function<void (uint64_t, uint64_t)> ProgressFunc_t;   // received, total (0 if unknown)
+
     // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
     // Threaded Job
     class JobPool
@@ -91,9 +98,12 @@ namespace Plugin {
 
             // void push(const FOO_T &job);
             void push(JobMeta_t& job);
+            void start();
             void done();
             void worker_func();
 
+            void setHandler(const JobFunc_t& handler) { mHandler = handler; }
+
       private:
 //            std::queue<std::function<void()>> mJobQ;
 
@@ -103,6 +113,8 @@ namespace Plugin {
             std::mutex               mLock;
             std::condition_variable  mDataCondition;
             std::atomic<bool>        mAcceptJobs;
+
+            JobFunc_t                mHandler;
     };// CLASS - JobPool
     // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
 
@@ -111,6 +123,7 @@ namespace Plugin {
     {
         public:
             enum class DACrc_t { dac_OK, dac_WARN, dac_FAIL };
+            enum class InstallRc_t { install_OK, install_DOWNLOAD_FAIL, install_EXTRACT_FAIL, install_VERIFY_FAIL, install_ABORTED };
 
             PackagerExUtils(const PackagerExUtils&) = delete;
             PackagerExUtils& operator=(const PackagerExUtils&) = delete;
@@ -155,26 +168,48 @@ namespace Plugin {
 
             // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
             // House-keeping
-            static void setupThreadQ(PackagerImplementation *ptr);
+            static void setupThreadQ(uint32_t threads, const JobFunc_t& handler);
             static void killThreadQ();
 
             static void addJob(JobMeta_t &job);
             // static void addJob( FOO_T &job );
 
+            // One job per package at a time
+            static bool claimPkg(const string& pkgId);
+            static void releasePkg(const string& pkgId);
+
+            static void     setProgress(uint32_t taskId, uint32_t percent);
+            static uint32_t getProgress(uint32_t taskId);
+
+            // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
+            // Checkpoints ... survive a restart, interrupted installs are queued again
+            static bool saveCheckpoint(const JobMeta_t& job, const string& bundle);
+            static void dropCheckpoint(const JobMeta_t& job);
+            static std::vector<JobMeta_t> loadCheckpoints();
+
             // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
             // Download helpers
             static DACrc_t validateURL(const char *url);
-            static DACrc_t downloadJSON(const char *url, const char *tempName);
+            static DACrc_t downloadJSON(const char *url, const char *tempName, JsonObject &cfg);
             static DACrc_t downloadURL( const char *url, const char *tempName);
 
+            // Shared by all downloads, 0 is unlimited
+            static void setBandwidth(uint64_t bytesPerSecond);
+
             // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
             // Archive helpers
             static DACrc_t extractPKG(const char *filename, const char *to_path = nullptr);
 
+            // Download, hash and extract in one pass, without a temporary file.
+            // An empty 'sha256' skips the verification, 'digest' is set either way.
+            // A dropped connection is resumed with a Range request where it left off.
+            static InstallRc_t installURL(const char *url, const char *to_path, const string& sha256,
+                                          uint64_t &installedBytes, string &digest,
+                                          const ProgressFunc_t& progress = nullptr);
+
             // - - - - - - - - - - - - - - - - - - - - - - - - - - - - - -
             // private data
             static void*        mData;
-            static JsonObject   mPackageCfg;
 
         private:
 
@@ -185,6 +220,9 @@ namespace Plugin {
 
             static Core::CriticalSection    mThreadLock;
 
+            static std::set<string>              mPkgsInFlight; // guarded by mThreadLock
+            static std::map<uint32_t, uint32_t>  mProgress;     // task -> percent, guarded by mThreadLock
+
             static const uint64_t  MAX_SIZE_BYTES;
             static const uint64_t  MAX_VALUE_SIZE_BYTES;
     };
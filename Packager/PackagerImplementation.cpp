@@ -104,6 +104,10 @@ namespace Plugin {
              _volatileCache = config.MakeCacheVolatile.Value();
          }
 
+#ifdef INCLUDE_PACKAGER_EX
+        PackagerExUtils::setBandwidth(static_cast<uint64_t>(config.MaxBandwidth.Value()) * 1024);
+#endif
+
         if (Core::File(_configFile).Exists() == false) {
             result = Core::ERROR_GENERAL;
         } else if (Core::Directory(_tempPath.c_str()).CreatePath() == false) {
@@ -116,6 +120,12 @@ namespace Plugin {
                 result = Core::ERROR_GENERAL;
             }
             */
+#ifdef INCLUDE_PACKAGER_EX
+  #ifdef USE_THREAD_POOL
+            PackagerExUtils::setupThreadQ(config.InstallThreads.Value(), [this](const JobMeta_t& job) { doInstall(job); });
+  #endif
+            ResumeInstalls();
+#endif
         }
 
         return (result);
@@ -128,7 +138,7 @@ namespace Plugin {
 #ifdef INCLUDE_PACKAGER_EX
 
   #ifdef USE_THREAD_POOL
-        PackagerExUtils::klllThreadQ(this);
+        PackagerExUtils::killThreadQ();
   #endif
         TermPackageDB();
 #endif
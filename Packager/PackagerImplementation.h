@@ -63,6 +63,10 @@ namespace Plugin {
                 , NoDeps()
                 , NoSignatureCheck()
                 , AlwaysUpdateFirst()
+#ifdef INCLUDE_PACKAGER_EX
+                , InstallThreads(0)             // Concurrent installs, 0 picks one from the CPU count
+                , MaxBandwidth(0)               // KB/s shared by all downloads, 0 is unlimited
+#endif
             {
                 Add(_T("config"), &ConfigFile);
                 Add(_T("temppath"), &TempDir);
@@ -72,6 +76,10 @@ namespace Plugin {
                 Add(_T("nodeps"), &NoDeps);
                 Add(_T("nosignaturecheck"), &NoSignatureCheck);
                 Add(_T("alwaysupdatefirst"), &AlwaysUpdateFirst);
+#ifdef INCLUDE_PACKAGER_EX
+                Add(_T("installthreads"), &InstallThreads);
+                Add(_T("maxbandwidth"), &MaxBandwidth);
+#endif
             }
 
             ~Config() override
@@ -89,6 +97,10 @@ namespace Plugin {
             Core::JSON::Boolean NoDeps;
             Core::JSON::Boolean NoSignatureCheck;
             Core::JSON::Boolean AlwaysUpdateFirst;
+#ifdef INCLUDE_PACKAGER_EX
+            Core::JSON::DecUInt8 InstallThreads;
+            Core::JSON::DecUInt32 MaxBandwidth;
+#endif
         };
 
         PackagerImplementation()
@@ -379,6 +391,7 @@ namespace Plugin {
 
         void InitPackageDB();
         void TermPackageDB();
+        void ResumeInstalls();
 
         void NotifyInstallStep(Exchange::IPackager::state status, uint32_t task = 0, string id = "", int32_t code = 0);   // NOTIFY
 
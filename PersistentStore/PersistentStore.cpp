@@ -26,6 +26,11 @@ const string WPEFramework::Plugin::PersistentStore::METHOD_GET_KEYS = "getKeys";
 const string WPEFramework::Plugin::PersistentStore::METHOD_GET_NAMESPACES = "getNamespaces";
 const string WPEFramework::Plugin::PersistentStore::METHOD_GET_STORAGE_SIZE = "getStorageSize";
 const string WPEFramework::Plugin::PersistentStore::METHOD_FLUSH_CACHE = "flushCache";
+const string WPEFramework::Plugin::PersistentStore::METHOD_SET_VALUES = "setValues";
+const string WPEFramework::Plugin::PersistentStore::METHOD_GET_VALUES = "getValues";
+const string WPEFramework::Plugin::PersistentStore::METHOD_DELETE_KEYS = "deleteKeys";
+const string WPEFramework::Plugin::PersistentStore::METHOD_GET_CACHE_STATS = "getCacheStats";
+const string WPEFramework::Plugin::PersistentStore::METHOD_GET_NAMESPACE_STORAGE_USAGE = "getNamespaceStorageUsage";
 const string WPEFramework::Plugin::PersistentStore::EVT_ON_STORAGE_EXCEEDED = "onStorageExceeded";
 const char* WPEFramework::Plugin::PersistentStore::STORE_NAME = "rdkservicestore";
 const char* WPEFramework::Plugin::PersistentStore::STORE_KEY = "xyzzy123";
@@ -71,7 +76,22 @@ namespace WPEFramework {
         PersistentStore::PersistentStore()
             : AbstractPlugin()
             , mData(nullptr)
-            , mReading(0)
+            , mStmtInsertNamespace(nullptr)
+            , mStmtInsertItem(nullptr)
+            , mStmtItemSize(nullptr)
+            , mStmtDeleteItem(nullptr)
+            , mStmtDeleteNamespace(nullptr)
+            , mSize(0)
+            , mMaxSize(MAX_SIZE_BYTES)
+            , mMaxValueSize(MAX_VALUE_SIZE_BYTES)
+            , mNamespaceQuota(0)
+            , mDirtyBytes(0)
+            , mCacheSize(0)
+            , mWriteBehind(false)
+            , mCacheHits(0)
+            , mCacheMisses(0)
+            , mCacheEvictions(0)
+            , mCacheFlushes(0)
         {
             registerMethod(METHOD_SET_VALUE, &PersistentStore::setValueWrapper, this);
             registerMethod(METHOD_GET_VALUE, &PersistentStore::getValueWrapper, this);
@@ -81,19 +101,61 @@ namespace WPEFramework {
             registerMethod(METHOD_GET_NAMESPACES, &PersistentStore::getNamespacesWrapper, this);
             registerMethod(METHOD_GET_STORAGE_SIZE, &PersistentStore::getStorageSizeWrapper, this);
             registerMethod(METHOD_FLUSH_CACHE, &PersistentStore::flushCacheWrapper, this);
+            registerMethod(METHOD_SET_VALUES, &PersistentStore::setValuesWrapper, this);
+            registerMethod(METHOD_GET_VALUES, &PersistentStore::getValuesWrapper, this);
+            registerMethod(METHOD_DELETE_KEYS, &PersistentStore::deleteKeysWrapper, this);
+            registerMethod(METHOD_GET_CACHE_STATS, &PersistentStore::getCacheStatsWrapper, this);
+            registerMethod(METHOD_GET_NAMESPACE_STORAGE_USAGE, &PersistentStore::getNamespaceStorageUsageWrapper, this);
+
+            mFlushTimer.connect(std::bind(&PersistentStore::flushPending, this));
         }
 
         PersistentStore::~PersistentStore()
         {
         }
 
-        const string PersistentStore::Initialize(PluginHost::IShell* /* service */)
+        const string PersistentStore::Initialize(PluginHost::IShell* service)
         {
-            return open() ? "" : "init failed";
+            Config config;
+            config.FromString(service->ConfigLine());
+
+            mCacheSize = config.CacheSize.Value();
+            mWriteBehind = config.WriteBehind.Value();
+            mMaxSize = config.MaxSize.Value();
+            mMaxValueSize = config.MaxValueSize.Value();
+            mNamespaceQuota = config.NamespaceQuota.Value();
+
+            mQuotas.clear();
+            Core::JSON::ArrayType<Config::Quota>::Iterator quota(config.Quotas.Elements());
+            while (quota.Next() == true)
+            {
+                if (quota.Current().Namespace.IsSet() && quota.Current().Size.IsSet())
+                    mQuotas[quota.Current().Namespace.Value()] = quota.Current().Size.Value();
+            }
+
+            if (!open())
+                return "init failed";
+
+            if (mWriteBehind)
+                mFlushTimer.start(config.FlushInterval.Value());
+
+            return "";
         }
 
         void PersistentStore::Deinitialize(PluginHost::IShell* /* service */)
         {
+            if (mFlushTimer.isActive())
+                mFlushTimer.stop();
+
+            {
+                lock_guard<shared_timed_mutex> lck(mLock);
+                writePending();
+
+                lock_guard<mutex> cacheLck(mCacheLock);
+                if (!mDirty.empty())
+                    LOGERR("ERROR %zu namespaces have pending items that could not be written", mDirty.size());
+            }
+
             term();
         }
 
@@ -121,7 +183,7 @@ namespace WPEFramework {
                 string value = parameters["value"].String();
                 if (ns.empty() || key.empty())
                     response["error"] = "params empty";
-                else if (ns.size() > 1000 || key.size() > 1000 || value.size() > 1000)
+                else if (ns.size() > mMaxValueSize || key.size() > mMaxValueSize || value.size() > mMaxValueSize)
                     response["error"] = "params too long";
                 else
                     success = setValue(ns, key, value);
@@ -279,14 +341,183 @@ namespace WPEFramework {
             returnResponse(success);
         }
 
+        uint32_t PersistentStore::setValuesWrapper(const JsonObject& parameters, JsonObject& response)
+        {
+            LOGINFOMETHOD();
+
+            bool success = false;
+            vector<Entry> entries;
+            string error;
+            if (!getEntries(parameters, true, entries, error))
+                response["error"] = error;
+            else
+                success = setValues(entries);
+
+            returnResponse(success);
+        }
+
+        uint32_t PersistentStore::getValuesWrapper(const JsonObject& parameters, JsonObject& response)
+        {
+            LOGINFOMETHOD();
+
+            bool success = false;
+            vector<Entry> keys;
+            string error;
+            if (!getEntries(parameters, false, keys, error))
+                response["error"] = error;
+            else
+            {
+                vector<Entry> values;
+                success = getValues(keys, values);
+                if (success)
+                {
+                    JsonArray jsonItems;
+                    for (auto it = values.begin(); it != values.end(); ++it)
+                    {
+                        JsonObject item;
+                        item["namespace"] = it->ns;
+                        item["key"] = it->key;
+                        item["value"] = it->value;
+                        jsonItems.Add(item);
+                    }
+                    response["items"] = jsonItems;
+                }
+            }
+
+            returnResponse(success);
+        }
+
+        uint32_t PersistentStore::deleteKeysWrapper(const JsonObject& parameters, JsonObject& response)
+        {
+            LOGINFOMETHOD();
+
+            bool success = false;
+            vector<Entry> keys;
+            string error;
+            if (!getEntries(parameters, false, keys, error))
+                response["error"] = error;
+            else
+                success = deleteKeys(keys);
+
+            returnResponse(success);
+        }
+
+        uint32_t PersistentStore::getCacheStatsWrapper(const JsonObject& parameters, JsonObject& response)
+        {
+            LOGINFOMETHOD();
+
+            lock_guard<mutex> lck(mCacheLock);
+
+            uint64_t entries = 0;
+            for (auto it = mCache.begin(); it != mCache.end(); ++it)
+                entries += it->second.items.size();
+
+            uint64_t dirty = 0;
+            for (auto it = mDirty.begin(); it != mDirty.end(); ++it)
+                dirty += it->second.size();
+
+            response["hits"] = mCacheHits;
+            response["misses"] = mCacheMisses;
+            response["evictions"] = mCacheEvictions;
+            response["entries"] = entries;
+            response["dirty"] = dirty;
+            response["flushes"] = mCacheFlushes;
+            response["writeBehind"] = mWriteBehind;
+
+            returnResponse(true);
+        }
+
+        uint32_t PersistentStore::getNamespaceStorageUsageWrapper(const JsonObject& parameters, JsonObject& response)
+        {
+            LOGINFOMETHOD();
+
+            string from;
+            uint32_t count;
+            getDefaultStringParameter("from", from, "");
+            getDefaultNumberParameter("count", count, 100);
+
+            bool success = false;
+            if (count == 0)
+                response["error"] = "params empty";
+            else
+            {
+                vector<pair<string, uint64_t>> usage;
+                string next;
+                success = getNamespaceStorageUsage(from, count, usage, next);
+                if (success)
+                {
+                    JsonArray jsonNamespaces;
+                    for (auto it = usage.begin(); it != usage.end(); ++it)
+                    {
+                        JsonObject jsonNamespace;
+                        jsonNamespace["namespace"] = it->first;
+                        jsonNamespace["size"] = it->second;
+                        jsonNamespace["quota"] = namespaceQuota(it->first);
+                        jsonNamespaces.Add(jsonNamespace);
+                    }
+                    response["namespaces"] = jsonNamespaces;
+                    if (!next.empty())
+                        response["next"] = next;
+                }
+            }
+
+            returnResponse(success);
+        }
+
+        bool PersistentStore::getEntries(const JsonObject& parameters, bool withValue, std::vector<Entry>& entries, string& error) const
+        {
+            if (!parameters.HasLabel("items"))
+            {
+                error = "params missing";
+                return false;
+            }
+
+            const JsonArray items = parameters["items"].Array();
+            if (items.Length() == 0)
+            {
+                error = "params empty";
+                return false;
+            }
+
+            for (uint32_t i = 0; i < items.Length(); i++)
+            {
+                const JsonObject& item = items[i].Object();
+                if (!item.HasLabel("namespace") ||
+                    !item.HasLabel("key") ||
+                    (withValue && !item.HasLabel("value")))
+                {
+                    error = "params missing";
+                    return false;
+                }
+
+                Entry entry { item["namespace"].String(), item["key"].String(), withValue ? item["value"].String() : string() };
+                if (entry.ns.empty() || entry.key.empty())
+                {
+                    error = "params empty";
+                    return false;
+                }
+                if (entry.ns.size() > mMaxValueSize || entry.key.size() > mMaxValueSize || entry.value.size() > mMaxValueSize)
+                {
+                    error = "params too long";
+                    return false;
+                }
+
+                entries.push_back(entry);
+            }
+
+            return true;
+        }
+
         bool PersistentStore::setValue(const string& ns, const string& key, const string& value)
         {
             LOGINFO("%s %s %s", ns.c_str(), key.c_str(), value.c_str());
 
+            if (mWriteBehind)
+                return stageEntries({ { ns, key, value } });
+
             bool success = false;
 
-            lock_guard<mutex> lck(mLock);
-            while (mReading > 0);
+            lock_guard<shared_timed_mutex> lck(mLock);
 
             sqlite3* &db = SQLITE;
 
@@ -297,102 +528,100 @@ namespace WPEFramework {
                 if (!db)
                     break;
 
-                sqlite3_stmt *stmt;
-                sqlite3_prepare_v2(db, "SELECT sum(s) FROM ("
-                                       " SELECT sum(length(key)+length(value)) s FROM item"
-                                       " UNION ALL"
-                                       " SELECT sum(length(name)) s FROM namespace"
-                                       ");", -1, &stmt, nullptr);
-
-                rc = sqlite3_step(stmt);
-                if (rc == SQLITE_ROW)
+                if (mSize > mMaxSize)
                 {
-                    int64_t size = sqlite3_column_int64(stmt, 0);
-                    if (size > MAX_SIZE_BYTES)
-                        LOGWARN("max size exceeded: %lld", size);
-                    else
-                        success = true;
+                    LOGWARN("max size exceeded: %lld", mSize);
+                    break;
                 }
-                else
-                    LOGERR("ERROR getting size: %s", sqlite3_errstr(rc));
-
-                sqlite3_finalize(stmt);
 
+                rc = insertItem(ns, key, value);
+                success = (rc == SQLITE_DONE);
                 if (success)
-                {
-                    success = false;
+                    cachePut(ns, key, value);
+            } while (!success && SQLITE_IS_ERROR_DBWRITE(rc) && (++retry < 2) && open());
 
-                    sqlite3_stmt *stmt;
-                    sqlite3_prepare_v2(db, "INSERT OR IGNORE INTO namespace (name) values (?);", -1, &stmt, nullptr);
+            if (success && mSize > mMaxSize)
+            {
+                LOGWARN("max size exceeded: %lld", mSize);
 
-                    sqlite3_bind_text(stmt, 1, ns.c_str(), -1, SQLITE_TRANSIENT);
+                JsonObject params;
+                sendNotify(C_STR(EVT_ON_STORAGE_EXCEEDED), params);
 
-                    rc = sqlite3_step(stmt);
-                    if (rc != SQLITE_DONE)
-                        LOGERR("ERROR inserting data: %s", sqlite3_errstr(rc));
-                    else
-                        success = true;
+                success = false;
+            }
 
-                    sqlite3_finalize(stmt);
-                }
+            return success;
+        }
 
-                if (success)
-                {
-                    success = false;
+        bool PersistentStore::setValues(const std::vector<Entry>& entries)
+        {
+            LOGINFO("%zu", entries.size());
 
-                    sqlite3_stmt *stmt;
-                    sqlite3_prepare_v2(db, "INSERT INTO item (ns,key,value)"
-                                           " SELECT id, ?, ?"
-                                           " FROM namespace"
-                                           " WHERE name = ?"
-                                           ";", -1, &stmt, nullptr);
+            if (mWriteBehind)
+                return stageEntries(entries);
 
-                    sqlite3_bind_text(stmt, 1, key.c_str(), -1, SQLITE_TRANSIENT);
-                    sqlite3_bind_text(stmt, 2, value.c_str(), -1, SQLITE_TRANSIENT);
-                    sqlite3_bind_text(stmt, 3, ns.c_str(), -1, SQLITE_TRANSIENT);
+            lock_guard<shared_timed_mutex> lck(mLock);
 
-                    rc = sqlite3_step(stmt);
-                    if (rc != SQLITE_DONE)
-                        LOGERR("ERROR inserting data: %s", sqlite3_errstr(rc));
-                    else
-                        success = true;
+            return (writeEntries(entries) == WRITE_COMMITTED);
+        }
 
-                    sqlite3_finalize(stmt);
-                }
-            } while (!success && SQLITE_IS_ERROR_DBWRITE(rc) && (++retry < 2) && open());
+        // WRITE_COMMITTED_OVER_MAX_SIZE: the entries are saved, but the store is now over its max size
+        PersistentStore::WriteResult PersistentStore::writeEntries(const std::vector<Entry>& entries)
+        {
+            bool success = false;
 
-            if (success)
-            {
-                success = false;
+            sqlite3* &db = SQLITE;
 
-                sqlite3_stmt *stmt;
-                sqlite3_prepare_v2(db, "SELECT sum(s) FROM ("
-                                       " SELECT sum(length(key)+length(value)) s FROM item"
-                                       " UNION ALL"
-                                       " SELECT sum(length(name)) s FROM namespace"
-                                       ");", -1, &stmt, nullptr);
+            int retry = 0;
+            int rc;
+            do
+            {
+                if (!db)
+                    break;
 
-                rc = sqlite3_step(stmt);
-                if (rc == SQLITE_ROW)
+                if (mSize > mMaxSize)
                 {
-                    int64_t size = sqlite3_column_int64(stmt, 0);
-                    if (size > MAX_SIZE_BYTES)
-                    {
-                        LOGWARN("max size exceeded: %lld", size);
+                    LOGWARN("max size exceeded: %lld", mSize);
+                    break;
+                }
 
-                        JsonObject params;
-                        sendNotify(C_STR(EVT_ON_STORAGE_EXCEEDED), params);
-                    }
-                    else
-                        success = true;
+                rc = sqlite3_exec(db, "BEGIN IMMEDIATE;", 0, 0, nullptr);
+                if (rc != SQLITE_OK)
+                {
+                    LOGERR("ERROR starting transaction: %s", sqlite3_errstr(rc));
+                    continue;
                 }
+
+                rc = SQLITE_DONE;
+                for (auto it = entries.begin(); it != entries.end() && rc == SQLITE_DONE; ++it)
+                    rc = insertItem(it->ns, it->key, it->value);
+
+                if (rc == SQLITE_DONE)
+                    success = commit();
                 else
-                    LOGERR("ERROR getting size: %s", sqlite3_errstr(rc));
+                    rollback();
 
-                sqlite3_finalize(stmt);
+                if (success)
+                {
+                    for (auto it = entries.begin(); it != entries.end(); ++it)
+                        cachePut(it->ns, it->key, it->value);
+                }
+            } while (!success && SQLITE_IS_ERROR_DBWRITE(rc) && (++retry < 2) && open());
+
+            if (!success)
+                return WRITE_FAILED;
+
+            if (mSize > mMaxSize)
+            {
+                LOGWARN("max size exceeded: %lld", mSize);
+
+                JsonObject params;
+                sendNotify(C_STR(EVT_ON_STORAGE_EXCEEDED), params);
+
+                return WRITE_COMMITTED_OVER_MAX_SIZE;
             }
 
-            return success;
+            return WRITE_COMMITTED;
         }
 
         bool PersistentStore::getValue(const string& ns, const string& key, string& value)
@@ -401,14 +630,13 @@ namespace WPEFramework {
 
             bool success = false;
 
-            {
-                lock_guard<mutex> lck(mLock);
-                mReading++;
-            }
+            shared_lock<shared_timed_mutex> lck(mLock);
 
             sqlite3* &db = SQLITE;
 
-            if (db)
+            if (db && cacheGet(ns, key, value))
+                success = true;
+            else if (db)
             {
                 sqlite3_stmt *stmt;
                 sqlite3_prepare_v2(db, "SELECT value"
@@ -424,6 +652,7 @@ namespace WPEFramework {
                 if (rc == SQLITE_ROW)
                 {
                     value = (const char*)sqlite3_column_text(stmt, 0);
+                    cachePut(ns, key, value);
                     success = true;
                 }
                 else
@@ -431,7 +660,57 @@ namespace WPEFramework {
                 sqlite3_finalize(stmt);
             }
 
-            mReading--;
+            return success;
+        }
+
+        bool PersistentStore::getValues(const std::vector<Entry>& keys, std::vector<Entry>& values)
+        {
+            LOGINFO("%zu", keys.size());
+
+            bool success = false;
+
+            shared_lock<shared_timed_mutex> lck(mLock);
+
+            sqlite3* &db = SQLITE;
+
+            values.clear();
+
+            if (db)
+            {
+                sqlite3_stmt *stmt;
+                sqlite3_prepare_v2(db, "SELECT value"
+                                       " FROM item"
+                                       " INNER JOIN namespace ON namespace.id = item.ns"
+                                       " where name = ? and key = ?"
+                                       ";", -1, &stmt, nullptr);
+
+                for (auto it = keys.begin(); it != keys.end(); ++it)
+                {
+                    string value;
+                    if (cacheGet(it->ns, it->key, value))
+                    {
+                        values.push_back({ it->ns, it->key, value });
+                        continue;
+                    }
+
+                    sqlite3_bind_text(stmt, 1, it->ns.c_str(), -1, SQLITE_TRANSIENT);
+                    sqlite3_bind_text(stmt, 2, it->key.c_str(), -1, SQLITE_TRANSIENT);
+
+                    int rc = sqlite3_step(stmt);
+                    if (rc == SQLITE_ROW)
+                    {
+                        values.push_back({ it->ns, it->key, (const char*)sqlite3_column_text(stmt, 0) });
+                        cachePut(it->ns, it->key, values.back().value);
+                    }
+                    else
+                        LOGWARN("not found: %s %s %d", it->ns.c_str(), it->key.c_str(), rc);
+
+                    sqlite3_reset(stmt);
+                }
+
+                sqlite3_finalize(stmt);
+                success = true;
+            }
 
             return success;
         }
@@ -442,8 +721,7 @@ namespace WPEFramework {
 
             bool success = false;
 
-            lock_guard<mutex> lck(mLock);
-            while (mReading > 0);
+            lock_guard<shared_timed_mutex> lck(mLock);
 
             sqlite3* &db = SQLITE;
 
@@ -454,22 +732,50 @@ namespace WPEFramework {
                 if (!db)
                     break;
 
-                sqlite3_stmt *stmt;
-                sqlite3_prepare_v2(db, "DELETE FROM item"
-                                       " where ns in (select id from namespace where name = ?)"
-                                       " and key = ?"
-                                       ";", -1, &stmt, NULL);
+                cacheRemove(ns, key);
 
-                sqlite3_bind_text(stmt, 1, ns.c_str(), -1, SQLITE_TRANSIENT);
-                sqlite3_bind_text(stmt, 2, key.c_str(), -1, SQLITE_TRANSIENT);
+                rc = removeItem(ns, key);
+                success = (rc == SQLITE_DONE);
+            } while (!success && SQLITE_IS_ERROR_DBWRITE(rc) && (++retry < 2) && open());
 
-                rc = sqlite3_step(stmt);
-                if (rc != SQLITE_DONE)
-                    LOGERR("ERROR removing data: %s", sqlite3_errstr(rc));
-                else
-                    success = true;
+            return success;
+        }
 
-                sqlite3_finalize(stmt);
+        bool PersistentStore::deleteKeys(const std::vector<Entry>& keys)
+        {
+            LOGINFO("%zu", keys.size());
+
+            bool success = false;
+
+            lock_guard<shared_timed_mutex> lck(mLock);
+
+            sqlite3* &db = SQLITE;
+
+            int retry = 0;
+            int rc;
+            do
+            {
+                if (!db)
+                    break;
+
+                rc = sqlite3_exec(db, "BEGIN IMMEDIATE;", 0, 0, nullptr);
+                if (rc != SQLITE_OK)
+                {
+                    LOGERR("ERROR starting transaction: %s", sqlite3_errstr(rc));
+                    continue;
+                }
+
+                rc = SQLITE_DONE;
+                for (auto it = keys.begin(); it != keys.end() && rc == SQLITE_DONE; ++it)
+                {
+                    cacheRemove(it->ns, it->key);
+                    rc = removeItem(it->ns, it->key);
+                }
+
+                if (rc == SQLITE_DONE)
+                    success = commit();
+                else
+                    rollback();
             } while (!success && SQLITE_IS_ERROR_DBWRITE(rc) && (++retry < 2) && open());
 
             return success;
@@ -481,8 +787,7 @@ namespace WPEFramework {
 
             bool success = false;
 
-            lock_guard<mutex> lck(mLock);
-            while (mReading > 0);
+            lock_guard<shared_timed_mutex> lck(mLock);
 
             sqlite3* &db = SQLITE;
 
@@ -493,8 +798,9 @@ namespace WPEFramework {
                 if (!db)
                     break;
 
-                sqlite3_stmt *stmt;
-                sqlite3_prepare_v2(db, "DELETE FROM namespace where name = ?;", -1, &stmt, NULL);
+                cacheRemove(ns);
+
+                sqlite3_stmt* &stmt = mStmtDeleteNamespace;
 
                 sqlite3_bind_text(stmt, 1, ns.c_str(), -1, SQLITE_TRANSIENT);
 
@@ -502,9 +808,18 @@ namespace WPEFramework {
                 if (rc != SQLITE_DONE)
                     LOGERR("ERROR removing data: %s", sqlite3_errstr(rc));
                 else
+                {
+                    auto it = mNamespaceSizes.find(ns);
+                    if (it != mNamespaceSizes.end())
+                    {
+                        mSize -= ns.size() + it->second;
+                        mNamespaceSizes.erase(it);
+                    }
                     success = true;
+                }
 
-                sqlite3_finalize(stmt);
+                sqlite3_reset(stmt);
+                sqlite3_clear_bindings(stmt);
             } while (!success && SQLITE_IS_ERROR_DBWRITE(rc) && (++retry < 2) && open());
 
             return success;
@@ -516,10 +831,9 @@ namespace WPEFramework {
 
             bool success = false;
 
-            {
-                lock_guard<mutex> lck(mLock);
-                mReading++;
-            }
+            flushPending();
+
+            shared_lock<shared_timed_mutex> lck(mLock);
 
             sqlite3* &db = SQLITE;
 
@@ -542,8 +856,6 @@ namespace WPEFramework {
                 success = true;
             }
 
-            mReading--;
-
             return success;
         }
 
@@ -551,10 +863,9 @@ namespace WPEFramework {
         {
             bool success = false;
 
-            {
-                lock_guard<mutex> lck(mLock);
-                mReading++;
-            }
+            flushPending();
+
+            shared_lock<shared_timed_mutex> lck(mLock);
 
             sqlite3* &db = SQLITE;
 
@@ -572,8 +883,6 @@ namespace WPEFramework {
                 success = true;
             }
 
-            mReading--;
-
             return success;
         }
 
@@ -581,10 +890,9 @@ namespace WPEFramework {
         {
             bool success = false;
 
-            {
-                lock_guard<mutex> lck(mLock);
-                mReading++;
-            }
+            flushPending();
+
+            shared_lock<shared_timed_mutex> lck(mLock);
 
             sqlite3* &db = SQLITE;
 
@@ -592,29 +900,50 @@ namespace WPEFramework {
 
             if (db)
             {
-                sqlite3_stmt *stmt;
-                sqlite3_prepare_v2(db, "SELECT name, sum(length(key)+length(value))"
-                                       " FROM item"
-                                       " INNER JOIN namespace ON namespace.id = item.ns"
-                                       " GROUP BY name"
-                                       ";", -1, &stmt, NULL);
+                for (auto it = mNamespaceSizes.begin(); it != mNamespaceSizes.end(); ++it)
+                {
+                    if (it->second > 0)
+                        namespaceSizes[it->first] = it->second;
+                }
+                success = true;
+            }
 
-                while (sqlite3_step(stmt) == SQLITE_ROW)
-                    namespaceSizes[(const char*)sqlite3_column_text(stmt, 0)] = sqlite3_column_int(stmt, 1);
+            return success;
+        }
+
+        bool PersistentStore::getNamespaceStorageUsage(const string& from, uint32_t count, std::vector<std::pair<string, uint64_t>>& usage, string& next)
+        {
+            bool success = false;
+
+            flushPending();
+
+            shared_lock<shared_timed_mutex> lck(mLock);
+
+            sqlite3* &db = SQLITE;
+
+            usage.clear();
+            next.clear();
+
+            if (db)
+            {
+                auto it = from.empty() ? mNamespaceSizes.begin() : mNamespaceSizes.upper_bound(from);
+                for (; it != mNamespaceSizes.end() && usage.size() < count; ++it)
+                    usage.emplace_back(it->first, it->second);
+
+                if (it != mNamespaceSizes.end())
+                    next = usage.back().first;
 
-                sqlite3_finalize(stmt);
                 success = true;
             }
 
-            mReading--;
-
             return success;
         }
 
         bool PersistentStore::flushCache()
         {
-            lock_guard<mutex> lck(mLock);
-            while (mReading > 0);
+            lock_guard<shared_timed_mutex> lck(mLock);
+
+            writePending();
 
             sqlite3* &db = SQLITE;
             bool success = false;
@@ -661,6 +990,8 @@ namespace WPEFramework {
         {
             sqlite3* &db = SQLITE;
 
+            finalizeStatements();
+
             if (db)
             {
                 int rc = sqlite3_db_cacheflush(db);
@@ -672,6 +1003,12 @@ namespace WPEFramework {
             }
 
             db = nullptr;
+
+            mNamespaceSizes.clear();
+            mSize = 0;
+
+            lock_guard<mutex> lck(mCacheLock);
+            mCache.clear();
         }
 
         void PersistentStore::vacuum()
@@ -833,7 +1170,610 @@ namespace WPEFramework {
                     LOGERR("%d", rc);
             }
 
+            // WAL needs fewer syncs per commit; there is a single connection, so readers still wait for writers on mLock
+            rc = sqlite3_exec(db, "PRAGMA journal_mode = WAL;", 0, 0, &errmsg);
+            if (rc != SQLITE_OK || errmsg)
+            {
+                if (errmsg)
+                {
+                    LOGERR("%d : %s", rc, errmsg);
+                    sqlite3_free(errmsg);
+                }
+                else
+                    LOGERR("%d", rc);
+            }
+
+            if (!prepareStatements() || !loadSizes())
+            {
+                term();
+                return false;
+            }
+
+            return true;
+        }
+
+        bool PersistentStore::prepareStatements()
+        {
+            sqlite3* &db = SQLITE;
+
+            struct {
+                sqlite3_stmt** stmt;
+                const char* sql;
+            } statements[] = {
+                { &mStmtInsertNamespace, "INSERT OR IGNORE INTO namespace (name) values (?);" },
+                { &mStmtInsertItem, "INSERT INTO item (ns,key,value)"
+                                    " SELECT id, ?, ?"
+                                    " FROM namespace"
+                                    " WHERE name = ?"
+                                    ";" },
+                { &mStmtItemSize, "SELECT length(CAST(key AS BLOB))+length(CAST(value AS BLOB))"
+                                  " FROM item"
+                                  " INNER JOIN namespace ON namespace.id = item.ns"
+                                  " where name = ? and key = ?"
+                                  ";" },
+                { &mStmtDeleteItem, "DELETE FROM item"
+                                    " where ns in (select id from namespace where name = ?)"
+                                    " and key = ?"
+                                    ";" },
+                { &mStmtDeleteNamespace, "DELETE FROM namespace where name = ?;" },
+            };
+
+            for (auto& s : statements)
+            {
+                int rc = sqlite3_prepare_v2(db, s.sql, -1, s.stmt, nullptr);
+                if (rc != SQLITE_OK)
+                {
+                    LOGERR("ERROR preparing statement: %s", sqlite3_errstr(rc));
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
+        void PersistentStore::finalizeStatements()
+        {
+            for (sqlite3_stmt** stmt : { &mStmtInsertNamespace, &mStmtInsertItem, &mStmtItemSize, &mStmtDeleteItem, &mStmtDeleteNamespace })
+            {
+                sqlite3_finalize(*stmt);
+                *stmt = nullptr;
+            }
+        }
+
+        bool PersistentStore::loadSizes()
+        {
+            sqlite3* &db = SQLITE;
+
+            mNamespaceSizes.clear();
+            mSize = 0;
+
+            sqlite3_stmt *stmt;
+            sqlite3_prepare_v2(db, "SELECT name,"
+                                   " (SELECT sum(length(CAST(key AS BLOB))+length(CAST(value AS BLOB))) FROM item WHERE item.ns = namespace.id)"
+                                   " FROM namespace"
+                                   ";", -1, &stmt, nullptr);
+
+            int rc;
+            while ((rc = sqlite3_step(stmt)) == SQLITE_ROW)
+            {
+                string name = (const char*)sqlite3_column_text(stmt, 0);
+                int64_t size = sqlite3_column_int64(stmt, 1);
+                mNamespaceSizes[name] = size;
+                mSize += name.size() + size;
+            }
+
+            sqlite3_finalize(stmt);
+
+            if (rc != SQLITE_DONE)
+            {
+                LOGERR("ERROR getting size: %s", sqlite3_errstr(rc));
+                return false;
+            }
+
+            return true;
+        }
+
+        int PersistentStore::itemSize(const string& ns, const string& key, int64_t& size)
+        {
+            sqlite3_stmt* &stmt = mStmtItemSize;
+
+            sqlite3_bind_text(stmt, 1, ns.c_str(), -1, SQLITE_TRANSIENT);
+            sqlite3_bind_text(stmt, 2, key.c_str(), -1, SQLITE_TRANSIENT);
+
+            int rc = sqlite3_step(stmt);
+            if (rc == SQLITE_ROW)
+            {
+                size = sqlite3_column_int64(stmt, 0);
+                rc = SQLITE_OK;
+            }
+            else if (rc == SQLITE_DONE)
+            {
+                size = 0;
+                rc = SQLITE_OK;
+            }
+
+            sqlite3_reset(stmt);
+            sqlite3_clear_bindings(stmt);
+
+            return rc;
+        }
+        int PersistentStore::insertItem(const string& ns, const string& key, const string& value)
+        {
+            int64_t oldSize = 0;
+            int rc = itemSize(ns, key, oldSize);
+            if (rc != SQLITE_OK)
+            {
+                LOGERR("ERROR getting size: %s", sqlite3_errstr(rc));
+                return rc;
+            }
+
+            int64_t quota = namespaceQuota(ns);
+            int64_t newSize = key.size() + value.size();
+            if (quota > 0 && newSize > oldSize)
+            {
+                auto nsSize = mNamespaceSizes.find(ns);
+                int64_t size = (nsSize != mNamespaceSizes.end() ? nsSize->second : 0) + newSize - oldSize;
+                if (size > quota)
+                {
+                    LOGWARN("namespace %s quota exceeded: %lld > %lld", ns.c_str(), size, quota);
+
+                    JsonObject params;
+                    params["namespace"] = ns;
+                    sendNotify(C_STR(EVT_ON_STORAGE_EXCEEDED), params);
+
+                    return SQLITE_FULL;
+                }
+            }
+
+            sqlite3_stmt* stmt = mStmtInsertNamespace;
+
+            sqlite3_bind_text(stmt, 1, ns.c_str(), -1, SQLITE_TRANSIENT);
+
+            rc = sqlite3_step(stmt);
+            if (rc != SQLITE_DONE)
+                LOGERR("ERROR inserting data: %s", sqlite3_errstr(rc));
+            else if (mNamespaceSizes.find(ns) == mNamespaceSizes.end())
+            {
+                mNamespaceSizes[ns] = 0;
+                mSize += ns.size();
+            }
+
+            sqlite3_reset(stmt);
+            sqlite3_clear_bindings(stmt);
+
+            if (rc != SQLITE_DONE)
+                return rc;
+
+            stmt = mStmtInsertItem;
+
+            sqlite3_bind_text(stmt, 1, key.c_str(), -1, SQLITE_TRANSIENT);
+            sqlite3_bind_text(stmt, 2, value.c_str(), -1, SQLITE_TRANSIENT);
+            sqlite3_bind_text(stmt, 3, ns.c_str(), -1, SQLITE_TRANSIENT);
+
+            rc = sqlite3_step(stmt);
+            if (rc != SQLITE_DONE)
+                LOGERR("ERROR inserting data: %s", sqlite3_errstr(rc));
+            else
+            {
+                mNamespaceSizes[ns] += newSize - oldSize;
+                mSize += newSize - oldSize;
+            }
+
+            sqlite3_reset(stmt);
+            sqlite3_clear_bindings(stmt);
+
+            return rc;
+        }
+
+        int PersistentStore::removeItem(const string& ns, const string& key)
+        {
+            int64_t oldSize = 0;
+            int rc = itemSize(ns, key, oldSize);
+            if (rc != SQLITE_OK)
+            {
+                LOGERR("ERROR getting size: %s", sqlite3_errstr(rc));
+                return rc;
+            }
+
+            sqlite3_stmt* stmt = mStmtDeleteItem;
+
+            sqlite3_bind_text(stmt, 1, ns.c_str(), -1, SQLITE_TRANSIENT);
+            sqlite3_bind_text(stmt, 2, key.c_str(), -1, SQLITE_TRANSIENT);
+
+            rc = sqlite3_step(stmt);
+            if (rc != SQLITE_DONE)
+                LOGERR("ERROR removing data: %s", sqlite3_errstr(rc));
+            else if (oldSize > 0)
+            {
+                mNamespaceSizes[ns] -= oldSize;
+                mSize -= oldSize;
+            }
+
+            sqlite3_reset(stmt);
+            sqlite3_clear_bindings(stmt);
+
+            return rc;
+        }
+
+        bool PersistentStore::commit()
+        {
+            sqlite3* &db = SQLITE;
+
+            int rc = sqlite3_exec(db, "COMMIT;", 0, 0, nullptr);
+            if (rc == SQLITE_OK)
+                return true;
+
+            LOGERR("ERROR committing transaction: %s", sqlite3_errstr(rc));
+            rollback();
+            return false;
+        }
+
+        void PersistentStore::rollback()
+        {
+            sqlite3* &db = SQLITE;
+
+            if (!sqlite3_get_autocommit(db))
+            {
+                int rc = sqlite3_exec(db, "ROLLBACK;", 0, 0, nullptr);
+                if (rc != SQLITE_OK)
+                    LOGERR("ERROR rolling back transaction: %s", sqlite3_errstr(rc));
+            }
+
+            // the running totals have already been updated for the undone writes
+            loadSizes();
+        }
+        bool PersistentStore::stageEntries(const std::vector<Entry>& entries)
+        {
+            shared_lock<shared_timed_mutex> lck(mLock);
+
+            sqlite3* &db = SQLITE;
+
+            if (!db)
+                return false;
+
+            if (mSize > mMaxSize)
+            {
+                LOGWARN("max size exceeded: %lld", mSize);
+                return false;
+            }
+
+            // committed size of the items in namespaces with a quota, the writer statements are not ours to use here
+            std::vector<int64_t> oldSizes(entries.size(), 0);
+            sqlite3_stmt *stmt = nullptr;
+            for (size_t i = 0; i < entries.size(); i++)
+            {
+                if (namespaceQuota(entries[i].ns) <= 0)
+                    continue;
+
+                if (!stmt)
+                {
+                    sqlite3_prepare_v2(db, "SELECT length(CAST(key AS BLOB))+length(CAST(value AS BLOB))"
+                                           " FROM item"
+                                           " INNER JOIN namespace ON namespace.id = item.ns"
+                                           " where name = ? and key = ?"
+                                           ";", -1, &stmt, nullptr);
+                }
+
+                sqlite3_bind_text(stmt, 1, entries[i].ns.c_str(), -1, SQLITE_TRANSIENT);
+                sqlite3_bind_text(stmt, 2, entries[i].key.c_str(), -1, SQLITE_TRANSIENT);
+
+                if (sqlite3_step(stmt) == SQLITE_ROW)
+                    oldSizes[i] = sqlite3_column_int64(stmt, 0);
+
+                sqlite3_reset(stmt);
+            }
+            sqlite3_finalize(stmt);
+
+            string exceeded;
+            bool maxSizeExceeded = false;
+            {
+                lock_guard<mutex> lck(mCacheLock);
+
+                // pending bytes count in full, overwrites of committed items are not looked up for every namespace
+                int64_t dirtyBytes = mDirtyBytes;
+                std::map<std::pair<string, string>, int64_t> pending;
+                for (auto it = entries.begin(); it != entries.end(); ++it)
+                {
+                    int64_t oldSize = 0;
+                    auto item = pending.find({ it->ns, it->key });
+                    if (item != pending.end())
+                        oldSize = item->second;
+                    else
+                    {
+                        auto dirtyNs = mDirty.find(it->ns);
+                        if (dirtyNs != mDirty.end())
+                        {
+                            auto dirty = dirtyNs->second.find(it->key);
+                            if (dirty != dirtyNs->second.end())
+                                oldSize = it->key.size() + dirty->second.size();
+                        }
+                    }
+
+                    int64_t newSize = it->key.size() + it->value.size();
+                    pending[{ it->ns, it->key }] = newSize;
+                    dirtyBytes += newSize - oldSize;
+                }
+
+                if (dirtyBytes > mDirtyBytes && mSize + dirtyBytes > mMaxSize)
+                {
+                    LOGWARN("max size exceeded: %lld committed, %lld pending", mSize, dirtyBytes);
+                    maxSizeExceeded = true;
+                }
+
+                // namespace sizes once the pending writes and this batch are committed
+                std::map<string, int64_t> sizes;
+                std::map<std::pair<string, string>, int64_t> staged;
+                for (size_t i = 0; i < entries.size() && !maxSizeExceeded && exceeded.empty(); i++)
+                {
+                    const Entry& entry = entries[i];
+
+                    int64_t quota = namespaceQuota(entry.ns);
+                    if (quota <= 0)
+                        continue;
+
+                    auto size = sizes.find(entry.ns);
+                    if (size == sizes.end())
+                    {
+                        auto nsSize = mNamespaceSizes.find(entry.ns);
+                        auto growth = mDirtySizes.find(entry.ns);
+                        size = sizes.emplace(entry.ns,
+                            (nsSize != mNamespaceSizes.end() ? nsSize->second : 0) +
+                            (growth != mDirtySizes.end() ? growth->second : 0)).first;
+                    }
+
+                    int64_t oldSize = oldSizes[i];
+                    auto item = staged.find({ entry.ns, entry.key });
+                    if (item != staged.end())
+                        oldSize = item->second;
+                    else
+                    {
+                        auto dirtyNs = mDirty.find(entry.ns);
+                        if (dirtyNs != mDirty.end())
+                        {
+                            auto dirty = dirtyNs->second.find(entry.key);
+                            if (dirty != dirtyNs->second.end())
+                                oldSize = entry.key.size() + dirty->second.size();
+                        }
+                    }
+
+                    int64_t newSize = entry.key.size() + entry.value.size();
+                    staged[{ entry.ns, entry.key }] = newSize;
+                    size->second += newSize - oldSize;
+
+                    if (newSize > oldSize && size->second > quota)
+                    {
+                        LOGWARN("namespace %s quota exceeded: %lld > %lld", entry.ns.c_str(), size->second, quota);
+                        exceeded = entry.ns;
+                    }
+                }
+
+                if (!maxSizeExceeded && exceeded.empty())
+                {
+                    for (auto it = entries.begin(); it != entries.end(); ++it)
+                        mDirty[it->ns][it->key] = it->value;
+                    mDirtyBytes = dirtyBytes;
+
+                    for (auto it = sizes.begin(); it != sizes.end(); ++it)
+                    {
+                        auto nsSize = mNamespaceSizes.find(it->first);
+                        mDirtySizes[it->first] = it->second - (nsSize != mNamespaceSizes.end() ? nsSize->second : 0);
+                    }
+                }
+            }
+
+            if (maxSizeExceeded)
+            {
+                JsonObject params;
+                sendNotify(C_STR(EVT_ON_STORAGE_EXCEEDED), params);
+
+                return false;
+            }
+
+            if (!exceeded.empty())
+            {
+                JsonObject params;
+                params["namespace"] = exceeded;
+                sendNotify(C_STR(EVT_ON_STORAGE_EXCEEDED), params);
+
+                return false;
+            }
+
+            for (auto it = entries.begin(); it != entries.end(); ++it)
+                cachePut(it->ns, it->key, it->value);
+
             return true;
         }
+
+        void PersistentStore::flushPending()
+        {
+            {
+                lock_guard<mutex> lck(mCacheLock);
+                if (mDirty.empty())
+                    return;
+            }
+
+            lock_guard<shared_timed_mutex> lck(mLock);
+            writePending();
+        }
+
+        void PersistentStore::writePending()
+        {
+            std::vector<Entry> entries;
+            {
+                lock_guard<mutex> lck(mCacheLock);
+                for (auto ns = mDirty.begin(); ns != mDirty.end(); ++ns)
+                {
+                    for (auto it = ns->second.begin(); it != ns->second.end(); ++it)
+                        entries.push_back({ ns->first, it->first, it->second });
+                }
+                mDirty.clear();
+                mDirtySizes.clear();
+                mDirtyBytes = 0;
+            }
+
+            if (entries.empty())
+                return;
+
+            LOGINFO("%zu", entries.size());
+
+            // over max size the batch is committed all the same, only a failed batch is retried
+            if (writeEntries(entries) == WRITE_FAILED)
+            {
+                LOGERR("ERROR writing %zu pending items, retrying one by one", entries.size());
+
+                // one namespace that fails must not cost the others their writes;
+                // the caller was told these are saved, so what still fails stays pending for the next flush
+                std::vector<Entry> failed;
+                for (auto it = entries.begin(); it != entries.end(); ++it)
+                {
+                    if (writeEntries({ *it }) == WRITE_FAILED)
+                        failed.push_back(*it);
+                }
+
+                if (!failed.empty())
+                {
+                    LOGERR("ERROR writing %zu pending items, keeping them for the next flush", failed.size());
+
+                    sqlite3* &db = SQLITE;
+
+                    for (auto it = failed.begin(); it != failed.end(); ++it)
+                    {
+                        int64_t oldSize = 0;
+                        if (db)
+                            itemSize(it->ns, it->key, oldSize);
+                        int64_t newSize = it->key.size() + it->value.size();
+
+                        lock_guard<mutex> lck(mCacheLock);
+                        mDirty[it->ns][it->key] = it->value;
+                        mDirtyBytes += newSize;
+                        if (namespaceQuota(it->ns) > 0)
+                            mDirtySizes[it->ns] += newSize - oldSize;
+                    }
+                }
+            }
+
+            lock_guard<mutex> lck(mCacheLock);
+            mCacheFlushes++;
+        }
+
+        bool PersistentStore::cacheGet(const string& ns, const string& key, string& value)
+        {
+            lock_guard<mutex> lck(mCacheLock);
+
+            auto dirtyNs = mDirty.find(ns);
+            if (dirtyNs != mDirty.end())
+            {
+                auto dirty = dirtyNs->second.find(key);
+                if (dirty != dirtyNs->second.end())
+                {
+                    value = dirty->second;
+                    mCacheHits++;
+                    return true;
+                }
+            }
+
+            auto cache = mCache.find(ns);
+            if (cache != mCache.end())
+            {
+                auto it = cache->second.index.find(key);
+                if (it != cache->second.index.end())
+                {
+                    cache->second.items.splice(cache->second.items.begin(), cache->second.items, it->second);
+                    value = it->second->second;
+                    mCacheHits++;
+                    return true;
+                }
+            }
+
+            mCacheMisses++;
+            return false;
+        }
+
+        void PersistentStore::cachePut(const string& ns, const string& key, const string& value)
+        {
+            if (mCacheSize == 0)
+                return;
+
+            lock_guard<mutex> lck(mCacheLock);
+
+            NamespaceCache& cache = mCache[ns];
+
+            auto it = cache.index.find(key);
+            if (it != cache.index.end())
+            {
+                it->second->second = value;
+                cache.items.splice(cache.items.begin(), cache.items, it->second);
+                return;
+            }
+
+            cache.items.emplace_front(key, value);
+            cache.index[key] = cache.items.begin();
+
+            if (cache.items.size() > mCacheSize)
+            {
+                cache.index.erase(cache.items.back().first);
+                cache.items.pop_back();
+                mCacheEvictions++;
+            }
+        }
+
+        void PersistentStore::cacheRemove(const string& ns, const string& key)
+        {
+            lock_guard<mutex> lck(mCacheLock);
+
+            auto dirtyNs = mDirty.find(ns);
+            if (dirtyNs != mDirty.end())
+            {
+                auto dirty = dirtyNs->second.find(key);
+                if (dirty != dirtyNs->second.end())
+                {
+                    // callers hold mLock exclusively, so the writer statements are free
+                    auto growth = mDirtySizes.find(ns);
+                    if (growth != mDirtySizes.end())
+                    {
+                        int64_t oldSize = 0;
+                        itemSize(ns, key, oldSize);
+                        int64_t newSize = key.size() + dirty->second.size();
+                        growth->second -= newSize - oldSize;
+                    }
+                    mDirtyBytes -= key.size() + dirty->second.size();
+                    dirtyNs->second.erase(dirty);
+                }
+                if (dirtyNs->second.empty())
+                    mDirty.erase(dirtyNs);
+            }
+
+            auto cache = mCache.find(ns);
+            if (cache != mCache.end())
+            {
+                auto it = cache->second.index.find(key);
+                if (it != cache->second.index.end())
+                {
+                    cache->second.items.erase(it->second);
+                    cache->second.index.erase(it);
+                }
+            }
+        }
+
+        int64_t PersistentStore::namespaceQuota(const string& ns) const
+        {
+            auto it = mQuotas.find(ns);
+            return (it != mQuotas.end()) ? it->second : mNamespaceQuota;
+        }
+
+        void PersistentStore::cacheRemove(const string& ns)
+        {
+            lock_guard<mutex> lck(mCacheLock);
+
+            auto dirtyNs = mDirty.find(ns);
+            if (dirtyNs != mDirty.end())
+            {
+                for (auto it = dirtyNs->second.begin(); it != dirtyNs->second.end(); ++it)
+                    mDirtyBytes -= it->first.size() + it->second.size();
+                mDirty.erase(dirtyNs);
+            }
+            mDirtySizes.erase(ns);
+            mCache.erase(ns);
+        }
     } // namespace Plugin
 } // namespace WPEFramework
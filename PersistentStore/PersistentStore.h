@@ -3,11 +3,16 @@
 #include "Module.h"
 #include "utils.h"
 #include "AbstractPlugin.h"
+#include "tptimer.h"
 
 #include <vector>
 #include <map>
+#include <list>
+#include <unordered_map>
 #include <mutex>
-#include <atomic>
+#include <shared_mutex>
+
+struct sqlite3_stmt;
 
 namespace WPEFramework {
 
@@ -37,6 +42,11 @@ namespace WPEFramework {
             static const string METHOD_GET_NAMESPACES;
             static const string METHOD_GET_STORAGE_SIZE;
             static const string METHOD_FLUSH_CACHE;
+            static const string METHOD_SET_VALUES;
+            static const string METHOD_GET_VALUES;
+            static const string METHOD_DELETE_KEYS;
+            static const string METHOD_GET_CACHE_STATS;
+            static const string METHOD_GET_NAMESPACE_STORAGE_USAGE;
             //events
             static const string EVT_ON_STORAGE_EXCEEDED;
             //other
@@ -56,11 +66,83 @@ namespace WPEFramework {
             uint32_t getNamespacesWrapper(const JsonObject& parameters, JsonObject& response);
             uint32_t getStorageSizeWrapper(const JsonObject& parameters, JsonObject& response);
             uint32_t flushCacheWrapper(const JsonObject& parameters, JsonObject& response);
+            uint32_t setValuesWrapper(const JsonObject& parameters, JsonObject& response);
+            uint32_t getValuesWrapper(const JsonObject& parameters, JsonObject& response);
+            uint32_t deleteKeysWrapper(const JsonObject& parameters, JsonObject& response);
+            uint32_t getCacheStatsWrapper(const JsonObject& parameters, JsonObject& response);
+            uint32_t getNamespaceStorageUsageWrapper(const JsonObject& parameters, JsonObject& response);
 
         private/*internal methods*/:
             PersistentStore(const PersistentStore&) = delete;
             PersistentStore& operator=(const PersistentStore&) = delete;
 
+            class Config : public Core::JSON::Container {
+            private:
+                Config(const Config&) = delete;
+                Config& operator=(const Config&) = delete;
+
+            public:
+                class Quota : public Core::JSON::Container {
+                public:
+                    Quota()
+                        : Core::JSON::Container()
+                    {
+                        Add(_T("namespace"), &Namespace);
+                        Add(_T("size"), &Size);
+                    }
+                    Quota(const Quota& rhs)
+                        : Core::JSON::Container()
+                        , Namespace(rhs.Namespace)
+                        , Size(rhs.Size)
+                    {
+                        Add(_T("namespace"), &Namespace);
+                        Add(_T("size"), &Size);
+                    }
+                    Quota& operator=(const Quota&) = delete;
+
+                public:
+                    Core::JSON::String Namespace;
+                    Core::JSON::DecUInt32 Size;
+                };
+
+                Config()
+                    : CacheSize(64)
+                    , WriteBehind(false)
+                    , FlushInterval(1000)
+                    , MaxSize(MAX_SIZE_BYTES)
+                    , MaxValueSize(MAX_VALUE_SIZE_BYTES)
+                    , NamespaceQuota(0)
+                {
+                    Add(_T("cachesize"), &CacheSize);
+                    Add(_T("writebehind"), &WriteBehind);
+                    Add(_T("flushinterval"), &FlushInterval);
+                    Add(_T("maxsize"), &MaxSize);
+                    Add(_T("maxvaluesize"), &MaxValueSize);
+                    Add(_T("namespacequota"), &NamespaceQuota);
+                    Add(_T("quotas"), &Quotas);
+                }
+                ~Config()
+                {
+                }
+
+            public:
+                Core::JSON::DecUInt32 CacheSize; // max cached items per namespace, 0 disables the cache
+                Core::JSON::Boolean WriteBehind; // coalesce writes in memory and commit them periodically
+                Core::JSON::DecUInt32 FlushInterval; // write-behind commit period in ms
+                Core::JSON::DecUInt32 MaxSize; // total store size in bytes
+                Core::JSON::DecUInt32 MaxValueSize; // max length of a namespace, key or value
+                Core::JSON::DecUInt32 NamespaceQuota; // default per-namespace size in bytes, 0 is unlimited
+                Core::JSON::ArrayType<Quota> Quotas; // per-namespace overrides of namespacequota
+            };
+
+            struct Entry {
+                string ns;
+                string key;
+                string value;
+            };
+
+            bool getEntries(const JsonObject& parameters, bool withValue, std::vector<Entry>& entries, string& error) const;
+
             bool setValue(const string& ns, const string& key, const string& value);
             bool getValue(const string& ns, const string& key, string& value);
             bool deleteKey(const string& ns, const string& key);
@@ -68,16 +150,75 @@ namespace WPEFramework {
             bool getKeys(const string& ns, std::vector<string>& keys);
             bool getNamespaces(std::vector<string>& namespaces);
             bool getStorageSize(std::map<string, uint64_t>& namespaceSizes);
+            bool getNamespaceStorageUsage(const string& from, uint32_t count, std::vector<std::pair<string, uint64_t>>& usage, string& next);
             bool flushCache();
+            bool setValues(const std::vector<Entry>& entries);
+            bool getValues(const std::vector<Entry>& keys, std::vector<Entry>& values);
+            bool deleteKeys(const std::vector<Entry>& keys);
 
             bool open();
             void term();
             void vacuum();
             bool init(const char* filename, const char* key = nullptr);
+            bool prepareStatements();
+            void finalizeStatements();
+            bool loadSizes();
+            int itemSize(const string& ns, const string& key, int64_t& size);
+            int insertItem(const string& ns, const string& key, const string& value);
+            enum WriteResult { WRITE_FAILED, WRITE_COMMITTED, WRITE_COMMITTED_OVER_MAX_SIZE };
+            WriteResult writeEntries(const std::vector<Entry>& entries);
+            int removeItem(const string& ns, const string& key);
+            bool commit();
+            void rollback();
+
+            bool stageEntries(const std::vector<Entry>& entries);
+            void flushPending();
+            void writePending();
+            bool cacheGet(const string& ns, const string& key, string& value);
+            void cachePut(const string& ns, const string& key, const string& value);
+            void cacheRemove(const string& ns, const string& key);
+            void cacheRemove(const string& ns);
+            int64_t namespaceQuota(const string& ns) const;
 
             void* mData;
-            std::mutex mLock;
-            std::atomic<int> mReading;
+            std::shared_timed_mutex mLock; // shared for readers, exclusive for writers
+
+            // statements used by writers only, prepared once per connection
+            sqlite3_stmt* mStmtInsertNamespace;
+            sqlite3_stmt* mStmtInsertItem;
+            sqlite3_stmt* mStmtItemSize;
+            sqlite3_stmt* mStmtDeleteItem;
+            sqlite3_stmt* mStmtDeleteNamespace;
+
+            // running totals, key+value bytes per namespace and total including namespace names
+            std::map<string, int64_t> mNamespaceSizes;
+            int64_t mSize;
+
+            // limits, from the plugin configuration
+            int64_t mMaxSize;
+            uint32_t mMaxValueSize;
+            int64_t mNamespaceQuota;
+            std::map<string, int64_t> mQuotas;
+
+            // read-through LRU cache per namespace, plus writes not yet committed in write-behind mode
+            typedef std::list<std::pair<string, string>> CacheItems;
+            struct NamespaceCache {
+                CacheItems items; // most recently used first
+                std::unordered_map<string, CacheItems::iterator> index;
+            };
+
+            std::mutex mCacheLock; // taken after mLock
+            std::unordered_map<string, NamespaceCache> mCache;
+            std::map<string, std::map<string, string>> mDirty;
+            std::map<string, int64_t> mDirtySizes; // growth mDirty adds to each namespace with a quota
+            int64_t mDirtyBytes; // key+value bytes in mDirty, counted against mMaxSize as if all were new items
+            uint32_t mCacheSize;
+            bool mWriteBehind;
+            uint64_t mCacheHits;
+            uint64_t mCacheMisses;
+            uint64_t mCacheEvictions;
+            uint64_t mCacheFlushes;
+            TpTimer mFlushTimer;
         };
     } // namespace Plugin
 } // namespace WPEFramework
@@ -0,0 +1,262 @@
+/**
+* If not stated otherwise in this file or this component's LICENSE
+* file the following copyright and licenses apply:
+*
+* Copyright 2020 RDK Management
+*
+* Licensed under the Apache License, Version 2.0 (the "License");
+* you may not use this file except in compliance with the License.
+* You may obtain a copy of the License at
+*
+* http://www.apache.org/licenses/LICENSE-2.0
+*
+* Unless required by applicable law or agreed to in writing, software
+* distributed under the License is distributed on an "AS IS" BASIS,
+* WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+* See the License for the specific language governing permissions and
+* limitations under the License.
+**/
+
+// Multi-threaded getValue/setValue latency benchmark for org.rdk.PersistentStore.
+// Every thread has its own JSON-RPC link and runs reads and writes on a shared key set, first only
+// getValue, then only setValue, then the requested mix. The latencies of each method are reported as
+// p50/p99/max over all threads, together with the CPU time the Thunder host process spent per run
+// (utime + stime from /proc/<pid>/stat), so the single method runs give the CPU cost per call.
+//
+// Usage: PersistentStoreBenchmark [threads] [operations per thread] [read percentage] [keys] [value size] [host pid]
+
+#include <dirent.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <unistd.h>
+#include <algorithm>
+#include <chrono>
+#include <random>
+#include <string>
+#include <thread>
+#include <vector>
+#include "Module.h"
+
+using namespace std;
+using namespace WPEFramework;
+
+#define CALLSIGN "org.rdk.PersistentStore.1"
+#define SERVER_DETAILS "127.0.0.1:9998"
+#define NAMESPACE_NAME "benchmark"
+#define HOST_PROCESS "WPEFramework"
+
+/* Declare module name */
+MODULE_NAME_DECLARATION(BUILD_REFERENCE)
+
+typedef JSONRPC::LinkType<Core::JSON::IElement> Link;
+
+struct Latencies {
+    vector<uint32_t> get; // microseconds
+    vector<uint32_t> set;
+    uint32_t failed = 0;
+};
+
+// CPU time (user + system) of a process in seconds, negative if it cannot be read.
+static double CpuSeconds(pid_t pid)
+{
+    double result = -1;
+    char path[64];
+    snprintf(path, sizeof(path), "/proc/%d/stat", static_cast<int>(pid));
+
+    FILE* file = fopen(path, "r");
+    if (file != nullptr) {
+        char line[1024];
+        if (fgets(line, sizeof(line), file) != nullptr) {
+            // The name in parentheses may contain spaces, the fields are counted after it
+            const char* fields = strrchr(line, ')');
+            unsigned long long utime;
+            unsigned long long stime;
+
+            if ((fields != nullptr) && (sscanf(fields + 1, " %*c %*d %*d %*d %*d %*d %*u %*u %*u %*u %*u %llu %llu", &utime, &stime) == 2)) {
+                result = static_cast<double>(utime + stime) / sysconf(_SC_CLK_TCK);
+            }
+        }
+        fclose(file);
+    }
+
+    return (result);
+}
+
+// Pid of the Thunder host process, 0 if it is not running (or runs under another name).
+static pid_t HostPid()
+{
+    pid_t result = 0;
+    DIR* dir = opendir("/proc");
+
+    if (dir != nullptr) {
+        struct dirent* entry;
+
+        while ((result == 0) && ((entry = readdir(dir)) != nullptr)) {
+            char path[300];
+            char name[64] = {};
+            snprintf(path, sizeof(path), "/proc/%s/comm", entry->d_name);
+
+            FILE* file = fopen(path, "r");
+            if (file != nullptr) {
+                if ((fgets(name, sizeof(name), file) != nullptr) && (strncmp(name, HOST_PROCESS "\n", sizeof(HOST_PROCESS)) == 0)) {
+                    result = static_cast<pid_t>(atoi(entry->d_name));
+                }
+                fclose(file);
+            }
+        }
+        closedir(dir);
+    }
+
+    return (result);
+}
+
+static string KeyName(uint32_t index)
+{
+    return ("key" + to_string(index));
+}
+
+static bool SetValue(Link& link, const string& key, const string& value)
+{
+    JsonObject params;
+    JsonObject result;
+    params["namespace"] = NAMESPACE_NAME;
+    params["key"] = key;
+    params["value"] = value;
+
+    return ((link.Invoke<JsonObject, JsonObject>(2000, _T("setValue"), params, result) == Core::ERROR_NONE) && result["success"].Boolean());
+}
+
+static bool GetValue(Link& link, const string& key)
+{
+    JsonObject params;
+    JsonObject result;
+    params["namespace"] = NAMESPACE_NAME;
+    params["key"] = key;
+
+    return ((link.Invoke<JsonObject, JsonObject>(2000, _T("getValue"), params, result) == Core::ERROR_NONE) && result["success"].Boolean());
+}
+
+static void Worker(uint32_t id, uint32_t operations, uint32_t readPercentage, uint32_t keys, const string* value, Latencies* latencies)
+{
+    Link link(_T(CALLSIGN), _T(""));
+    mt19937 random(id);
+
+    latencies->get.reserve(operations);
+    latencies->set.reserve(operations);
+
+    for (uint32_t n = 0; n < operations; n++) {
+        const string key(KeyName(random() % keys));
+        const bool read = ((random() % 100) < readPercentage);
+
+        auto start = chrono::steady_clock::now();
+        bool success = (read ? GetValue(link, key) : SetValue(link, key, *value));
+        uint32_t elapsed = static_cast<uint32_t>(chrono::duration_cast<chrono::microseconds>(chrono::steady_clock::now() - start).count());
+
+        if (success == false) {
+            latencies->failed++;
+        }
+
+        (read ? latencies->get : latencies->set).push_back(elapsed);
+    }
+}
+
+static void Report(const char name[], vector<uint32_t>& samples, double seconds)
+{
+    if (samples.empty() == true) {
+        return;
+    }
+
+    sort(samples.begin(), samples.end());
+
+    printf("  %-8s calls %7zu  %9.0f/s  p50 %6u us  p99 %6u us  max %6u us\n", name, samples.size(), samples.size() / seconds,
+        samples[samples.size() / 2], samples[(samples.size() * 99) / 100], samples.back());
+}
+
+// Runs 'operations' calls on every thread and reports the latencies and the CPU time of the host.
+static void Run(const char title[], uint32_t threads, uint32_t operations, uint32_t readPercentage, uint32_t keys, const string& value, pid_t host)
+{
+    vector<Latencies> latencies(threads);
+    vector<thread> workers;
+
+    const double cpuStart = (host != 0 ? CpuSeconds(host) : -1);
+    auto start = chrono::steady_clock::now();
+
+    for (uint32_t n = 0; n < threads; n++) {
+        workers.emplace_back(Worker, n, operations, readPercentage, keys, &value, &latencies[n]);
+    }
+    for (auto& worker : workers) {
+        worker.join();
+    }
+
+    double seconds = chrono::duration<double>(chrono::steady_clock::now() - start).count();
+    const double cpuEnd = (host != 0 ? CpuSeconds(host) : -1);
+
+    Latencies total;
+    for (auto& entry : latencies) {
+        total.get.insert(total.get.end(), entry.get.begin(), entry.get.end());
+        total.set.insert(total.set.end(), entry.set.begin(), entry.set.end());
+        total.failed += entry.failed;
+    }
+
+    printf("%s, %.2f s, %u failed\n", title, seconds, total.failed);
+    Report("getValue", total.get, seconds);
+    Report("setValue", total.set, seconds);
+
+    if ((cpuStart >= 0) && (cpuEnd >= 0)) {
+        const double cpu = cpuEnd - cpuStart;
+        const size_t calls = total.get.size() + total.set.size();
+
+        printf("  host cpu %.2f s  %5.1f%% of a core  %6.1f us/call\n", cpu, (cpu * 100) / seconds, (cpu * 1000000) / calls);
+    }
+}
+
+int main(int argc, char** argv)
+{
+    const uint32_t threads = (argc > 1 ? max(1, atoi(argv[1])) : 4);
+    const uint32_t operations = (argc > 2 ? max(1, atoi(argv[2])) : 1000);
+    const uint32_t readPercentage = (argc > 3 ? min(100, max(0, atoi(argv[3]))) : 80);
+    const uint32_t keys = (argc > 4 ? max(1, atoi(argv[4])) : 100);
+    const string value((argc > 5 ? max(1, atoi(argv[5])) : 64), 'x');
+    const pid_t host = (argc > 6 ? static_cast<pid_t>(atoi(argv[6])) : HostPid());
+
+    Core::SystemInfo::SetEnvironment(_T("THUNDER_ACCESS"), (_T(SERVER_DETAILS)));
+
+    printf("%u threads x %u operations, %u%% reads, %u keys, %zu byte values\n", threads, operations, readPercentage, keys, value.size());
+
+    if ((host == 0) || (CpuSeconds(host) < 0)) {
+        printf("%s not found, pass its pid to report the host cpu usage\n", HOST_PROCESS);
+    }
+
+    // Every key exists, so reads measure hits
+    {
+        Link link(_T(CALLSIGN), _T(""));
+
+        for (uint32_t n = 0; n < keys; n++) {
+            if (SetValue(link, KeyName(n), value) == false) {
+                printf("setValue failed, is %s activated?\n", CALLSIGN);
+                return (1);
+            }
+        }
+    }
+
+    // The single method runs attribute the host cpu time to one method
+    Run("getValue only", threads, operations, 100, keys, value, host);
+    Run("setValue only", threads, operations, 0, keys, value, host);
+
+    const string mix(to_string(readPercentage) + "% reads");
+    Run(mix.c_str(), threads, operations, readPercentage, keys, value, host);
+
+    // Leave the store as it was
+    {
+        Link link(_T(CALLSIGN), _T(""));
+        JsonObject params;
+        JsonObject result;
+        params["namespace"] = NAMESPACE_NAME;
+        link.Invoke<JsonObject, JsonObject>(2000, _T("deleteNamespace"), params, result);
+    }
+
+    Core::Singleton::Dispose();
+
+    return (0);
+}
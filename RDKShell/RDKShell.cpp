@@ -22,10 +22,13 @@
 #include <iostream>
 #include <mutex>
 #include <thread>
+#include <condition_variable>
+#include <atomic>
 #include <fstream>
 #include <sstream>
 #include <unistd.h>
 #include <memory>
+#include <algorithm>
 #include <rdkshell/compositorcontroller.h>
 #include <rdkshell/application.h>
 #include <rdkshell/logger.h>
@@ -102,6 +105,11 @@ const string WPEFramework::Plugin::RDKShell::RDKSHELL_METHOD_GET_VIRTUAL_DISPLAY
 const string WPEFramework::Plugin::RDKShell::RDKSHELL_METHOD_GET_LAST_WAKEUP_KEY = "getLastWakeupKey";
 const string WPEFramework::Plugin::RDKShell::RDKSHELL_METHOD_ENABLE_LOGS_FLUSHING = "enableLogsFlushing";
 const string WPEFramework::Plugin::RDKShell::RDKSHELL_METHOD_GET_LOGS_FLUSHING_ENABLED = "getLogsFlushingEnabled";
+const string WPEFramework::Plugin::RDKShell::RDKSHELL_METHOD_SET_WARM_POOL = "setWarmPool";
+const string WPEFramework::Plugin::RDKShell::RDKSHELL_METHOD_GET_WARM_POOL = "getWarmPool";
+const string WPEFramework::Plugin::RDKShell::RDKSHELL_METHOD_BATCH = "batch";
+const string WPEFramework::Plugin::RDKShell::RDKSHELL_METHOD_GET_FRAME_STATS = "getFrameStats";
+const string WPEFramework::Plugin::RDKShell::RDKSHELL_METHOD_ENABLE_FRAME_STATS_EVENT = "enableFrameStatsEvent";
 
 const string WPEFramework::Plugin::RDKShell::RDKSHELL_EVENT_ON_USER_INACTIVITY = "onUserInactivity";
 const string WPEFramework::Plugin::RDKShell::RDKSHELL_EVENT_ON_APP_LAUNCHED = "onApplicationLaunched";
@@ -121,6 +129,7 @@ const string WPEFramework::Plugin::RDKShell::RDKSHELL_EVENT_DEVICE_LOW_RAM_WARNI
 const string WPEFramework::Plugin::RDKShell::RDKSHELL_EVENT_DEVICE_CRITICALLY_LOW_RAM_WARNING_CLEARED = "onDeviceCriticallyLowRamWarningCleared";
 const string WPEFramework::Plugin::RDKShell::RDKSHELL_EVENT_ON_EASTER_EGG = "onEasterEgg";
 const string WPEFramework::Plugin::RDKShell::RDKSHELL_EVENT_ON_WILL_DESTROY = "onWillDestroy";
+const string WPEFramework::Plugin::RDKShell::RDKSHELL_EVENT_ON_FRAME_STATS = "onFrameStats";
 
 using namespace std;
 using namespace RdkShell;
@@ -151,6 +160,8 @@ static bool sRunning = true;
 #define THUNDER_ACCESS_DEFAULT_VALUE "127.0.0.1:9998"
 #define RDKSHELL_WILLDESTROY_EVENT_WAITTIME 1
 #define RDKSHELL_TRY_LOCK_WAIT_TIME_IN_MS 250
+#define RDKSHELL_FRAME_STATS_SIZE 1024
+#define RDKSHELL_FRAME_STATS_EVENT_DEFAULT_INTERVAL_IN_MS 10000
 
 static std::string gThunderAccessValue = THUNDER_ACCESS_DEFAULT_VALUE;
 static uint32_t gWillDestroyEventWaitTime = RDKSHELL_WILLDESTROY_EVENT_WAITTIME;
@@ -342,11 +353,101 @@ namespace WPEFramework {
             JsonObject params;
         };
 
+        // one compositor operation of a batch request, decoded before the lock is taken
+        struct RDKShellBatchCommand
+        {
+            std::string method;
+            std::string client;
+            std::string target;
+            bool hasX, hasY, hasW, hasH;
+            unsigned int x, y, w, h;
+            bool hasScaleX, hasScaleY;
+            double scaleX, scaleY;
+            unsigned int opacity;
+            bool enable;
+            bool result;
+            std::string message;
+        };
+
         std::map<std::string, PluginData> gActivePluginsData;
         std::map<std::string, PluginStateChangeData*> gPluginsEventListener;
         std::vector<RDKShellStartupConfig> gStartupConfigs;
         std::map<std::string, bool> gDestroyApplications;
         std::map<std::string, bool> gLaunchApplications;
+
+        // apps kept activated, suspended and hidden so that a launch only needs a resume
+        enum WarmPoolState
+        {
+            WARM_POOL_IDLE,
+            WARM_POOL_WARMING,
+            WARM_POOL_WARM,
+            WARM_POOL_IN_USE
+        };
+
+        struct WarmPoolEntry
+        {
+            std::string type;
+            std::string uri;
+            WarmPoolState state;
+        };
+
+        std::mutex gWarmPoolMutex;
+        std::map<std::string, WarmPoolEntry> gWarmPool;
+        bool gWarmPoolLowRam = false;
+
+        // fills and shrinks run on one worker thread that is joined on deinitialize, requests made while it is busy are merged
+        enum WarmPoolTask
+        {
+            WARM_POOL_TASK_FILL = 0x01,
+            WARM_POOL_TASK_SHRINK = 0x02,
+            WARM_POOL_TASK_SHRINK_CRITICAL = 0x04
+        };
+
+        static std::thread sWarmPoolThread;
+        static std::condition_variable sWarmPoolCondition;
+        static uint32_t sWarmPoolTasks = 0;
+        static bool sWarmPoolRunning = false;
+
+        void scheduleWarmPoolTask(WarmPoolTask task)
+        {
+            gWarmPoolMutex.lock();
+            if (sWarmPoolRunning)
+            {
+                sWarmPoolTasks |= task;
+                sWarmPoolCondition.notify_one();
+            }
+            gWarmPoolMutex.unlock();
+        }
+
+        const char* warmPoolStateString(WarmPoolState state)
+        {
+            switch (state)
+            {
+                case WARM_POOL_WARMING:
+                    return "warming";
+                case WARM_POOL_WARM:
+                    return "warm";
+                case WARM_POOL_IN_USE:
+                    return "inuse";
+                default:
+                    return "idle";
+            }
+        }
+
+        void warmPoolLaunchCompleted(const std::string& callsign, bool warmPoolLaunch, bool result)
+        {
+            if (!warmPoolLaunch)
+            {
+                return;
+            }
+            gWarmPoolMutex.lock();
+            std::map<std::string, WarmPoolEntry>::iterator warmPoolEntry = gWarmPool.find(callsign);
+            if ((warmPoolEntry != gWarmPool.end()) && (warmPoolEntry->second.state == WARM_POOL_WARMING))
+            {
+                warmPoolEntry->second.state = result ? WARM_POOL_WARM : WARM_POOL_IDLE;
+            }
+            gWarmPoolMutex.unlock();
+        }
         
         uint32_t getKeyFlag(std::string modifier)
         {
@@ -369,23 +470,109 @@ namespace WPEFramework {
         SERVICE_REGISTRATION(RDKShell, 1, 0);
 
         RDKShell* RDKShell::_instance = nullptr;
-        std::mutex gRdkShellMutex;
+        std::timed_mutex gRdkShellMutex;
         std::mutex gPluginDataMutex;
         std::mutex gLaunchDestroyMutex;
 
-        std::mutex gLaunchMutex;
-        int32_t gLaunchCount = 0;
-
         static std::thread shellThread;
 
-        void lockRdkShellMutex()
+        // frame timing written by the render thread only; each slot packs the draw+update time (low 32 bits)
+        // and the interval since the previous frame (high 32 bits) in microseconds so readers never see a torn sample
+        static std::atomic<uint64_t> sFrameStats[RDKSHELL_FRAME_STATS_SIZE];
+        static std::atomic<uint64_t> sFrameStatsCount(0);
+        static std::atomic<uint64_t> sMissedFrames(0);
+        static std::atomic<uint32_t> sFrameTargetTime(0);
+        static std::atomic<bool> sFrameStatsEventEnabled(false);
+        static std::atomic<uint32_t> sFrameStatsEventInterval(RDKSHELL_FRAME_STATS_EVENT_DEFAULT_INTERVAL_IN_MS);
+
+        void recordFrameStats(uint32_t renderTime, uint32_t frameInterval, uint32_t targetTime)
+        {
+            uint64_t index = sFrameStatsCount.load(std::memory_order_relaxed);
+            sFrameStats[index % RDKSHELL_FRAME_STATS_SIZE].store(((uint64_t)frameInterval << 32) | renderTime, std::memory_order_relaxed);
+            sFrameStatsCount.store(index + 1, std::memory_order_release);
+            sFrameTargetTime.store(targetTime, std::memory_order_relaxed);
+            if ((targetTime > 0) && (frameInterval > targetTime + targetTime / 2))
+            {
+                sMissedFrames.fetch_add((frameInterval - targetTime / 2) / targetTime, std::memory_order_relaxed);
+            }
+        }
+
+        JsonObject frameTimeHistogram(const std::vector<uint32_t>& times)
+        {
+            static const uint32_t bucketLimits[] = { 4000, 8000, 16000, 33000, 50000, 100000 };
+            static const char* bucketNames[] = { "0-4", "4-8", "8-16", "16-33", "33-50", "50-100", "100+" };
+            const size_t bucketCount = sizeof(bucketLimits) / sizeof(bucketLimits[0]);
+            uint32_t buckets[bucketCount + 1] = {};
+            uint64_t total = 0;
+            for (size_t i = 0; i < times.size(); i++)
+            {
+                size_t bucket = 0;
+                while ((bucket < bucketCount) && (times[i] >= bucketLimits[bucket]))
+                {
+                    bucket++;
+                }
+                buckets[bucket]++;
+                total += times[i];
+            }
+            std::vector<uint32_t> sortedTimes(times);
+            std::sort(sortedTimes.begin(), sortedTimes.end());
+
+            JsonObject histogram;
+            for (size_t i = 0; i <= bucketCount; i++)
+            {
+                histogram[bucketNames[i]] = buckets[i];
+            }
+            JsonObject stats;
+            stats["average"] = sortedTimes.empty() ? 0 : (uint32_t)(total / sortedTimes.size());
+            stats["p95"] = sortedTimes.empty() ? 0 : sortedTimes[(sortedTimes.size() * 95) / 100];
+            stats["max"] = sortedTimes.empty() ? 0 : sortedTimes.back();
+            stats["histogram"] = histogram;
+            return stats;
+        }
+
+        void getFrameStats(JsonObject& stats, uint32_t frames)
         {
-            bool lockAcquired = false;
-            double startTime = RdkShell::milliseconds();
-            while (!lockAcquired && (RdkShell::milliseconds() - startTime) < RDKSHELL_TRY_LOCK_WAIT_TIME_IN_MS)
+            uint64_t count = sFrameStatsCount.load(std::memory_order_acquire);
+            uint64_t available = std::min<uint64_t>(count, RDKSHELL_FRAME_STATS_SIZE - 1);
+            if ((frames == 0) || (frames > available))
+            {
+                frames = available;
+            }
+            std::vector<uint32_t> renderTimes;
+            std::vector<uint32_t> frameIntervals;
+            renderTimes.reserve(frames);
+            frameIntervals.reserve(frames);
+            for (uint64_t i = count - frames; i < count; i++)
             {
-                lockAcquired = gRdkShellMutex.try_lock();
+                uint64_t sample = sFrameStats[i % RDKSHELL_FRAME_STATS_SIZE].load(std::memory_order_relaxed);
+                renderTimes.push_back((uint32_t)(sample & 0xFFFFFFFF));
+                frameIntervals.push_back((uint32_t)(sample >> 32));
+            }
+            uint32_t targetTime = sFrameTargetTime.load(std::memory_order_relaxed);
+            uint32_t lateFrames = 0;
+            uint64_t totalInterval = 0;
+            for (size_t i = 0; i < frameIntervals.size(); i++)
+            {
+                totalInterval += frameIntervals[i];
+                if ((targetTime > 0) && (frameIntervals[i] > targetTime + targetTime / 2))
+                {
+                    lateFrames++;
+                }
             }
+            stats["frames"] = frames;
+            stats["totalFrames"] = count;
+            stats["missedFrames"] = sMissedFrames.load(std::memory_order_relaxed);
+            stats["lateFrames"] = lateFrames;
+            stats["targetFrameTime"] = targetTime;
+            stats["fps"] = (totalInterval > 0) ? (uint32_t)((frames * 1000000ULL) / totalInterval) : 0;
+            stats["renderTime"] = frameTimeHistogram(renderTimes);
+            stats["frameInterval"] = frameTimeHistogram(frameIntervals);
+        }
+
+        void lockRdkShellMutex()
+        {
+            // sleeps on the mutex instead of spinning on try_lock while the render loop holds it
+            bool lockAcquired = gRdkShellMutex.try_lock_for(std::chrono::milliseconds(RDKSHELL_TRY_LOCK_WAIT_TIME_IN_MS));
             if (!lockAcquired)
             {
                 std::cout << "unable to get lock for defaulting to normal lock\n";
@@ -486,6 +673,11 @@ namespace WPEFramework {
                             }
                         }
                     }
+                    if (!sFactoryModeStart)
+                    {
+                        // home screen is up, pre-launch the warm pool behind it
+                        scheduleWarmPoolTask(WARM_POOL_TASK_FILL);
+                    }
                 }
                 else if (currentState == PluginHost::IShell::ACTIVATED && service->Callsign() == PERSISTENT_STORE_CALLSIGN && !sPersistentStoreFirstActivated)
                 {
@@ -518,6 +710,14 @@ namespace WPEFramework {
                 }
                 else if (currentState == PluginHost::IShell::DEACTIVATED)
                 {
+                    gWarmPoolMutex.lock();
+                    std::map<std::string, WarmPoolEntry>::iterator warmPoolEntry = gWarmPool.find(service->Callsign());
+                    if ((warmPoolEntry != gWarmPool.end()) && (warmPoolEntry->second.state != WARM_POOL_WARMING))
+                    {
+                        warmPoolEntry->second.state = WARM_POOL_IDLE;
+                    }
+                    gWarmPoolMutex.unlock();
+
                     std::string configLine = service->ConfigLine();
                     if (configLine.empty())
                     {
@@ -628,6 +828,11 @@ namespace WPEFramework {
             registerMethod(RDKSHELL_METHOD_GET_LAST_WAKEUP_KEY, &RDKShell::getLastWakeupKeyWrapper, this);            
             registerMethod(RDKSHELL_METHOD_ENABLE_LOGS_FLUSHING, &RDKShell::enableLogsFlushingWrapper, this);
             registerMethod(RDKSHELL_METHOD_GET_LOGS_FLUSHING_ENABLED, &RDKShell::getLogsFlushingEnabledWrapper, this);
+            registerMethod(RDKSHELL_METHOD_SET_WARM_POOL, &RDKShell::setWarmPoolWrapper, this);
+            registerMethod(RDKSHELL_METHOD_GET_WARM_POOL, &RDKShell::getWarmPoolWrapper, this);
+            registerMethod(RDKSHELL_METHOD_BATCH, &RDKShell::batchWrapper, this);
+            registerMethod(RDKSHELL_METHOD_GET_FRAME_STATS, &RDKShell::getFrameStatsWrapper, this);
+            registerMethod(RDKSHELL_METHOD_ENABLE_FRAME_STATS_EVENT, &RDKShell::enableFrameStatsEventWrapper, this);
         }
 
         RDKShell::~RDKShell()
@@ -767,6 +972,8 @@ namespace WPEFramework {
                 isRunning = sRunning;
                 gRdkShellMutex.unlock();
                 gRdkShellSurfaceModeEnabled = CompositorController::isSurfaceModeEnabled();
+                double previousFrameTime = RdkShell::microseconds();
+                double lastFrameStatsEventTime = previousFrameTime;
                 while(isRunning) {
                   const double maxSleepTime = (1000 / gCurrentFramerate) * 1000;
                   double startFrameTime = RdkShell::microseconds();
@@ -849,10 +1056,25 @@ namespace WPEFramework {
                         std::cout << "not launching factory app as conditions not matched\n";
                     }
                   }
+                  double startRenderTime = RdkShell::microseconds();
                   RdkShell::draw();
                   RdkShell::update();
                   isRunning = sRunning;
                   gRdkShellMutex.unlock();
+                  double endFrameTime = RdkShell::microseconds();
+                  recordFrameStats((uint32_t)(endFrameTime - startRenderTime), (uint32_t)(startFrameTime - previousFrameTime), (uint32_t)maxSleepTime);
+                  previousFrameTime = startFrameTime;
+                  if (sFrameStatsEventEnabled && ((endFrameTime - lastFrameStatsEventTime) / 1000 >= sFrameStatsEventInterval))
+                  {
+                      lastFrameStatsEventTime = endFrameTime;
+                      RDKShell* rdkshellPlugin = RDKShell::_instance;
+                      if (nullptr != rdkshellPlugin)
+                      {
+                          JsonObject frameStats;
+                          getFrameStats(frameStats, 0);
+                          rdkshellPlugin->notify(RDKShell::RDKSHELL_EVENT_ON_FRAME_STATS, frameStats);
+                      }
+                  }
                   double frameTime = (int)RdkShell::microseconds() - (int)startFrameTime;
                   if (frameTime < maxSleepTime)
                   {
@@ -870,6 +1092,13 @@ namespace WPEFramework {
             }
             loadStartupConfig();
             invokeStartupThunderApis();
+            loadWarmPoolConfig();
+            gWarmPoolMutex.lock();
+            sWarmPoolRunning = true;
+            sWarmPoolTasks = 0;
+            gWarmPoolMutex.unlock();
+            RDKShell* rdkshellPlugin = this;
+            sWarmPoolThread = std::thread([rdkshellPlugin]() { rdkshellPlugin->runWarmPoolTasks(); });
             char* willDestroyWaitTimeValue = getenv("RDKSHELL_WILLDESTROY_EVENT_WAITTIME");
             if (NULL != willDestroyWaitTimeValue)
             {
@@ -1020,6 +1249,14 @@ namespace WPEFramework {
         void RDKShell::Deinitialize(PluginHost::IShell* service)
         {
             LOGINFO("Deinitialize");
+            gWarmPoolMutex.lock();
+            sWarmPoolRunning = false;
+            sWarmPoolCondition.notify_one();
+            gWarmPoolMutex.unlock();
+            if (sWarmPoolThread.joinable())
+            {
+                sWarmPoolThread.join();
+            }
             gRdkShellMutex.lock();
             sRunning = false;
             gRdkShellMutex.unlock();
@@ -1161,6 +1398,9 @@ namespace WPEFramework {
           JsonObject params;
           params["minutes"] = std::to_string(minutes);
           mShell.notify(RDKSHELL_EVENT_ON_USER_INACTIVITY, params);
+
+          // listener callbacks run on the compositor thread with gRdkShellMutex held, so launch from another thread
+          scheduleWarmPoolTask(WARM_POOL_TASK_FILL);
         }
 
         void RDKShell::RdkShellListener::onDeviceLowRamWarning(const int32_t freeKb)
@@ -1169,6 +1409,8 @@ namespace WPEFramework {
           JsonObject params;
           params["ram"] = freeKb;
           mShell.notify(RDKSHELL_EVENT_DEVICE_LOW_RAM_WARNING, params);
+
+          scheduleWarmPoolTask(WARM_POOL_TASK_SHRINK);
         }
 
         void RDKShell::RdkShellListener::onDeviceCriticallyLowRamWarning(const int32_t freeKb)
@@ -1177,6 +1419,8 @@ namespace WPEFramework {
           JsonObject params;
           params["ram"] = freeKb;
           mShell.notify(RDKSHELL_EVENT_DEVICE_CRITICALLY_LOW_RAM_WARNING, params);
+
+          scheduleWarmPoolTask(WARM_POOL_TASK_SHRINK_CRITICAL);
         }
 
         void RDKShell::RdkShellListener::onDeviceLowRamWarningCleared(const int32_t freeKb)
@@ -1185,6 +1429,11 @@ namespace WPEFramework {
           JsonObject params;
           params["ram"] = freeKb;
           mShell.notify(RDKSHELL_EVENT_DEVICE_LOW_RAM_WARNING_CLEARED, params);
+
+          // the pool is refilled on the next user inactivity
+          gWarmPoolMutex.lock();
+          gWarmPoolLowRam = false;
+          gWarmPoolMutex.unlock();
         }
 
         void RDKShell::RdkShellListener::onDeviceCriticallyLowRamWarningCleared(const int32_t freeKb)
@@ -2550,36 +2799,26 @@ namespace WPEFramework {
             }
 
             const string appCallsign = parameters["callsign"].String();
-            if (result)
+            if (!result)
             {
-                bool launchInProgress = false;
-                int32_t currentLaunchCount = 0;
-                gLaunchMutex.lock();
-                if (gLaunchCount > 0)
-                {
-                    launchInProgress = true;
-                }
-                else
-                {
-                    gLaunchCount++;
-                }
-                currentLaunchCount = gLaunchCount;
-                gLaunchMutex.unlock();
-                std::cout << "the current launch count is " << currentLaunchCount << std::endl;
-                if (launchInProgress)
-                {
-                    std::cout << "launch is in progress.  not able to launch another app: " << appCallsign << std::endl;
-                    response["message"] = "failed to launch application.  another launch is in progress";
-                    returnResponse(false);
-                }
+                returnResponse(false);
             }
 
+            // pre-launches are marked by fillWarmPool, the pool entry state alone cannot tell them from a user launch
+            const bool warmPoolLaunch = parameters.HasLabel("warmpool") && parameters["warmpool"].Boolean();
+
+            // launches of different applications run concurrently, only a second launch of the same callsign is rejected
             bool isApplicationBeingDestroyed = false;
+            bool isApplicationBeingLaunched = false;
             gLaunchDestroyMutex.lock();
             if (gDestroyApplications.find(appCallsign) != gDestroyApplications.end())
             {
                 isApplicationBeingDestroyed = true;
             }
+            else if (gLaunchApplications.find(appCallsign) != gLaunchApplications.end())
+            {
+                isApplicationBeingLaunched = true;
+            }
             else
             {
                 gLaunchApplications[appCallsign] = true;
@@ -2587,12 +2826,52 @@ namespace WPEFramework {
             gLaunchDestroyMutex.unlock();
             if (isApplicationBeingDestroyed)
 	    {
-                gLaunchMutex.lock();
-                gLaunchCount = 0;
-                gLaunchMutex.unlock();
                 response["message"] = "failed to launch application due to active destroy request";
+                warmPoolLaunchCompleted(appCallsign, warmPoolLaunch, false);
 	        returnResponse(false);
 	    }
+            if (isApplicationBeingLaunched)
+            {
+                std::cout << "launch is in progress.  not able to launch app again: " << appCallsign << std::endl;
+                response["message"] = "failed to launch application.  another launch of this application is in progress";
+                warmPoolLaunchCompleted(appCallsign, warmPoolLaunch, false);
+                returnResponse(false);
+            }
+
+            // a user launch of a pooled app takes it out of the pool, a pre-launch only goes ahead while its entry is still warming
+            bool warmPoolEntryTaken = false;
+            gWarmPoolMutex.lock();
+            std::map<std::string, WarmPoolEntry>::iterator warmPoolEntry = gWarmPool.find(appCallsign);
+            if (warmPoolLaunch)
+            {
+                warmPoolEntryTaken = ((warmPoolEntry == gWarmPool.end()) || (warmPoolEntry->second.state != WARM_POOL_WARMING));
+            }
+            else if (warmPoolEntry != gWarmPool.end())
+            {
+                if (warmPoolEntry->second.state == WARM_POOL_WARM)
+                {
+                    std::cout << "launching " << appCallsign << " from the warm pool\n";
+                }
+                warmPoolEntry->second.state = WARM_POOL_IN_USE;
+            }
+            gWarmPoolMutex.unlock();
+            if (warmPoolEntryTaken)
+            {
+                std::cout << "skipping the warm pool pre-launch of " << appCallsign << ", it is no longer pooled\n";
+                response["message"] = "failed to launch application.  the warm pool entry is no longer warming";
+                gLaunchDestroyMutex.lock();
+                gLaunchApplications.erase(appCallsign);
+                gLaunchDestroyMutex.unlock();
+                returnResponse(false);
+            }
+
+            JsonObject launchTimings;
+            double stageStartTime = launchStartTime;
+            auto endLaunchStage = [&launchTimings, &stageStartTime](const char* stage) {
+                double now = RdkShell::seconds();
+                launchTimings[stage] = JsonValue(static_cast<int>((now - stageStartTime) * 1000));
+                stageStartTime = now;
+            };
             if (result)
             {
                 RDKShellLaunchType launchType = RDKShellLaunchType::UNKNOWN;
@@ -2678,31 +2957,13 @@ namespace WPEFramework {
                     if (topmost)
                     {
                         std::string topmostClient;
-                        {
-                            bool lockAcquired = false;
-                            double startTime = RdkShell::milliseconds();
-                            while (!lockAcquired && (RdkShell::milliseconds() - startTime) < RDKSHELL_TRY_LOCK_WAIT_TIME_IN_MS)
-                            {
-                                lockAcquired = gRdkShellMutex.try_lock();
-                            }
-                            if (!lockAcquired)
-                            {
-                                std::cout << "unable to get lock for topmost, defaulting to normal lock\n";
-                                gRdkShellMutex.lock();
-                            }
-                            else
-                            {
-                                std::cout << "lock was acquired via try for topmost\n";
-                            }
-                        }
+                        lockRdkShellMutex();
                         bool topmostResult =  CompositorController::getTopmost(topmostClient);
                         gRdkShellMutex.unlock();
                         if (!topmostClient.empty())
                         {
                             response["message"] = "failed to launch application.  topmost application already present";
-                            gLaunchMutex.lock();
-                            gLaunchCount = 0;
-                            gLaunchMutex.unlock();
+                            warmPoolLaunchCompleted(appCallsign, warmPoolLaunch, false);
 		            gLaunchDestroyMutex.lock();
                             gLaunchApplications.erase(appCallsign);
 		            gLaunchDestroyMutex.unlock();
@@ -2715,6 +2976,7 @@ namespace WPEFramework {
                 bool newPluginFound = false;
                 bool originalPluginFound = false;
                 std::vector<std::string> foundTypes;
+                gPluginDataMutex.lock();
                 for (std::map<std::string, PluginData>::iterator pluginDataEntry = gActivePluginsData.begin(); pluginDataEntry != gActivePluginsData.end(); pluginDataEntry++)
                 {
                     std::string pluginName = pluginDataEntry->first; 
@@ -2728,6 +2990,7 @@ namespace WPEFramework {
                       originalPluginFound = true;
                     }
                 }
+                gPluginDataMutex.unlock();
                 auto thunderController = std::unique_ptr<JSONRPCDirectLink>(new JSONRPCDirectLink(mCurrentService));
                 //auto thunderController = getThunderControllerClient();
                 if ((false == newPluginFound) && (false == originalPluginFound))
@@ -2770,13 +3033,10 @@ namespace WPEFramework {
                     }
                     std::cout << "number of types found: " << foundTypes.size() << std::endl;
                     response["message"] = "failed to launch application.  type not found";
-                    gLaunchMutex.lock();
-                    gLaunchCount = 0;
-                    gLaunchMutex.unlock();
+                    warmPoolLaunchCompleted(appCallsign, warmPoolLaunch, false);
 		    gLaunchDestroyMutex.lock();
                     gLaunchApplications.erase(appCallsign);
 		    gLaunchDestroyMutex.unlock();
-                    std::cout << "new launch count loc1: 0\n";
                     returnResponse(false);
                 }
                 else if (!newPluginFound)
@@ -2805,26 +3065,11 @@ namespace WPEFramework {
                     joParams.ToString(strParams);
                     joResult.ToString(strResult);
                     launchType = RDKShellLaunchType::CREATE;
-                    {
-                        bool lockAcquired = false;
-                        double startTime = RdkShell::milliseconds();
-                        while (!lockAcquired && (RdkShell::milliseconds() - startTime) < RDKSHELL_TRY_LOCK_WAIT_TIME_IN_MS)
-                        {
-                            lockAcquired = gRdkShellMutex.try_lock();
-                        }
-                        if (!lockAcquired)
-                        {
-                            std::cout << "unable to get lock for create display, defaulting to normal lock\n";
-                            gRdkShellMutex.lock();
-                        }
-                        else
-                        {
-                            std::cout << "lock was acquired via try for create display\n";
-                        }
-                    }
+                    lockRdkShellMutex();
                     RdkShell::CompositorController::createDisplay(callsign, displayName, width, height);
                     gRdkShellMutex.unlock();
                 }
+                endLaunchStage("create");
 
                 WPEFramework::Core::JSON::String configString;
 
@@ -2885,6 +3130,7 @@ namespace WPEFramework {
                     status = thunderController->Set<JsonObject>(RDKSHELL_THUNDER_TIMEOUT, method.c_str(), configSet);
                     std::cout << "set status: " << status << std::endl;
                 }
+                endLaunchStage("configure");
 
                 if (launchType == RDKShellLaunchType::UNKNOWN)
                 {
@@ -2958,6 +3204,8 @@ namespace WPEFramework {
                     }
                 }
 
+                endLaunchStage("activate");
+
                 bool deferLaunch = false;
                 if (status > 0)
                 {
@@ -2970,23 +3218,7 @@ namespace WPEFramework {
                     uint32_t tempY = 0;
                     uint32_t screenWidth = 0;
                     uint32_t screenHeight = 0;
-                    {
-                        bool lockAcquired = false;
-                        double startTime = RdkShell::milliseconds();
-                        while (!lockAcquired && (RdkShell::milliseconds() - startTime) < RDKSHELL_TRY_LOCK_WAIT_TIME_IN_MS)
-                        {
-                            lockAcquired = gRdkShellMutex.try_lock();
-                        }
-                        if (!lockAcquired)
-                        {
-                            std::cout << "unable to get lock for get bounds, defaulting to normal lock\n";
-                            gRdkShellMutex.lock();
-                        }
-                        else
-                        {
-                            std::cout << "lock was acquired via try for get bounds\n";
-                        }
-                    }
+                    lockRdkShellMutex();
                     CompositorController::getBounds(callsign, tempX, tempY, screenWidth, screenHeight);
                     gRdkShellMutex.unlock();
                     width = screenWidth;
@@ -3007,23 +3239,7 @@ namespace WPEFramework {
                     {
                         height = parameters["h"].Number();
                     }
-                    {
-                        bool lockAcquired = false;
-                        double startTime = RdkShell::milliseconds();
-                        while (!lockAcquired && (RdkShell::milliseconds() - startTime) < RDKSHELL_TRY_LOCK_WAIT_TIME_IN_MS)
-                        {
-                            lockAcquired = gRdkShellMutex.try_lock();
-                        }
-                        if (!lockAcquired)
-                        {
-                            std::cout << "unable to get lock for set bounds, defaulting to normal lock\n";
-                            gRdkShellMutex.lock();
-                        }
-                        else
-                        {
-                            std::cout << "lock was acquired via try for set bounds\n";
-                        }
-                    }
+                    lockRdkShellMutex();
                     std::cout << "setting the desired bounds\n";
                     CompositorController::setBounds(callsign, 0, 0, 1, 1); //forcing a compositor resize flush
                     CompositorController::setBounds(callsign, x, y, width, height);
@@ -3055,6 +3271,7 @@ namespace WPEFramework {
                             std::cout << "unable to move behind " << behind << std::endl;
                         }
                     }
+                    endLaunchStage("bounds");
 
                     gPluginDataMutex.lock();
                     {
@@ -3122,6 +3339,7 @@ namespace WPEFramework {
                             std::cout << "setting the state to resumed\n";
                         }
                     }
+                    endLaunchStage("state");
 
                     setVisibility(callsign, visible);
                     setHolePunch(callsign, holePunch);
@@ -3136,6 +3354,7 @@ namespace WPEFramework {
                     }
 
                     bool setTopmostResult = setTopmost(callsign, topmost);
+                    endLaunchStage("visibility");
                     JsonObject urlResult;
                     if (!uri.empty())
                     {
@@ -3147,6 +3366,7 @@ namespace WPEFramework {
                             std::cout << "failed to set url to " << uri << " with status code " << status << std::endl;
                         }
                     }
+                    endLaunchStage("url");
                 }
 
                 if (status > 0 || !result)
@@ -3174,19 +3394,22 @@ namespace WPEFramework {
                             launchTypeString = "unknown";
                             break;
                     }
+                    launchTimings["total"] = JsonValue(static_cast<int>((RdkShell::seconds() - launchStartTime) * 1000));
                     std::cout << "Application:" << callsign << " took " << (RdkShell::seconds() - launchStartTime)*1000 << " milliseconds to launch " << std::endl;
-                    gLaunchMutex.lock();
-                    gLaunchCount = 0;
-                    gLaunchMutex.unlock();
                     if (setSuspendResumeStateOnLaunch && deferLaunch && ((launchType == SUSPEND) || (launchType == RESUME)))
                     {
                         std::cout << "deferring application launch " << std::endl;
                     }
+                    else if (warmPoolLaunch)
+                    {
+                        std::cout << "pre-launched " << callsign << " into the warm pool\n";
+                    }
                     else
                     {
-                        onLaunched(callsign, launchTypeString);
+                        onLaunched(callsign, launchTypeString, launchTimings);
                     }
                     response["launchType"] = launchTypeString;
+                    response["timings"] = launchTimings;
                 }
                 
             }
@@ -3194,13 +3417,10 @@ namespace WPEFramework {
             {
                 response["message"] = "failed to launch application";
             }
-            gLaunchMutex.lock();
-            gLaunchCount = 0;
-            gLaunchMutex.unlock();
+            warmPoolLaunchCompleted(appCallsign, warmPoolLaunch, result);
 	    gLaunchDestroyMutex.lock();
             gLaunchApplications.erase(appCallsign);
 	    gLaunchDestroyMutex.unlock();
-            std::cout << "new launch count at loc2 is 0\n";
 
             returnResponse(result);
         }
@@ -4459,6 +4679,367 @@ namespace WPEFramework {
 
             returnResponse(true);
         }
+
+        uint32_t RDKShell::setWarmPoolWrapper(const JsonObject& parameters, JsonObject& response)
+        {
+            LOGINFOMETHOD();
+            bool result = true;
+            if (!parameters.HasLabel("apps"))
+            {
+                result = false;
+                response["message"] = "please specify apps";
+            }
+            if (result)
+            {
+                std::map<std::string, WarmPoolEntry> warmPool;
+                const JsonArray apps = parameters["apps"].Array();
+                for (int i = 0; i < apps.Length(); i++)
+                {
+                    if (!(apps[i].Content() == JsonValue::type::OBJECT))
+                    {
+                        continue;
+                    }
+                    const JsonObject& app = apps[i].Object();
+                    if (!app.HasLabel("callsign"))
+                    {
+                        continue;
+                    }
+                    WarmPoolEntry entry;
+                    entry.type = app.HasLabel("type") ? app["type"].String() : "";
+                    entry.uri = app.HasLabel("uri") ? app["uri"].String() : "";
+                    entry.state = WARM_POOL_IDLE;
+                    warmPool[app["callsign"].String()] = entry;
+                }
+
+                // apps that are already running are left to their current owner
+                gPluginDataMutex.lock();
+                for (std::map<std::string, WarmPoolEntry>::iterator iter = warmPool.begin(); iter != warmPool.end(); iter++)
+                {
+                    if (gActivePluginsData.find(iter->first) != gActivePluginsData.end())
+                    {
+                        iter->second.state = WARM_POOL_IN_USE;
+                    }
+                }
+                gPluginDataMutex.unlock();
+
+                std::vector<std::string> removedApps;
+                gWarmPoolMutex.lock();
+                for (std::map<std::string, WarmPoolEntry>::iterator iter = gWarmPool.begin(); iter != gWarmPool.end(); iter++)
+                {
+                    std::map<std::string, WarmPoolEntry>::iterator newEntry = warmPool.find(iter->first);
+                    if (newEntry != warmPool.end())
+                    {
+                        newEntry->second.state = iter->second.state;
+                    }
+                    else if (iter->second.state == WARM_POOL_WARM)
+                    {
+                        removedApps.push_back(iter->first);
+                    }
+                }
+                gWarmPool = warmPool;
+                gWarmPoolMutex.unlock();
+
+                for (size_t i = 0; i < removedApps.size(); i++)
+                {
+                    JsonObject destroyRequest, destroyResponse;
+                    destroyRequest["callsign"] = removedApps[i];
+                    destroyWrapper(destroyRequest, destroyResponse);
+                }
+                scheduleWarmPoolTask(WARM_POOL_TASK_FILL);
+            }
+            returnResponse(result);
+        }
+
+        uint32_t RDKShell::getWarmPoolWrapper(const JsonObject& parameters, JsonObject& response)
+        {
+            LOGINFOMETHOD();
+            std::vector<std::pair<std::string, WarmPoolEntry>> warmPool;
+            bool lowRam = false;
+            gWarmPoolMutex.lock();
+            warmPool.assign(gWarmPool.begin(), gWarmPool.end());
+            lowRam = gWarmPoolLowRam;
+            gWarmPoolMutex.unlock();
+
+            JsonArray apps;
+            for (size_t i = 0; i < warmPool.size(); i++)
+            {
+                JsonObject app;
+                uint64_t resident = 0;
+                app["callsign"] = warmPool[i].first;
+                app["type"] = warmPool[i].second.type;
+                app["state"] = warmPoolStateString(warmPool[i].second.state);
+                app["ram"] = -1;
+                if ((warmPool[i].second.state != WARM_POOL_IDLE) && pluginResidentMemory(warmPool[i].first, resident))
+                {
+                    app["ram"] = resident/1024;
+                }
+                apps.Add(app);
+            }
+            response["apps"] = apps;
+            response["lowRam"] = lowRam;
+            returnResponse(true);
+        }
+
+        uint32_t RDKShell::batchWrapper(const JsonObject& parameters, JsonObject& response)
+        {
+            LOGINFOMETHOD();
+            bool result = true;
+            if (!parameters.HasLabel("commands"))
+            {
+                result = false;
+                response["message"] = "please specify commands";
+            }
+            if (result)
+            {
+                std::vector<RDKShellBatchCommand> commands;
+                const JsonArray commandList = parameters["commands"].Array();
+                for (int i = 0; i < commandList.Length(); i++)
+                {
+                    RDKShellBatchCommand command;
+                    command.hasX = command.hasY = command.hasW = command.hasH = false;
+                    command.x = command.y = command.w = command.h = 0;
+                    command.hasScaleX = command.hasScaleY = false;
+                    command.scaleX = command.scaleY = 1.0;
+                    command.opacity = 100;
+                    command.enable = false;
+                    command.result = true;
+                    if (!(commandList[i].Content() == JsonValue::type::OBJECT))
+                    {
+                        command.result = false;
+                        command.message = "command is not an object";
+                        commands.push_back(command);
+                        continue;
+                    }
+                    const JsonObject& commandParams = commandList[i].Object();
+                    command.method = commandParams["method"].String();
+                    command.client = commandParams.HasLabel("client") ? commandParams["client"].String() : commandParams["callsign"].String();
+                    if (command.client.empty())
+                    {
+                        command.result = false;
+                        command.message = "please specify client";
+                    }
+                    else if (command.method == RDKSHELL_METHOD_SET_BOUNDS)
+                    {
+                        command.hasX = commandParams.HasLabel("x");
+                        command.hasY = commandParams.HasLabel("y");
+                        command.hasW = commandParams.HasLabel("w");
+                        command.hasH = commandParams.HasLabel("h");
+                        command.x = command.hasX ? commandParams["x"].Number() : 0;
+                        command.y = command.hasY ? commandParams["y"].Number() : 0;
+                        command.w = command.hasW ? commandParams["w"].Number() : 0;
+                        command.h = command.hasH ? commandParams["h"].Number() : 0;
+                    }
+                    else if (command.method == RDKSHELL_METHOD_SET_OPACITY)
+                    {
+                        if (!commandParams.HasLabel("opacity"))
+                        {
+                            command.result = false;
+                            command.message = "please specify opacity";
+                        }
+                        command.opacity = commandParams["opacity"].Number();
+                    }
+                    else if (command.method == RDKSHELL_METHOD_SET_SCALE)
+                    {
+                        command.hasScaleX = commandParams.HasLabel("sx");
+                        command.hasScaleY = commandParams.HasLabel("sy");
+                        try
+                        {
+                            if (command.hasScaleX)
+                            {
+                                command.scaleX = std::stod(commandParams["sx"].String());
+                            }
+                            if (command.hasScaleY)
+                            {
+                                command.scaleY = std::stod(commandParams["sy"].String());
+                            }
+                        }
+                        catch(...)
+                        {
+                            command.result = false;
+                            command.message = "invalid sx or sy";
+                        }
+                        if (!command.hasScaleX && !command.hasScaleY)
+                        {
+                            command.result = false;
+                            command.message = "please specify sx and/or sy";
+                        }
+                    }
+                    else if (command.method == RDKSHELL_METHOD_MOVE_BEHIND)
+                    {
+                        command.target = commandParams["target"].String();
+                        if (command.target.empty())
+                        {
+                            command.result = false;
+                            command.message = "please specify target";
+                        }
+                    }
+                    else if ((command.method == RDKSHELL_METHOD_SET_VISIBILITY) || (command.method == RDKSHELL_METHOD_SET_HOLE_PUNCH) || (command.method == RDKSHELL_METHOD_SET_TOPMOST))
+                    {
+                        const char* label = (command.method == RDKSHELL_METHOD_SET_VISIBILITY) ? "visible" : (command.method == RDKSHELL_METHOD_SET_HOLE_PUNCH) ? "holePunch" : "topmost";
+                        if (!commandParams.HasLabel(label))
+                        {
+                            command.result = false;
+                            command.message = std::string("please specify ") + label;
+                        }
+                        command.enable = commandParams[label].Boolean();
+                    }
+                    else if ((command.method != RDKSHELL_METHOD_MOVE_TO_FRONT) && (command.method != RDKSHELL_METHOD_MOVE_TO_BACK) && (command.method != RDKSHELL_METHOD_SET_FOCUS))
+                    {
+                        command.result = false;
+                        command.message = "unsupported method";
+                    }
+                    commands.push_back(command);
+                }
+
+                // everything is applied between two frames of the render loop, failed commands do not undo earlier ones
+                bool boundsChanged = false;
+                double lockRequestTime = RdkShell::microseconds();
+                lockRdkShellMutex();
+                double lockAcquiredTime = RdkShell::microseconds();
+                std::vector<std::string> clientList;
+                CompositorController::getClients(clientList);
+                for (size_t i = 0; i < commands.size(); i++)
+                {
+                    RDKShellBatchCommand& command = commands[i];
+                    if (!command.result)
+                    {
+                        continue;
+                    }
+                    std::string lowerClient(command.client);
+                    std::transform(lowerClient.begin(), lowerClient.end(), lowerClient.begin(), ::tolower);
+                    if (command.method == RDKSHELL_METHOD_SET_BOUNDS)
+                    {
+                        unsigned int x = 0, y = 0, w = 0, h = 0;
+                        CompositorController::getBounds(command.client, x, y, w, h);
+                        CompositorController::setBounds(command.client, 0, 0, 1, 1); //forcing a compositor resize flush
+                        command.result = CompositorController::setBounds(command.client, command.hasX ? command.x : x, command.hasY ? command.y : y,
+                            command.hasW ? command.w : w, command.hasH ? command.h : h);
+                        boundsChanged = true;
+                    }
+                    else if (command.method == RDKSHELL_METHOD_SET_OPACITY)
+                    {
+                        command.result = (std::find(clientList.begin(), clientList.end(), lowerClient) != clientList.end()) &&
+                            CompositorController::setOpacity(lowerClient, command.opacity);
+                    }
+                    else if (command.method == RDKSHELL_METHOD_SET_SCALE)
+                    {
+                        double scaleX = 1.0, scaleY = 1.0;
+                        CompositorController::getScale(lowerClient, scaleX, scaleY);
+                        command.result = (std::find(clientList.begin(), clientList.end(), lowerClient) != clientList.end()) &&
+                            CompositorController::setScale(lowerClient, command.hasScaleX ? command.scaleX : scaleX, command.hasScaleY ? command.scaleY : scaleY);
+                    }
+                    else if (command.method == RDKSHELL_METHOD_MOVE_TO_FRONT)
+                    {
+                        command.result = CompositorController::moveToFront(command.client);
+                    }
+                    else if (command.method == RDKSHELL_METHOD_MOVE_TO_BACK)
+                    {
+                        command.result = CompositorController::moveToBack(command.client);
+                    }
+                    else if (command.method == RDKSHELL_METHOD_MOVE_BEHIND)
+                    {
+                        bool targetFound = false;
+                        for (size_t j = 0; j < clientList.size(); j++)
+                        {
+                            if (strcasecmp(clientList[j].c_str(), command.target.c_str()) == 0)
+                            {
+                                targetFound = true;
+                                break;
+                            }
+                        }
+                        command.result = targetFound && CompositorController::moveBehind(command.client, command.target);
+                    }
+                    else if (command.method == RDKSHELL_METHOD_SET_FOCUS)
+                    {
+                        command.result = CompositorController::setFocus(command.client);
+                    }
+                    else if (command.method == RDKSHELL_METHOD_SET_VISIBILITY)
+                    {
+                        command.result = CompositorController::setVisibility(command.client, command.enable);
+                    }
+                    else if (command.method == RDKSHELL_METHOD_SET_HOLE_PUNCH)
+                    {
+                        command.result = CompositorController::setHolePunch(command.client, command.enable);
+                    }
+                    else if (command.method == RDKSHELL_METHOD_SET_TOPMOST)
+                    {
+                        command.result = CompositorController::setTopmost(command.client, command.enable);
+                    }
+                    if (!command.result)
+                    {
+                        command.message = "failed to " + command.method;
+                    }
+                }
+                double lockReleaseTime = RdkShell::microseconds();
+                gRdkShellMutex.unlock();
+
+                JsonArray results;
+                for (size_t i = 0; i < commands.size(); i++)
+                {
+                    const RDKShellBatchCommand& command = commands[i];
+                    if (command.result && (command.method == RDKSHELL_METHOD_SET_VISIBILITY))
+                    {
+                        setBrowserVisibility(command.client, command.enable);
+                    }
+                    JsonObject commandResult;
+                    commandResult["method"] = command.method;
+                    commandResult["client"] = command.client;
+                    commandResult["success"] = command.result;
+                    if (!command.message.empty())
+                    {
+                        commandResult["message"] = command.message;
+                    }
+                    result = result && command.result;
+                    results.Add(commandResult);
+                }
+                if (boundsChanged)
+                {
+                    // same settle time setBounds gives the compositor, paid once per batch
+                    usleep(68000);
+                }
+                response["results"] = results;
+                response["lockWaitTime"] = static_cast<int>(lockAcquiredTime - lockRequestTime);
+                response["lockHoldTime"] = static_cast<int>(lockReleaseTime - lockAcquiredTime);
+                if (!result)
+                {
+                    response["message"] = "one or more commands failed";
+                }
+            }
+            returnResponse(result);
+        }
+
+        uint32_t RDKShell::getFrameStatsWrapper(const JsonObject& parameters, JsonObject& response)
+        {
+            LOGINFOMETHOD();
+            uint32_t frames = 0;
+            if (parameters.HasLabel("frames"))
+            {
+                frames = parameters["frames"].Number();
+            }
+            getFrameStats(response, frames);
+            returnResponse(true);
+        }
+
+        uint32_t RDKShell::enableFrameStatsEventWrapper(const JsonObject& parameters, JsonObject& response)
+        {
+            LOGINFOMETHOD();
+            bool result = true;
+            if (!parameters.HasLabel("enable"))
+            {
+                result = false;
+                response["message"] = "please specify enable parameter";
+            }
+            if (result)
+            {
+                if (parameters.HasLabel("interval"))
+                {
+                    uint32_t interval = parameters["interval"].Number();
+                    sFrameStatsEventInterval = (interval > 0) ? interval : RDKSHELL_FRAME_STATS_EVENT_DEFAULT_INTERVAL_IN_MS;
+                }
+                sFrameStatsEventEnabled = parameters["enable"].Boolean();
+            }
+            returnResponse(result);
+        }
         // Registered methods end
 
         // Events begin
@@ -5006,26 +5587,16 @@ namespace WPEFramework {
         bool RDKShell::setVisibility(const string& client, const bool visible)
         {
             bool ret = false;
-            {
-                bool lockAcquired = false;
-                double startTime = RdkShell::milliseconds();
-                while (!lockAcquired && (RdkShell::milliseconds() - startTime) < RDKSHELL_TRY_LOCK_WAIT_TIME_IN_MS)
-                {
-                    lockAcquired = gRdkShellMutex.try_lock();
-                }
-                if (!lockAcquired)
-                {
-                    std::cout << "unable to get lock for visibility, defaulting to normal lock\n";
-                    gRdkShellMutex.lock();
-                }
-                else
-                {
-                    std::cout << "lock was acquired via try for visibility\n";
-                }
-            }
+            lockRdkShellMutex();
             ret = CompositorController::setVisibility(client, visible);
             gRdkShellMutex.unlock();
 
+            setBrowserVisibility(client, visible);
+            return ret;
+        }
+
+        void RDKShell::setBrowserVisibility(const string& client, const bool visible)
+        {
             std::map<std::string, PluginData> activePluginsData;
             gPluginDataMutex.lock();
             activePluginsData = gActivePluginsData;
@@ -5054,8 +5625,6 @@ namespace WPEFramework {
                     }
                 }
             }
-
-            return ret;
         }
 
         bool RDKShell::getOpacity(const string& client, unsigned int& opacity)
@@ -5241,12 +5810,16 @@ namespace WPEFramework {
             return true;
         }
 
-        void RDKShell::onLaunched(const std::string& client, const string& launchType)
+        void RDKShell::onLaunched(const std::string& client, const string& launchType, const JsonObject& timings)
         {
             std::cout << "RDKShell onLaunched event received for " << client << std::endl;
             JsonObject params;
             params["client"] = client;
             params["launchType"] = launchType;
+            if (timings.Variants().Next())
+            {
+                params["timings"] = timings;
+            }
             notify(RDKSHELL_EVENT_ON_LAUNCHED, params);
         }
 
@@ -5278,12 +5851,12 @@ namespace WPEFramework {
         bool RDKShell::pluginMemoryUsage(const string callsign, JsonArray& memoryInfo)
         {
             JsonObject memoryDetails;
-            Exchange::IMemory* pluginMemoryInterface(mCurrentService->QueryInterfaceByCallsign<Exchange::IMemory>(callsign.c_str()));
+            uint64_t resident = 0;
             memoryDetails["callsign"] = callsign;
             memoryDetails["ram"] = -1;
-            if (nullptr != pluginMemoryInterface)
+            if (pluginResidentMemory(callsign, resident))
             {
-                memoryDetails["ram"] = pluginMemoryInterface->Resident()/1024;
+                memoryDetails["ram"] = resident/1024;
             }
             else
             {
@@ -5293,6 +5866,171 @@ namespace WPEFramework {
             return true;
         }
 
+        bool RDKShell::pluginResidentMemory(const string& callsign, uint64_t& resident)
+        {
+            if (nullptr == mCurrentService)
+            {
+                return false;
+            }
+            Exchange::IMemory* pluginMemoryInterface(mCurrentService->QueryInterfaceByCallsign<Exchange::IMemory>(callsign.c_str()));
+            if (nullptr == pluginMemoryInterface)
+            {
+                return false;
+            }
+            resident = pluginMemoryInterface->Resident();
+            pluginMemoryInterface->Release();
+            return true;
+        }
+
+        void RDKShell::loadWarmPoolConfig()
+        {
+            // RDKSHELL_WARM_POOL="callsign[:type][,callsign[:type]...]"
+            char* warmPoolValue = getenv("RDKSHELL_WARM_POOL");
+            if (NULL == warmPoolValue)
+            {
+                return;
+            }
+            std::stringstream warmPoolStream(warmPoolValue);
+            std::string item;
+            gWarmPoolMutex.lock();
+            while (std::getline(warmPoolStream, item, ','))
+            {
+                if (item.empty())
+                {
+                    continue;
+                }
+                WarmPoolEntry entry;
+                std::string callsign = item;
+                size_t separator = item.find(':');
+                if (separator != std::string::npos)
+                {
+                    callsign = item.substr(0, separator);
+                    entry.type = item.substr(separator + 1);
+                }
+                entry.state = WARM_POOL_IDLE;
+                std::cout << "adding " << callsign << " to the warm pool\n";
+                gWarmPool[callsign] = entry;
+            }
+            gWarmPoolMutex.unlock();
+        }
+
+        void RDKShell::fillWarmPool()
+        {
+            std::vector<std::pair<std::string, WarmPoolEntry>> pending;
+            gWarmPoolMutex.lock();
+            if (!gWarmPoolLowRam)
+            {
+                for (std::map<std::string, WarmPoolEntry>::iterator iter = gWarmPool.begin(); iter != gWarmPool.end(); iter++)
+                {
+                    if (iter->second.state == WARM_POOL_IDLE)
+                    {
+                        iter->second.state = WARM_POOL_WARMING;
+                        pending.push_back(*iter);
+                    }
+                }
+            }
+            gWarmPoolMutex.unlock();
+
+            for (size_t i = 0; i < pending.size(); i++)
+            {
+                JsonObject request, response;
+                request["callsign"] = pending[i].first;
+                if (!pending[i].second.type.empty())
+                {
+                    request["type"] = pending[i].second.type;
+                }
+                if (!pending[i].second.uri.empty())
+                {
+                    request["uri"] = pending[i].second.uri;
+                }
+                request["suspend"] = true;
+                request["visible"] = false;
+                request["focused"] = false;
+                request["warmpool"] = true;
+                std::cout << "pre-launching " << pending[i].first << " into the warm pool\n";
+                getThunderControllerClient("org.rdk.RDKShell.1")->Invoke(0, "launch", request, response);
+            }
+        }
+
+        void RDKShell::shrinkWarmPool(const bool critical)
+        {
+            std::vector<std::string> warmApps;
+            gWarmPoolMutex.lock();
+            gWarmPoolLowRam = true;
+            for (std::map<std::string, WarmPoolEntry>::iterator iter = gWarmPool.begin(); iter != gWarmPool.end(); iter++)
+            {
+                if (iter->second.state == WARM_POOL_WARM)
+                {
+                    warmApps.push_back(iter->first);
+                }
+            }
+            gWarmPoolMutex.unlock();
+
+            // evict the biggest resident sets first, all of them when memory is critically low
+            std::vector<std::pair<uint64_t, std::string>> evictionOrder;
+            for (size_t i = 0; i < warmApps.size(); i++)
+            {
+                uint64_t resident = 0;
+                pluginResidentMemory(warmApps[i], resident);
+                evictionOrder.push_back(std::make_pair(resident, warmApps[i]));
+            }
+            std::sort(evictionOrder.begin(), evictionOrder.end(), std::greater<std::pair<uint64_t, std::string>>());
+            size_t evictionCount = critical ? evictionOrder.size() : std::min<size_t>(1, evictionOrder.size());
+
+            for (size_t i = 0; i < evictionCount; i++)
+            {
+                const std::string& callsign = evictionOrder[i].second;
+                bool evict = false;
+                gWarmPoolMutex.lock();
+                std::map<std::string, WarmPoolEntry>::iterator warmPoolEntry = gWarmPool.find(callsign);
+                if ((warmPoolEntry != gWarmPool.end()) && (warmPoolEntry->second.state == WARM_POOL_WARM))
+                {
+                    warmPoolEntry->second.state = WARM_POOL_IDLE;
+                    evict = true;
+                }
+                gWarmPoolMutex.unlock();
+                if (evict)
+                {
+                    std::cout << "evicting " << callsign << " from the warm pool, resident " << evictionOrder[i].first/1024 << " KB\n";
+                    JsonObject request, response;
+                    request["callsign"] = callsign;
+                    getThunderControllerClient("org.rdk.RDKShell.1")->Invoke(0, "destroy", request, response);
+                }
+            }
+        }
+
+        void RDKShell::runWarmPoolTasks()
+        {
+            std::unique_lock<std::mutex> lock(gWarmPoolMutex);
+            while (sWarmPoolRunning)
+            {
+                sWarmPoolCondition.wait(lock, []() { return (!sWarmPoolRunning || (sWarmPoolTasks != 0)); });
+                uint32_t tasks = sWarmPoolTasks;
+                sWarmPoolTasks = 0;
+                if (!sWarmPoolRunning || (tasks == 0))
+                {
+                    continue;
+                }
+                lock.unlock();
+
+                // shrink before fill, a fill requested along with a low ram warning is skipped by the low ram flag
+                if (tasks & WARM_POOL_TASK_SHRINK_CRITICAL)
+                {
+                    shrinkWarmPool(true);
+                }
+                else if (tasks & WARM_POOL_TASK_SHRINK)
+                {
+                    shrinkWarmPool(false);
+                }
+                if (tasks & WARM_POOL_TASK_FILL)
+                {
+                    fillWarmPool();
+                }
+
+                lock.lock();
+            }
+        }
+
 
         bool RDKShell::getKeyRepeatsEnabled(bool& enable)
         {
@@ -111,6 +111,11 @@ namespace WPEFramework {
             static const string RDKSHELL_METHOD_GET_LAST_WAKEUP_KEY;
             static const string RDKSHELL_METHOD_ENABLE_LOGS_FLUSHING;
             static const string RDKSHELL_METHOD_GET_LOGS_FLUSHING_ENABLED;
+            static const string RDKSHELL_METHOD_SET_WARM_POOL;
+            static const string RDKSHELL_METHOD_GET_WARM_POOL;
+            static const string RDKSHELL_METHOD_BATCH;
+            static const string RDKSHELL_METHOD_GET_FRAME_STATS;
+            static const string RDKSHELL_METHOD_ENABLE_FRAME_STATS_EVENT;
 
             // events
             static const string RDKSHELL_EVENT_ON_USER_INACTIVITY;
@@ -131,6 +136,7 @@ namespace WPEFramework {
             static const string RDKSHELL_EVENT_DEVICE_CRITICALLY_LOW_RAM_WARNING_CLEARED;
             static const string RDKSHELL_EVENT_ON_EASTER_EGG;
             static const string RDKSHELL_EVENT_ON_WILL_DESTROY;
+            static const string RDKSHELL_EVENT_ON_FRAME_STATS;
 
             void notify(const std::string& event, const JsonObject& parameters);
             void pluginEventHandler(const JsonObject& parameters);
@@ -203,6 +209,11 @@ namespace WPEFramework {
             uint32_t getLastWakeupKeyWrapper(const JsonObject& parameters, JsonObject& response);
             uint32_t enableLogsFlushingWrapper(const JsonObject& parameters, JsonObject& response);
             uint32_t getLogsFlushingEnabledWrapper(const JsonObject& parameters, JsonObject& response);
+            uint32_t setWarmPoolWrapper(const JsonObject& parameters, JsonObject& response);
+            uint32_t getWarmPoolWrapper(const JsonObject& parameters, JsonObject& response);
+            uint32_t batchWrapper(const JsonObject& parameters, JsonObject& response);
+            uint32_t getFrameStatsWrapper(const JsonObject& parameters, JsonObject& response);
+            uint32_t enableFrameStatsEventWrapper(const JsonObject& parameters, JsonObject& response);
 
         private/*internal methods*/:
             RDKShell(const RDKShell&) = delete;
@@ -232,6 +243,7 @@ namespace WPEFramework {
             bool setBounds(const string& client, const unsigned int x, const unsigned int y, const unsigned int w, const unsigned int h);
             bool getVisibility(const string& client, bool& visibility);
             bool setVisibility(const string& client, const bool visible);
+            void setBrowserVisibility(const string& client, const bool visible);
             bool getOpacity(const string& client, unsigned int& opacity);
             bool setOpacity(const string& client, const unsigned int opacity);
             bool getScale(const string& client, double& scaleX, double& scaleY);
@@ -242,11 +254,12 @@ namespace WPEFramework {
             bool addAnimationList(const JsonArray& animations);
             bool enableInactivityReporting(const bool enable);
             bool setInactivityInterval(const uint32_t interval);
-            void onLaunched(const std::string& client, const string& launchType);
+            void onLaunched(const std::string& client, const string& launchType, const JsonObject& timings = JsonObject());
             void onSuspended(const std::string& client);
             void onDestroyed(const std::string& client);
             bool systemMemory(uint32_t &freeKb, uint32_t & totalKb, uint32_t & usedSwapKb);
             bool pluginMemoryUsage(const string callsign, JsonArray& memoryInfo);
+            bool pluginResidentMemory(const string& callsign, uint64_t& resident);
             bool showWatermark(const bool enable);
             bool showFullScreenImage(std::string& path);
             void killAllApps(bool enableDestroyEvent=false);
@@ -262,6 +275,10 @@ namespace WPEFramework {
             void invokeStartupThunderApis();
             void enableLogsFlushing(const bool enable);
             void getLogsFlushingEnabled(bool &enabled);
+            void loadWarmPoolConfig();
+            void fillWarmPool();
+            void shrinkWarmPool(const bool critical);
+            void runWarmPoolTasks();
 
             static std::shared_ptr<WPEFramework::JSONRPC::LinkType<WPEFramework::Core::JSON::IElement> > getThunderControllerClient(std::string callsign="", std::string localidentifier="");
             static std::shared_ptr<WPEFramework::JSONRPC::LinkType<WPEFramework::Core::JSON::IElement> > getPackagerPlugin();
@@ -29,6 +29,23 @@
 #include <png.h>
 #include <curl/curl.h>
 
+#ifdef HAS_JPEG
+#include <stdio.h>
+#include <setjmp.h>
+#include <jpeglib.h>
+#endif
+
+#if defined(__SSSE3__)
+#include <tmmintrin.h>
+#elif defined(__SSE2__)
+#include <emmintrin.h>
+#elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+#include <arm_neon.h>
+#endif
+
+#include <algorithm>
+#include <chrono>
+
 #ifdef HAS_FRAMEBUFFER_API_HEADER
 extern "C" {
 #include "framebuffer-api.h"
@@ -38,10 +55,19 @@ extern "C" {
 
 // Methods
 #define METHOD_UPLOAD "uploadScreenCapture"
+#define METHOD_START_SESSION "startCaptureSession"
+#define METHOD_STOP_SESSION "stopCaptureSession"
+#define METHOD_GET_SESSION_STATUS "getCaptureSessionStatus"
 
 // Events
 #define EVT_UPLOAD_COMPLETE "uploadComplete"
 
+#define SESSION_MIN_INTERVAL 100
+#define SESSION_MIN_TILE_SIZE 16
+#define SESSION_MAX_TILE_SIZE 512
+#define SESSION_CONNECT_TIMEOUT 10 // s
+#define SESSION_UPLOAD_TIMEOUT 30 // s, per frame
+
 namespace WPEFramework
 {
     namespace Plugin
@@ -61,7 +87,15 @@ namespace WPEFramework
             inNexus = false;
             #endif
 
+            m_sessionActive = false;
+            m_sessionStop = false;
+            m_sessionForceKey = false;
+            m_sessionCurl = NULL;
+
             Register(METHOD_UPLOAD, &ScreenCapture::uploadScreenCapture, this);
+            Register(METHOD_START_SESSION, &ScreenCapture::startCaptureSession, this);
+            Register(METHOD_STOP_SESSION, &ScreenCapture::stopCaptureSession, this);
+            Register(METHOD_GET_SESSION_STATUS, &ScreenCapture::getCaptureSessionStatus, this);
         }
 
         ScreenCapture::~ScreenCapture()
@@ -72,6 +106,8 @@ namespace WPEFramework
         {
             ScreenCapture::_instance = nullptr;
 
+            stopSession();
+
             delete screenShotDispatcher;
         }
 
@@ -93,11 +129,79 @@ namespace WPEFramework
             if(parameters.HasLabel("callGUID"))
               callGUID = parameters["callGUID"].String();
 
-            screenShotDispatcher->Schedule( Core::Time::Now().Add(0), ScreenShotJob( this, parameters["url"].String(), callGUID ) );
+            ImageOptions options;
+            std::string message;
+            if(!parseImageOptions(parameters, options, message))
+            {
+                response["message"] = message;
+
+                returnResponse(false);
+            }
+
+            screenShotDispatcher->Schedule( Core::Time::Now().Add(0), ScreenShotJob( this, parameters["url"].String(), callGUID, options ) );
 
             returnResponse(true);
         }
 
+        bool ScreenCapture::parseImageOptions(const JsonObject& parameters, ImageOptions& options, std::string& message)
+        {
+            if(parameters.HasLabel("format"))
+            {
+                options.format = parameters["format"].String();
+                #ifdef HAS_JPEG
+                if(options.format != "png" && options.format != "jpeg" && options.format != "raw")
+                #else
+                if(options.format != "png" && options.format != "raw")
+                #endif
+                {
+                    message = "Unsupported format " + options.format;
+                    return false;
+                }
+            }
+
+            if(parameters.HasLabel("compression"))
+            {
+                options.compression = (int)parameters["compression"].Number();
+                if(options.compression < 0 || options.compression > 9)
+                {
+                    message = "compression should be between 0 and 9";
+                    return false;
+                }
+            }
+
+            if(parameters.HasLabel("filter"))
+            {
+                static const std::map<std::string, int> filters = {
+                    { "none", PNG_FILTER_NONE },
+                    { "sub", PNG_FILTER_SUB },
+                    { "up", PNG_FILTER_UP },
+                    { "avg", PNG_FILTER_AVG },
+                    { "paeth", PNG_FILTER_PAETH },
+                    { "all", PNG_ALL_FILTERS }
+                };
+
+                auto filter = filters.find(parameters["filter"].String());
+                if(filter == filters.end())
+                {
+                    message = "filter should be one of none, sub, up, avg, paeth or all";
+                    return false;
+                }
+                options.filter = filter->second;
+            }
+
+            if(parameters.HasLabel("quality"))
+            {
+                options.quality = (int)parameters["quality"].Number();
+                if(options.quality < 1 || options.quality > 100)
+                {
+                    message = "quality should be between 1 and 100";
+                    return false;
+                }
+            }
+
+            return true;
+        }
+
         uint64_t ScreenShotJob::Timed(const uint64_t scheduledTime)
         {
             if(!m_screenCapture)
@@ -106,65 +210,78 @@ namespace WPEFramework
                 return 0;
             }
 
-            m_screenCapture->doUploadScreenCapture(url, callGUID);
+            m_screenCapture->doUploadScreenCapture(url, callGUID, options);
 
             return 0;
         }
 
-        bool ScreenCapture::doUploadScreenCapture(std::string url, std::string callGUID)
+        bool ScreenCapture::doUploadScreenCapture(std::string url, std::string callGUID, ImageOptions options)
         {
-            std::vector<unsigned char> png_data;
+            std::vector<unsigned char> image_data;
             bool got_screenshot = false;
 
-            #ifdef PLATFORM_BROADCOM
-            got_screenshot = getScreenshotNexus(png_data);
-            #endif
+            auto started = std::chrono::steady_clock::now();
 
-            #ifdef PLATFORM_INTEL
-            got_screenshot = getScreenshotIntel(png_data);
-            #endif
+            got_screenshot = grabScreenshot(options, image_data);
 
-            #ifdef HAS_FRAMEBUFFER_API_HEADER
-            got_screenshot = getScreenshotRealtek(png_data);
-            #endif
+            auto captured = std::chrono::steady_clock::now();
+
+            JsonObject params;
+            params["call_guid"] = callGUID;
 
             if(got_screenshot)
             {
                 std::string error_str;
+                std::vector<std::string> headers;
 
-                LOGWARN("uploading %d of png data to '%s'", png_data.size(), url.c_str() );
+                if(options.format == "jpeg")
+                    headers.push_back("Content-Type: image/jpeg");
+                else if(options.format == "raw")
+                {
+                    headers.push_back("Content-Type: application/octet-stream");
+                    headers.push_back("X-Image-Format: RGBA");
+                    headers.push_back("X-Image-Width: " + std::to_string(options.width));
+                    headers.push_back("X-Image-Height: " + std::to_string(options.height));
+                }
+                else
+                    headers.push_back("Content-Type: image/png");
+
+                LOGWARN("uploading %zu of %s data to '%s'", image_data.size(), options.format.c_str(), url.c_str() );
+
+                bool uploaded = uploadDataToUrl(image_data, url.c_str(), headers, error_str);
+
+                auto finished = std::chrono::steady_clock::now();
 
-                if(uploadDataToUrl(png_data, url.c_str(), error_str))
+                if(uploaded)
                 {
-                    JsonObject params;
                     params["status"] = true;
                     params["message"] = "Success";
-                    params["call_guid"] = callGUID;
-
-                    sendNotify(EVT_UPLOAD_COMPLETE, params);
-
-                    return true;
                 }
                 else
                 {
-                    JsonObject params;
                     params["status"] = false;
                     params["message"] = std::string("Upload Failed: ") + error_str;
-                    params["call_guid"] = callGUID;
+                }
 
-                    sendNotify(EVT_UPLOAD_COMPLETE, params);
+                // capture includes encoding, all in ms
+                JsonObject timing;
+                timing["capture"] = (int64_t)std::chrono::duration_cast<std::chrono::milliseconds>(captured - started).count();
+                timing["encode"] = (int64_t)(options.encodeTime / 1000);
+                timing["upload"] = (int64_t)std::chrono::duration_cast<std::chrono::milliseconds>(finished - captured).count();
+                timing["total"] = (int64_t)std::chrono::duration_cast<std::chrono::milliseconds>(finished - started).count();
+                timing["size"] = (uint64_t)image_data.size();
+                params["timing"] = timing;
 
-                    return false;
-                }
+                sendNotify(EVT_UPLOAD_COMPLETE, params);
+
+                return uploaded;
             }
             else
             {
                 LOGERR("Error: could not get the screenshot");
 
-                JsonObject params;
                 params["status"] = false;
                 params["message"] = "Failed to get screen data";
-                params["call_guid"] = callGUID;
 
                 sendNotify(EVT_UPLOAD_COMPLETE, params);
 
@@ -172,10 +289,598 @@ namespace WPEFramework
             }
         }
 
+        bool ScreenCapture::grabScreenshot(ImageOptions &options, std::vector<unsigned char> &image_data)
+        {
+            std::lock_guard<std::mutex> guard(m_grabMutex);
+            bool got_screenshot = false;
+
+            #ifdef PLATFORM_BROADCOM
+            got_screenshot = getScreenshotNexus(options, image_data);
+            #endif
+
+            #ifdef PLATFORM_INTEL
+            got_screenshot = getScreenshotIntel(options, image_data);
+            #endif
+
+            #ifdef HAS_FRAMEBUFFER_API_HEADER
+            got_screenshot = getScreenshotRealtek(options, image_data);
+            #endif
+
+            return got_screenshot;
+        }
+
+        uint32_t ScreenCapture::startCaptureSession(const JsonObject& parameters, JsonObject& response)
+        {
+            std::lock_guard<std::mutex> guard(m_callMutex);
+
+            LOGINFOMETHOD();
+
+            if(!parameters.HasLabel("url"))
+            {
+                response["message"] = "Upload url is not specified";
+
+                returnResponse(false);
+            }
+
+            if(m_sessionActive)
+            {
+                response["message"] = "Capture session is already running";
+
+                returnResponse(false);
+            }
+
+            CaptureSession session;
+            std::string message;
+            if(!parseImageOptions(parameters, session.options, message))
+            {
+                response["message"] = message;
+
+                returnResponse(false);
+            }
+
+            session.url = parameters["url"].String();
+
+            if(parameters.HasLabel("callGUID"))
+                session.callGUID = parameters["callGUID"].String();
+
+            if(parameters.HasLabel("interval"))
+            {
+                int64_t interval = parameters["interval"].Number();
+                if(interval < SESSION_MIN_INTERVAL)
+                {
+                    response["message"] = "interval should be at least " + std::to_string(SESSION_MIN_INTERVAL) + " ms";
+
+                    returnResponse(false);
+                }
+                session.interval = (uint32_t)interval;
+            }
+
+            if(parameters.HasLabel("width"))
+                session.width = (int)parameters["width"].Number();
+            if(parameters.HasLabel("height"))
+                session.height = (int)parameters["height"].Number();
+            if(session.width < 0 || session.height < 0)
+            {
+                response["message"] = "width and height should be positive";
+
+                returnResponse(false);
+            }
+
+            if(parameters.HasLabel("tileSize"))
+            {
+                session.tileSize = (int)parameters["tileSize"].Number();
+                if(session.tileSize < SESSION_MIN_TILE_SIZE || session.tileSize > SESSION_MAX_TILE_SIZE)
+                {
+                    response["message"] = "tileSize should be between " + std::to_string(SESSION_MIN_TILE_SIZE) + " and " + std::to_string(SESSION_MAX_TILE_SIZE);
+
+                    returnResponse(false);
+                }
+            }
+
+            curl_global_init(CURL_GLOBAL_ALL);
+            m_sessionCurl = curl_easy_init();
+            if(!m_sessionCurl)
+            {
+                response["message"] = "could not init curl";
+
+                returnResponse(false);
+            }
+
+            m_session = session;
+            m_sessionStop = false;
+            m_sessionForceKey = true;
+            m_sessionFrame.reset();
+            m_sessionActive = true;
+
+            m_uploadThread = std::thread(&ScreenCapture::uploadSessionLoop, this);
+            m_captureThread = std::thread(&ScreenCapture::captureSessionLoop, this);
+
+            LOGWARN("capture session started, every %u ms to '%s'", session.interval, session.url.c_str());
+
+            returnResponse(true);
+        }
+
+        uint32_t ScreenCapture::stopCaptureSession(const JsonObject& parameters, JsonObject& response)
+        {
+            std::lock_guard<std::mutex> guard(m_callMutex);
+
+            LOGINFOMETHOD();
+
+            if(!m_sessionActive)
+            {
+                response["message"] = "No capture session is running";
+
+                returnResponse(false);
+            }
+
+            stopSession();
+            sessionStatus(response);
+
+            returnResponse(true);
+        }
+
+        uint32_t ScreenCapture::getCaptureSessionStatus(const JsonObject& parameters, JsonObject& response)
+        {
+            std::lock_guard<std::mutex> guard(m_callMutex);
+
+            LOGINFOMETHOD();
+
+            sessionStatus(response);
+
+            returnResponse(true);
+        }
+
+        void ScreenCapture::sessionStatus(JsonObject &response)
+        {
+            std::lock_guard<std::mutex> lock(m_sessionMutex);
+
+            response["active"] = m_sessionActive;
+            response["captured"] = m_session.captured;
+            response["uploaded"] = m_session.uploaded;
+            response["unchanged"] = m_session.unchanged;
+            response["skipped"] = m_session.skipped;
+            response["failed"] = m_session.failed;
+            response["bytes"] = m_session.bytes;
+        }
+
+        void ScreenCapture::stopSession()
+        {
+            {
+                std::lock_guard<std::mutex> lock(m_sessionMutex);
+                if(!m_sessionActive)
+                    return;
+                m_sessionStop = true;
+            }
+            m_sessionCV.notify_all();
+
+            if(m_captureThread.joinable())
+                m_captureThread.join();
+            if(m_uploadThread.joinable())
+                m_uploadThread.join();
+
+            curl_easy_cleanup(m_sessionCurl);
+            m_sessionCurl = NULL;
+
+            std::lock_guard<std::mutex> lock(m_sessionMutex);
+            m_sessionFrame.reset();
+            m_sessionActive = false;
+
+            LOGWARN("capture session stopped after %u frames", m_session.captured);
+        }
+
+        // Averages every source pixel into exactly one destination pixel, for any ratio up to 1:1.
+        static void downscaleBox(const unsigned char *src, int sw, int sh, unsigned char *dst, int dw, int dh)
+        {
+            std::vector<int> columns(dw + 1);
+            for(int x = 0; x <= dw; x++)
+                columns[x] = (int)((int64_t)x * sw / dw);
+
+            std::vector<uint32_t> sums((size_t)dw * 4);
+
+            for(int y = 0; y < dh; y++)
+            {
+                int y0 = (int)((int64_t)y * sh / dh);
+                int y1 = (int)((int64_t)(y + 1) * sh / dh);
+
+                std::fill(sums.begin(), sums.end(), 0);
+
+                for(int sy = y0; sy < y1; sy++)
+                {
+                    const unsigned char *row = src + (size_t)sy * sw * 4;
+                    for(int x = 0; x < dw; x++)
+                    {
+                        uint32_t *sum = &sums[x * 4];
+                        for(int sx = columns[x]; sx < columns[x + 1]; sx++)
+                        {
+                            const unsigned char *p = row + sx * 4;
+                            sum[0] += p[0];
+                            sum[1] += p[1];
+                            sum[2] += p[2];
+                            sum[3] += p[3];
+                        }
+                    }
+                }
+
+                unsigned char *out = dst + (size_t)y * dw * 4;
+                for(int x = 0; x < dw; x++)
+                {
+                    uint32_t count = (uint32_t)(columns[x + 1] - columns[x]) * (y1 - y0);
+                    for(int c = 0; c < 4; c++)
+                        out[x * 4 + c] = (unsigned char)((sums[x * 4 + c] + count / 2) / count);
+                }
+            }
+        }
+
+        static bool tileChanged(const unsigned char *a, const unsigned char *b, int stride, int x, int y, int w, int h)
+        {
+            size_t offset = (size_t)y * stride + x * 4;
+            for(int row = 0; row < h; row++, offset += stride)
+            {
+                if(memcmp(a + offset, b + offset, (size_t)w * 4) != 0)
+                    return true;
+            }
+            return false;
+        }
+
+        // Grabs, downscales and diffs one frame against the previous one. Returns false when there
+        // is nothing to upload.
+        bool ScreenCapture::captureSessionFrame(std::vector<unsigned char> &previous, int &previous_width, int &previous_height, uint32_t sequence, CaptureFrame &frame)
+        {
+            ImageOptions raw;
+            raw.format = "raw";
+            std::vector<unsigned char> pixels;
+
+            bool got_screenshot = grabScreenshot(raw, pixels);
+            bool force_key;
+
+            {
+                std::lock_guard<std::mutex> lock(m_sessionMutex);
+
+                if(!got_screenshot)
+                {
+                    LOGERR("capture session could not get the screenshot");
+                    m_session.failed++;
+                    return false;
+                }
+
+                m_session.captured++;
+                force_key = m_sessionForceKey;
+                m_sessionForceKey = false;
+            }
+
+            // The settings do not change while the session runs, only the counters need the lock
+
+            // Never upscale, and keep the aspect ratio when only one dimension is given
+            int w = raw.width;
+            int h = raw.height;
+            int dw = m_session.width;
+            int dh = m_session.height;
+            if(dw == 0 && dh == 0)
+            {
+                dw = w;
+                dh = h;
+            }
+            else if(dw == 0)
+                dw = (int)((int64_t)w * dh / h);
+            else if(dh == 0)
+                dh = (int)((int64_t)h * dw / w);
+            dw = std::max(1, std::min(dw, w));
+            dh = std::max(1, std::min(dh, h));
+
+            if(dw != w || dh != h)
+            {
+                std::vector<unsigned char> scaled((size_t)dw * dh * 4);
+                downscaleBox(&pixels[0], w, h, &scaled[0], dw, dh);
+                pixels.swap(scaled);
+            }
+
+            frame.sequence = sequence;
+            frame.base = sequence - 1;
+            frame.width = dw;
+            frame.height = dh;
+            frame.key = force_key || dw != previous_width || dh != previous_height;
+            frame.tiles.clear();
+
+            int tileSize = m_session.tileSize;
+            int stride = dw * 4;
+
+            if(!frame.key)
+            {
+                int total = 0;
+                for(int y = 0; y < dh; y += tileSize)
+                {
+                    for(int x = 0; x < dw; x += tileSize)
+                    {
+                        total++;
+                        CaptureTile tile;
+                        tile.x = x;
+                        tile.y = y;
+                        tile.width = std::min(tileSize, dw - x);
+                        tile.height = std::min(tileSize, dh - y);
+                        if(tileChanged(&pixels[0], &previous[0], stride, tile.x, tile.y, tile.width, tile.height))
+                            frame.tiles.push_back(tile);
+                    }
+                }
+
+                if(frame.tiles.empty())
+                {
+                    std::lock_guard<std::mutex> lock(m_sessionMutex);
+                    m_session.unchanged++;
+                    return false;
+                }
+
+                // Past half of the screen a single image is smaller than the tiles
+                if(frame.tiles.size() * 2 > (size_t)total)
+                    frame.key = true;
+            }
+
+            if(frame.key)
+            {
+                CaptureTile tile;
+                tile.x = 0;
+                tile.y = 0;
+                tile.width = dw;
+                tile.height = dh;
+                frame.tiles.assign(1, tile);
+            }
+
+            ImageOptions options = m_session.options;
+            for(CaptureTile &tile : frame.tiles)
+            {
+                if(!encodeImage(&pixels[(size_t)tile.y * stride + tile.x * 4], tile.width, tile.height, stride, options, tile.data))
+                {
+                    LOGERR("capture session could not encode frame %u", sequence);
+                    std::lock_guard<std::mutex> lock(m_sessionMutex);
+                    m_session.failed++;
+                    m_sessionForceKey = true;
+                    return false;
+                }
+            }
+
+            previous.swap(pixels);
+            previous_width = dw;
+            previous_height = dh;
+
+            return true;
+        }
+
+        void ScreenCapture::captureSessionLoop()
+        {
+            std::vector<unsigned char> previous;
+            int previous_width = 0;
+            int previous_height = 0;
+            uint32_t sequence = 0;
+
+            auto next = std::chrono::steady_clock::now();
+
+            while(true)
+            {
+                {
+                    std::unique_lock<std::mutex> lock(m_sessionMutex);
+                    if(m_sessionCV.wait_until(lock, next, [this] { return m_sessionStop.load(); }))
+                        break;
+
+                    // Do not burst to catch up after a slow capture
+                    next += std::chrono::milliseconds(m_session.interval);
+                    if(next < std::chrono::steady_clock::now())
+                        next = std::chrono::steady_clock::now() + std::chrono::milliseconds(m_session.interval);
+
+                    if(m_sessionFrame)
+                    {
+                        m_session.skipped++;
+                        continue;
+                    }
+                }
+
+                std::unique_ptr<CaptureFrame> frame(new CaptureFrame());
+
+                if(!captureSessionFrame(previous, previous_width, previous_height, sequence, *frame))
+                    continue;
+
+                sequence++;
+
+                {
+                    std::lock_guard<std::mutex> lock(m_sessionMutex);
+                    m_sessionFrame = std::move(frame);
+                }
+                m_sessionCV.notify_all();
+            }
+        }
+
+        // Aborts the frame upload in flight when the session is stopped.
+        static int sessionProgressCallback(void *clientp, curl_off_t, curl_off_t, curl_off_t, curl_off_t)
+        {
+            return static_cast<std::atomic<bool> *>(clientp)->load() ? 1 : 0;
+        }
+
+        void ScreenCapture::uploadSessionLoop()
+        {
+            // A delta frame is only of use when the frame it was diffed against reached the receiver
+            bool delivered = false;
+            uint32_t last_delivered = 0;
+
+            while(true)
+            {
+                std::unique_ptr<CaptureFrame> frame;
+                {
+                    std::unique_lock<std::mutex> lock(m_sessionMutex);
+                    m_sessionCV.wait(lock, [this] { return m_sessionStop || m_sessionFrame; });
+                    if(m_sessionStop)
+                        break;
+                    frame = std::move(m_sessionFrame);
+
+                    // Captured while its base frame was still uploading and that upload failed
+                    if(!frame->key && (!delivered || frame->base != last_delivered))
+                    {
+                        LOGWARN("capture session frame %u dropped, its base frame %u was not delivered", frame->sequence, frame->base);
+                        m_session.failed++;
+                        m_sessionForceKey = true;
+                        continue;
+                    }
+                }
+
+                std::string error_str;
+                bool uploaded = uploadSessionFrame(*frame, error_str);
+
+                std::lock_guard<std::mutex> lock(m_sessionMutex);
+                if(uploaded)
+                {
+                    delivered = true;
+                    last_delivered = frame->sequence;
+                    m_session.uploaded++;
+                    for(const CaptureTile &tile : frame->tiles)
+                        m_session.bytes += tile.data.size();
+                }
+                else
+                {
+                    LOGERR("capture session frame %u upload failed: %s", frame->sequence, error_str.c_str());
+                    m_session.failed++;
+                    // The receiver lost a delta, start over from a full frame
+                    m_sessionForceKey = true;
+                }
+            }
+        }
+
+        bool ScreenCapture::uploadSessionFrame(const CaptureFrame &frame, std::string &error_str)
+        {
+            const std::string &format = m_session.options.format;
+            std::string extension = format == "jpeg" ? "jpg" : format;
+
+            curl_easy_reset(m_sessionCurl);
+
+            struct curl_slist *chunk = NULL;
+            chunk = curl_slist_append(chunk, ("X-Capture-Session: " + m_session.callGUID).c_str());
+            chunk = curl_slist_append(chunk, ("X-Frame-Sequence: " + std::to_string(frame.sequence)).c_str());
+            chunk = curl_slist_append(chunk, frame.key ? "X-Frame-Type: key" : "X-Frame-Type: delta");
+            chunk = curl_slist_append(chunk, ("X-Frame-Width: " + std::to_string(frame.width)).c_str());
+            chunk = curl_slist_append(chunk, ("X-Frame-Height: " + std::to_string(frame.height)).c_str());
+            chunk = curl_slist_append(chunk, ("X-Image-Format: " + format).c_str());
+
+            // One multipart/form-data part per tile, its position in the part's X-Tile header as "x,y,width,height"
+            curl_mime *mime = curl_mime_init(m_sessionCurl);
+            for(const CaptureTile &tile : frame.tiles)
+            {
+                std::string position = std::to_string(tile.x) + "," + std::to_string(tile.y) + "," + std::to_string(tile.width) + "," + std::to_string(tile.height);
+
+                curl_mimepart *part = curl_mime_addpart(mime);
+                curl_mime_name(part, "tile");
+                curl_mime_filename(part, ("tile_" + std::to_string(tile.x) + "_" + std::to_string(tile.y) + "." + extension).c_str());
+                curl_mime_data(part, (const char *)&tile.data[0], tile.data.size());
+                curl_mime_headers(part, curl_slist_append(NULL, ("X-Tile: " + position).c_str()), 1);
+            }
+
+            curl_easy_setopt(m_sessionCurl, CURLOPT_URL, m_session.url.c_str());
+            curl_easy_setopt(m_sessionCurl, CURLOPT_HTTPHEADER, chunk);
+            curl_easy_setopt(m_sessionCurl, CURLOPT_MIMEPOST, mime);
+
+            // A stalled receiver must not block stopSession() joining the upload thread
+            curl_easy_setopt(m_sessionCurl, CURLOPT_CONNECTTIMEOUT, (long)SESSION_CONNECT_TIMEOUT);
+            curl_easy_setopt(m_sessionCurl, CURLOPT_TIMEOUT, (long)SESSION_UPLOAD_TIMEOUT);
+            curl_easy_setopt(m_sessionCurl, CURLOPT_NOPROGRESS, 0L);
+            curl_easy_setopt(m_sessionCurl, CURLOPT_XFERINFOFUNCTION, sessionProgressCallback);
+            curl_easy_setopt(m_sessionCurl, CURLOPT_XFERINFODATA, &m_sessionStop);
+
+            CURLcode res = curl_easy_perform(m_sessionCurl);
+            bool call_succeeded = true;
+
+            if(CURLE_OK == res)
+            {
+                long response_code;
+
+                curl_easy_getinfo(m_sessionCurl, CURLINFO_RESPONSE_CODE, &response_code);
+
+                if(600 > response_code && response_code >= 400)
+                {
+                    error_str = std::string("response code:") + std::to_string(response_code);
+                    call_succeeded = false;
+                }
+            }
+            else
+            {
+                error_str = std::to_string(res) + std::string(":'") + std::string(curl_easy_strerror(res)) + std::string("'");
+                call_succeeded = false;
+            }
+
+            curl_mime_free(mime);
+            curl_slist_free_all(chunk);
+
+            return call_succeeded;
+        }
+
+        // Swaps the R and B channels of RGBA/BGRA pixels in place.
+        static void swapRedBlue(unsigned char *data, size_t pixels)
+        {
+            size_t i = 0;
+
+            #if defined(__SSSE3__)
+            const __m128i shuffle = _mm_setr_epi8(2, 1, 0, 3, 6, 5, 4, 7, 10, 9, 8, 11, 14, 13, 12, 15);
+            for(; i + 4 <= pixels; i += 4)
+            {
+                __m128i *p = (__m128i *)(data + i * 4);
+                _mm_storeu_si128(p, _mm_shuffle_epi8(_mm_loadu_si128(p), shuffle));
+            }
+            #elif defined(__SSE2__)
+            const __m128i green_alpha = _mm_set1_epi32(0xFF00FF00);
+            const __m128i red_blue = _mm_set1_epi32(0x00FF00FF);
+            for(; i + 4 <= pixels; i += 4)
+            {
+                __m128i *p = (__m128i *)(data + i * 4);
+                __m128i v = _mm_loadu_si128(p);
+                __m128i rb = _mm_and_si128(v, red_blue);
+                rb = _mm_or_si128(_mm_slli_epi32(rb, 16), _mm_srli_epi32(rb, 16));
+                _mm_storeu_si128(p, _mm_or_si128(_mm_and_si128(v, green_alpha), _mm_and_si128(rb, red_blue)));
+            }
+            #elif defined(__ARM_NEON) || defined(__ARM_NEON__)
+            for(; i + 16 <= pixels; i += 16)
+            {
+                uint8x16x4_t v = vld4q_u8(data + i * 4);
+                uint8x16_t red = v.val[0];
+                v.val[0] = v.val[2];
+                v.val[2] = red;
+                vst4q_u8(data + i * 4, v);
+            }
+            #endif
+
+            for(; i < pixels; i++)
+            {
+                unsigned char *color = data + i * 4;
+                unsigned char blue = color[0];
+                color[0] = color[2];
+                color[2] = blue;
+            }
+        }
+
+        bool ScreenCapture::encodeImage(const unsigned char *rgba, int w, int h, int stride, ImageOptions &options, std::vector<unsigned char> &image_out_data)
+        {
+            auto started = std::chrono::steady_clock::now();
+            bool result = false;
+
+            options.width = w;
+            options.height = h;
+
+            if(options.format == "raw")
+            {
+                image_out_data.resize((size_t)w * h * 4);
+                for(int row = 0; row < h; row++)
+                    memcpy(&image_out_data[(size_t)row * w * 4], rgba + (size_t)row * stride, (size_t)w * 4);
+                result = true;
+            }
+            #ifdef HAS_JPEG
+            else if(options.format == "jpeg")
+                result = saveToJpeg(rgba, w, h, stride, options, image_out_data);
+            #endif
+            else
+                result = saveToPng(rgba, w, h, stride, options, image_out_data);
+
+            options.encodeTime = std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now() - started).count();
+            LOGINFO("encoded %dx%d to %d bytes of %s in %llu us", w, h, (int)image_out_data.size(), options.format.c_str(), (unsigned long long)options.encodeTime);
+
+            return result;
+        }
+
 #ifdef PLATFORM_INTEL
-        bool ScreenCapture::getScreenshotIntel(std::vector<unsigned char> &png_out_data)
+        bool ScreenCapture::getScreenshotIntel(ImageOptions &options, std::vector<unsigned char> &image_out_data)
         {
-            int i;
             char *filename = "/proc/gdl/dump/wbp";    //both video and guide graphics, potentially at lower 720x480
 //             char *filename = "/proc/gdl/dump/upp_d"; //graphics only, normally at higher 1280x720
 //             char *filename = "/proc/gdl/dump/upp_a"; //video only, normally at higher 1280x720
@@ -206,27 +911,16 @@ namespace WPEFramework
             }
 
             std::vector<unsigned char> data_v(size);
-            std::vector<unsigned char> new_data_v(size);
 
             unsigned char* data = &data_v[0];
-            unsigned char* new_data = &new_data_v[0];
 
             fread(data, sizeof(unsigned char), size, fp); // read the rest of the data at once
             fclose(fp);
 
-            for(i = 0; i < size; i += 4)
-            {
-                //r and b need swapped?
-                new_data[i+0] = data[i+2];
-                new_data[i+1] = data[i+1];
-                new_data[i+2] = data[i+0];
-                new_data[i+3] = data[i+3];
-            }
-
-            //convert to png
-            saveToPng(new_data, w, h, png_out_data);
+            //r and b need swapped
+            swapRedBlue(data, (size_t)w * h);
 
-            return true;
+            return encodeImage(data, w, h, 4 * w, options, image_out_data);
         }
 #endif
 
@@ -256,7 +950,7 @@ namespace WPEFramework
             return true;
         }
 
-        bool ScreenCapture::getScreenshotNexus(std::vector<unsigned char> &png_out_data)
+        bool ScreenCapture::getScreenshotNexus(ImageOptions &options, std::vector<unsigned char> &image_out_data)
         {
             if(!joinNexus())
             {
@@ -288,9 +982,6 @@ namespace WPEFramework
             //defSurfSettings.pixelFormat = NEXUS_PixelFormat_eA8_R8_G8_B8;
             defSurfSettings.pixelFormat = NEXUS_PixelFormat_eA8_B8_G8_R8;
             int bytesPerPixel = 4;
-            std::vector<unsigned char> data_v(1280 * 720 * 4);
-            unsigned char *bytes = &data_v[0];
-//             unsigned char bytes[1280 * 720 * 4];
 
 
             NEXUS_SurfaceHandle surface = NEXUS_Surface_Create( &defSurfSettings );
@@ -322,7 +1013,12 @@ namespace WPEFramework
                         pSurfaceMemory, properties.pixelMemoryOffset, defSurfSettings.width, defSurfSettings.height, bytesPerPixel);
             }
 
-            memcpy(bytes, (const char*) pSurfaceMemory + properties.pixelMemoryOffset, defSurfSettings.width * defSurfSettings.height * bytesPerPixel);
+            // eA8_B8_G8_R8 is RGBA in memory already, encode straight from the surface instead of copying it first.
+            if(!encodeImage((const unsigned char*) pSurfaceMemory + properties.pixelMemoryOffset, defSurfSettings.width, defSurfSettings.height, properties.pitch, options, image_out_data))
+            {
+                LOGERR("could not encode Nexus screenshot");
+                res = false;
+            }
 
             NEXUS_Surface_Unlock( surface );
 
@@ -337,13 +1033,7 @@ namespace WPEFramework
                 return false;
             }
 
-            if(!saveToPng(bytes, defSurfSettings.width, defSurfSettings.height, png_out_data))
-            {
-                LOGERR("could not convert Nexus screenshot to png");
-                return false;
-            }
-            else
-                return true;
+            return true;
         }
 #endif
 
@@ -365,7 +1055,7 @@ namespace WPEFramework
             LOGWARN("VNCServerLogMessage called");
         }
 
-        bool ScreenCapture::getScreenshotRealtek(std::vector<unsigned char> &png_out_data)
+        bool ScreenCapture::getScreenshotRealtek(ImageOptions &options, std::vector<unsigned char> &image_out_data)
         {
             ErrCode err;
             vnc_bool_t result;
@@ -426,20 +1116,11 @@ namespace WPEFramework
                 LOGINFO("fbGetFramebuffer=ok"); 
 
                 for(unsigned int n = 0; n < h; n++)
-                {
-                    for(unsigned int i = 0; i < w; i++)
-                    {
-                        unsigned char *color = buffer + n * s + i * 4;
-
-                        unsigned char blue = color[0];
-                        color[0] =  color[2];
-                        color[2] = blue;
-                    }
-                }
+                    swapRedBlue(buffer + n * s, w);
 
-                if(!saveToPng(buffer, w, h, png_out_data))
+                if(!encodeImage(buffer, w, h, s, options, image_out_data))
                 {
-                    LOGERR("could not convert Nexus screenshot to png");
+                    LOGERR("could not encode Realtek screenshot");
                     fbDestroy(context);
                     return false;
                 }
@@ -465,7 +1146,7 @@ namespace WPEFramework
             p->insert(p->end(), data, data + length);
         }
 
-        bool ScreenCapture::uploadDataToUrl(std::vector<unsigned char> &data, const char *url, std::string &error_str)
+        bool ScreenCapture::uploadDataToUrl(std::vector<unsigned char> &data, const char *url, const std::vector<std::string> &headers, std::string &error_str)
         {
             CURL *curl;
             CURLcode res;
@@ -477,7 +1158,7 @@ namespace WPEFramework
                 return false;
             }
 
-            LOGWARN("uploading png data of size %u to '%s'", data.size(), url);
+            LOGWARN("uploading image data of size %u to '%s'", data.size(), url);
 
             //init curl
             curl_global_init(CURL_GLOBAL_ALL);
@@ -491,7 +1172,8 @@ namespace WPEFramework
 
             //create header
             struct curl_slist *chunk = NULL;
-            chunk = curl_slist_append(chunk, "Content-Type: image/png");
+            for(const std::string &header : headers)
+                chunk = curl_slist_append(chunk, header.c_str());
 
             //set url and data
             curl_easy_setopt(curl, CURLOPT_URL, url);
@@ -532,11 +1214,10 @@ namespace WPEFramework
             return call_succeeded;
         }
 
-        bool ScreenCapture::saveToPng(unsigned char *data, int width, int height, std::vector<unsigned char> &png_out_data)
+        bool ScreenCapture::saveToPng(const unsigned char *data, int width, int height, int pitch, const ImageOptions &options, std::vector<unsigned char> &png_out_data)
         {
             int bitdepth = 8;
             int colortype = PNG_COLOR_TYPE_RGBA;
-            int pitch = 4 * width;
             int transform = PNG_TRANSFORM_IDENTITY;
 
             int i = 0;
@@ -585,10 +1266,19 @@ namespace WPEFramework
                             PNG_COMPRESSION_TYPE_BASE,
                             PNG_FILTER_TYPE_BASE);
 
+            // Lower levels and a single filter trade size for a lot of encoding time
+            if (options.compression >= 0)
+                png_set_compression_level(png_ptr, options.compression);
+            if (options.filter >= 0)
+                png_set_filter(png_ptr, PNG_FILTER_TYPE_BASE, options.filter);
+
+            // Screens usually compress to well under a byte per pixel, reserve that to avoid regrowing the output
+            png_out_data.reserve((size_t)width * height);
+
             row_pointers = (png_bytep*)malloc(sizeof(png_bytep) * height);
 
             for (i = 0; i < height; ++i)
-                row_pointers[i] = data + i * pitch;
+                row_pointers[i] = (png_bytep)(data + i * pitch);
 
             png_set_write_fn(png_ptr, &png_out_data, PngWriteCallback, NULL);
             png_set_rows(png_ptr, info_ptr, row_pointers);
@@ -618,5 +1308,93 @@ namespace WPEFramework
             return (r==0);
         }
 
+#ifdef HAS_JPEG
+        // the default libjpeg error handler calls exit(), this one returns to saveToJpeg instead
+        struct JpegErrorManager
+        {
+            struct jpeg_error_mgr pub;
+            jmp_buf setjmp_buffer;
+        };
+
+        static void JpegErrorExit(j_common_ptr cinfo)
+        {
+            char message[JMSG_LENGTH_MAX];
+            (*cinfo->err->format_message)(cinfo, message);
+            LOGERR("jpeg encoding failed: %s", message);
+
+            longjmp(((JpegErrorManager *)cinfo->err)->setjmp_buffer, 1);
+        }
+
+        bool ScreenCapture::saveToJpeg(const unsigned char *data, int width, int height, int pitch, const ImageOptions &options, std::vector<unsigned char> &jpeg_out_data)
+        {
+            struct jpeg_compress_struct cinfo;
+            JpegErrorManager jerr;
+            unsigned char *buffer = NULL;
+            unsigned long size = 0;
+#ifndef JCS_EXTENSIONS
+            // declared before setjmp so that a longjmp back does not skip its destructor
+            std::vector<unsigned char> row_v(3 * width);
+#endif
+
+            cinfo.err = jpeg_std_error(&jerr.pub);
+            jerr.pub.error_exit = JpegErrorExit;
+            if (setjmp(jerr.setjmp_buffer))
+            {
+                jpeg_destroy_compress(&cinfo);
+                if (NULL != buffer)
+                    free(buffer);
+                return false;
+            }
+
+            jpeg_create_compress(&cinfo);
+            jpeg_mem_dest(&cinfo, &buffer, &size);
+
+            cinfo.image_width = width;
+            cinfo.image_height = height;
+#ifdef JCS_EXTENSIONS
+            // libjpeg-turbo reads RGBA directly and skips the alpha channel
+            cinfo.input_components = 4;
+            cinfo.in_color_space = JCS_EXT_RGBX;
+#else
+            cinfo.input_components = 3;
+            cinfo.in_color_space = JCS_RGB;
+#endif
+            jpeg_set_defaults(&cinfo);
+            jpeg_set_quality(&cinfo, options.quality, TRUE);
+            jpeg_start_compress(&cinfo, TRUE);
+
+            while (cinfo.next_scanline < cinfo.image_height)
+            {
+                const unsigned char *src = data + cinfo.next_scanline * pitch;
+#ifdef JCS_EXTENSIONS
+                JSAMPROW row = (JSAMPROW)src;
+#else
+                for (int i = 0; i < width; i++)
+                {
+                    row_v[i * 3 + 0] = src[i * 4 + 0];
+                    row_v[i * 3 + 1] = src[i * 4 + 1];
+                    row_v[i * 3 + 2] = src[i * 4 + 2];
+                }
+                JSAMPROW row = &row_v[0];
+#endif
+                jpeg_write_scanlines(&cinfo, &row, 1);
+            }
+
+            jpeg_finish_compress(&cinfo);
+            jpeg_destroy_compress(&cinfo);
+
+            if (NULL == buffer)
+            {
+                LOGERR("jpeg encoding produced no data");
+                return false;
+            }
+
+            jpeg_out_data.assign(buffer, buffer + size);
+            free(buffer);
+
+            return true;
+        }
+#endif
+
     } // namespace Plugin
 } // namespace WPEFramework
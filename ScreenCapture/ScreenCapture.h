@@ -19,9 +19,17 @@
 
 #pragma once
 
+#include <atomic>
+#include <condition_variable>
+#include <map>
+#include <memory>
 #include <mutex>
+#include <string>
+#include <thread>
 #include <vector>
 
+#include <curl/curl.h>
+
 #include "tptimer.h"
 
 #include "Module.h"
@@ -34,6 +42,63 @@ namespace WPEFramework {
 
         class ScreenCapture;
 
+        // How a captured frame is encoded before the upload.
+        struct ImageOptions
+        {
+            ImageOptions() : format("png"), compression(-1), filter(-1), quality(85), encodeTime(0), width(0), height(0) { }
+
+            std::string format; // "png", "jpeg" or "raw" (RGBA)
+            int compression;    // zlib level 0-9 for png, -1 is the libpng default
+            int filter;         // PNG_FILTER_* mask for png, -1 is the libpng default
+            int quality;        // 1-100 for jpeg
+            uint64_t encodeTime; // out: time spent encoding, in microseconds
+            int width;           // out: size of the captured frame
+            int height;
+        };
+
+        // A rectangle of a session frame, encoded on its own.
+        struct CaptureTile
+        {
+            int x;
+            int y;
+            int width;
+            int height;
+            std::vector<unsigned char> data;
+        };
+
+        // One frame of a capture session: the whole (downscaled) screen for a key frame,
+        // only the tiles that changed since the previous frame otherwise.
+        struct CaptureFrame
+        {
+            uint32_t sequence;
+            uint32_t base; // sequence of the frame a delta frame was diffed against
+            bool key;
+            int width;
+            int height;
+            std::vector<CaptureTile> tiles;
+        };
+
+        // Settings and counters of a periodic capture session.
+        struct CaptureSession
+        {
+            CaptureSession() : interval(1000), width(0), height(0), tileSize(64), captured(0), uploaded(0), unchanged(0), skipped(0), failed(0), bytes(0) { }
+
+            std::string url;
+            std::string callGUID;
+            ImageOptions options;
+            uint32_t interval; // ms between captures
+            int width;         // target resolution, 0 keeps the screen size or the aspect ratio
+            int height;
+            int tileSize;
+
+            uint32_t captured;  // frames grabbed from the screen
+            uint32_t uploaded;  // frames uploaded successfully
+            uint32_t unchanged; // frames dropped because nothing changed
+            uint32_t skipped;   // ticks skipped because the previous frame was still waiting for the upload
+            uint32_t failed;    // failed captures or uploads
+            uint64_t bytes;     // encoded bytes uploaded
+        };
+
         class ScreenShotJob
         {
         private:
@@ -41,8 +106,8 @@ namespace WPEFramework {
             ScreenShotJob& operator=(const ScreenShotJob& RHS) = delete;
 
         public:
-            ScreenShotJob(WPEFramework::Plugin::ScreenCapture* tpt, std::string _url, std::string _callGUID) : m_screenCapture(tpt), url(_url), callGUID(_callGUID) { }
-            ScreenShotJob(const ScreenShotJob& copy) : m_screenCapture(copy.m_screenCapture), url(copy.url), callGUID(copy.callGUID) { }
+            ScreenShotJob(WPEFramework::Plugin::ScreenCapture* tpt, std::string _url, std::string _callGUID, const ImageOptions& _options) : m_screenCapture(tpt), url(_url), callGUID(_callGUID), options(_options) { }
+            ScreenShotJob(const ScreenShotJob& copy) : m_screenCapture(copy.m_screenCapture), url(copy.url), callGUID(copy.callGUID), options(copy.options) { }
             ~ScreenShotJob() {}
 
             inline bool operator==(const ScreenShotJob& RHS) const
@@ -59,6 +124,7 @@ namespace WPEFramework {
             WPEFramework::Plugin::ScreenCapture* m_screenCapture;
             std::string url;
             std::string callGUID;
+            ImageOptions options;
         };
 
         // This is a server for a JSONRPC communication channel.
@@ -82,24 +148,41 @@ namespace WPEFramework {
 
             //Begin methods
             uint32_t uploadScreenCapture(const JsonObject& parameters, JsonObject& response);
+            uint32_t startCaptureSession(const JsonObject& parameters, JsonObject& response);
+            uint32_t stopCaptureSession(const JsonObject& parameters, JsonObject& response);
+            uint32_t getCaptureSessionStatus(const JsonObject& parameters, JsonObject& response);
             //End methods
 
+            bool parseImageOptions(const JsonObject& parameters, ImageOptions& options, std::string& message);
+
             #ifdef PLATFORM_BROADCOM
-            bool getScreenshotNexus(std::vector<unsigned char> &png_data);
+            bool getScreenshotNexus(ImageOptions &options, std::vector<unsigned char> &image_data);
             bool joinNexus();
             #endif
 
             #ifdef PLATFORM_INTEL
-            bool getScreenshotIntel(std::vector<unsigned char> &png_data);
+            bool getScreenshotIntel(ImageOptions &options, std::vector<unsigned char> &image_data);
             #endif
 
             #ifdef HAS_FRAMEBUFFER_API_HEADER
-            bool getScreenshotRealtek(std::vector<unsigned char> &png_data);
+            bool getScreenshotRealtek(ImageOptions &options, std::vector<unsigned char> &image_data);
             #endif
 
-            bool saveToPng(unsigned char *bytes, int w, int h, std::vector<unsigned char> &png_out_data);
-            bool uploadDataToUrl(std::vector<unsigned char> &data, const char *url, std::string &error_str);
-            bool doUploadScreenCapture(std::string url, std::string callGUID);
+            bool grabScreenshot(ImageOptions &options, std::vector<unsigned char> &image_data);
+            bool encodeImage(const unsigned char *rgba, int w, int h, int stride, ImageOptions &options, std::vector<unsigned char> &image_out_data);
+            bool saveToPng(const unsigned char *bytes, int w, int h, int stride, const ImageOptions &options, std::vector<unsigned char> &png_out_data);
+            #ifdef HAS_JPEG
+            bool saveToJpeg(const unsigned char *bytes, int w, int h, int stride, const ImageOptions &options, std::vector<unsigned char> &jpeg_out_data);
+            #endif
+            bool uploadDataToUrl(std::vector<unsigned char> &data, const char *url, const std::vector<std::string> &headers, std::string &error_str);
+            bool doUploadScreenCapture(std::string url, std::string callGUID, ImageOptions options);
+
+            void captureSessionLoop();
+            void uploadSessionLoop();
+            bool captureSessionFrame(std::vector<unsigned char> &previous, int &previous_width, int &previous_height, uint32_t sequence, CaptureFrame &frame);
+            bool uploadSessionFrame(const CaptureFrame &frame, std::string &error_str);
+            void stopSession();
+            void sessionStatus(JsonObject &response);
 
         public:
             ScreenCapture();
@@ -113,6 +196,21 @@ namespace WPEFramework {
 
             WPEFramework::Core::TimerType<ScreenShotJob> *screenShotDispatcher;
 
+            std::mutex m_grabMutex; // one grabber user at a time, single shots and the session share the device
+
+            // Capture session: the capture thread hands at most one frame to the upload thread,
+            // ticks are skipped while that frame is still waiting.
+            CaptureSession m_session;
+            bool m_sessionActive;
+            std::atomic<bool> m_sessionStop; // also polled by curl while a frame is uploading
+            bool m_sessionForceKey; // set by the upload thread when the receiver missed a frame
+            std::unique_ptr<CaptureFrame> m_sessionFrame;
+            std::mutex m_sessionMutex;
+            std::condition_variable m_sessionCV;
+            std::thread m_captureThread;
+            std::thread m_uploadThread;
+            CURL *m_sessionCurl; // reused between frames to keep the connection alive, upload thread only
+
             #ifdef PLATFORM_BROADCOM
             bool inNexus;
             #endif
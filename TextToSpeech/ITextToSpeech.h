@@ -46,6 +46,7 @@ namespace Exchange {
         virtual uint32_t Resume(const string &input, string &output /* @out */) = 0;
         virtual uint32_t IsSpeaking(const string &input, string &output /* @out */) = 0;
         virtual uint32_t GetSpeechState(const string &input, string &output /* @out */) = 0;
+        virtual uint32_t GetCacheStats(const string &input, string &output /* @out */) = 0;
 
     };
 
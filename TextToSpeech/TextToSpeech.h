@@ -157,6 +157,7 @@ namespace Plugin {
         uint32_t Resume(const JsonObject& parameters, JsonObject& response);
         uint32_t IsSpeaking(const JsonObject& parameters, JsonObject& response);
         uint32_t GetSpeechState(const JsonObject& parameters, JsonObject& response);
+        uint32_t GetCacheStats(const JsonObject& parameters, JsonObject& response);
 
         //version number API's
         uint32_t getapiversion(const JsonObject& parameters, JsonObject& response);
@@ -82,6 +82,13 @@ namespace Plugin {
         } else {
             TTSLOG_WARNING("Doesn't find default voice configuration");
         }
+        if(config.HasLabel("cache")) {
+            JsonObject cache = config["cache"].Object();
+            _ttsManager->configureCache(GET_STR(cache, "path", ""),
+                    cache.HasLabel("memorysize") ? cache["memorysize"].Number() : TTS_CACHE_MEMORY_SIZE,
+                    cache.HasLabel("disksize") ? cache["disksize"].Number() : TTS_CACHE_DISK_SIZE);
+        }
+
         ttsConfig->loadFromConfigStore();
         TTSLOG_INFO("TTSEndPoint : %s", ttsConfig->endPoint().c_str());
         TTSLOG_INFO("SecureTTSEndPoint : %s", ttsConfig->secureEndPoint().c_str());
@@ -354,6 +361,33 @@ namespace Plugin {
         returnResponse(status == TTS::TTS_OK);
     }
 
+    uint32_t TextToSpeechImplementation::GetCacheStats(const string &input, string &output)
+    {
+        CONVERT_PARAMETERS_TOJSON();
+        CHECK_TTS_MANAGER_RETURN_ON_FAIL();
+
+        TTS::TTSCacheStats stats;
+        auto status = _ttsManager->getCacheStats(stats);
+
+        if(status == TTS::TTS_OK) {
+            uint64_t lookups = stats.hits + stats.misses;
+            response["hits"] = JsonValue((int64_t)stats.hits);
+            response["misses"] = JsonValue((int64_t)stats.misses);
+            response["hitrate"] = JsonValue((int)(lookups ? (stats.hits * 100) / lookups : 0));
+            response["memoryhits"] = JsonValue((int64_t)stats.memoryHits);
+            response["diskhits"] = JsonValue((int64_t)stats.diskHits);
+            response["evictions"] = JsonValue((int64_t)stats.evictions);
+            response["bytesserved"] = JsonValue((int64_t)stats.bytesServed);
+            response["memorybytes"] = JsonValue((int64_t)stats.memoryBytes);
+            response["memoryentries"] = JsonValue((int)stats.memoryEntries);
+            response["diskbytes"] = JsonValue((int64_t)stats.diskBytes);
+            response["diskentries"] = JsonValue((int)stats.diskEntries);
+        }
+
+        logResponse(status, response);
+        returnResponse(status == TTS::TTS_OK);
+    }
+
     void TextToSpeechImplementation::setResponseArray(JsonObject& response, const char* key, const std::vector<std::string>& items)
     {
         JsonArray arr;
@@ -480,6 +514,16 @@ namespace Plugin {
         JsonObject params;
         params["speechid"]  = JsonValue((int)data.id);
         params["text"]      = data.text;
+
+        JsonObject metrics;
+        metrics["firstbyte"]  = JsonValue((int)data.metrics.firstByte);
+        metrics["download"]   = JsonValue((int)data.metrics.download);
+        metrics["firstaudio"] = JsonValue((int)data.metrics.firstAudio);
+        metrics["total"]      = JsonValue((int)data.metrics.total);
+        metrics["bytes"]      = JsonValue((int)data.metrics.bytes);
+        metrics["prefetched"] = JsonValue((bool)data.metrics.prefetched);
+        metrics["cached"]     = JsonValue((bool)data.metrics.cached);
+        params["metrics"]     = metrics;
         dispatchEvent(SPEECH_COMPLETE, params);
     }
 
@@ -35,6 +35,7 @@ namespace Plugin {
         registerMethod("resume", &TextToSpeech::Resume, this);
         registerMethod("isspeaking", &TextToSpeech::IsSpeaking, this);
         registerMethod("getspeechstate", &TextToSpeech::GetSpeechState, this);
+        registerMethod("getcachestats", &TextToSpeech::GetCacheStats, this);
         registerMethod("getapiversion", &TextToSpeech::getapiversion, this);
     }
 
@@ -169,6 +170,18 @@ namespace Plugin {
         return Core::ERROR_NONE;
     }
 
+    uint32_t TextToSpeech::GetCacheStats(const JsonObject& parameters, JsonObject& response)
+    {
+        if(_tts) {
+            string params, result;
+            parameters.ToString(params);
+            uint32_t ret = _tts->GetCacheStats(params, result);
+            response.FromString(result);
+            return ret;
+        }
+        return Core::ERROR_NONE;
+    }
+
     uint32_t TextToSpeech::getapiversion(const JsonObject& parameters, JsonObject& response)
     {
         UNUSED(parameters);
@@ -0,0 +1,343 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2020 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#include "TTSCache.h"
+#include "logger.h"
+
+#include <dirent.h>
+#include <errno.h>
+#include <stdio.h>
+#include <string.h>
+#include <sys/stat.h>
+#include <utime.h>
+
+#include <algorithm>
+#include <fstream>
+#include <iterator>
+
+#define TTS_CACHE_SUFFIX ".tts"
+
+namespace TTS {
+
+TTSCache::TTSCache() :
+    m_memorySize(TTS_CACHE_MEMORY_SIZE),
+    m_diskSize(0),
+    m_memoryBytes(0),
+    m_diskBytes(0) {
+}
+
+TTSCache::~TTSCache() {
+}
+
+void TTSCache::configure(const std::string &path, uint64_t memorySize, uint64_t diskSize) {
+    std::vector<std::string> removed;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        m_memorySize = memorySize;
+        m_diskSize = path.empty() ? 0 : diskSize;
+        trimMemory();
+
+        if(path != m_path) {
+            m_path = path;
+            m_disk.clear();
+            m_diskIndex.clear();
+            m_diskBytes = 0;
+
+            if(m_diskSize) {
+                if(mkdir(m_path.c_str(), 0700) != 0 && errno != EEXIST) {
+                    TTSLOG_ERROR("Cannot create cache directory %s: %s", m_path.c_str(), strerror(errno));
+                    m_diskSize = 0;
+                } else {
+                    loadDisk();
+                }
+            }
+        }
+        trimDisk(removed);
+
+        TTSLOG_INFO("Audio cache: %llu bytes in memory, %llu bytes on disk%s%s",
+                (unsigned long long)m_memorySize, (unsigned long long)m_diskSize,
+                m_diskSize ? " at " : "", m_diskSize ? m_path.c_str() : "");
+    }
+
+    for(auto &file : removed)
+        unlink(file.c_str());
+}
+
+bool TTSCache::get(const std::string &key, Audio &audio) {
+    std::string file;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        auto it = m_memoryIndex.find(key);
+        if(it != m_memoryIndex.end()) {
+            m_memory.splice(m_memory.begin(), m_memory, it->second);
+            audio = it->second->audio;
+
+            m_stats.hits++;
+            m_stats.memoryHits++;
+            m_stats.bytesServed += audio->size();
+            return true;
+        }
+
+        auto dit = m_diskIndex.find(fileName(key));
+        if(dit == m_diskIndex.end()) {
+            m_stats.misses++;
+            return false;
+        }
+
+        m_disk.splice(m_disk.begin(), m_disk, dit->second);
+        file = m_path + "/" + dit->first;
+    }
+
+    // Read outside the lock, a slow flash must not hold up the other lookups
+    std::shared_ptr<std::vector<char>> data = std::make_shared<std::vector<char>>();
+    bool found = readFile(file, key, *data);
+
+    std::lock_guard<std::mutex> lock(m_mutex);
+    if(!found) {
+        // Gone or taken by another key with the same hash, let put() write it again
+        auto dit = m_diskIndex.find(fileName(key));
+        if(dit != m_diskIndex.end() && m_path + "/" + dit->first == file) {
+            m_diskBytes -= dit->second->size;
+            m_disk.erase(dit->second);
+            m_diskIndex.erase(dit);
+        }
+        m_stats.misses++;
+        return false;
+    }
+
+    // Keep the LRU order across restarts
+    utime(file.c_str(), NULL);
+
+    audio = data;
+    putMemory(key, audio);
+
+    m_stats.hits++;
+    m_stats.diskHits++;
+    m_stats.bytesServed += audio->size();
+    return true;
+}
+
+void TTSCache::put(const std::string &key, const std::vector<char> &audio) {
+    if(audio.empty())
+        return;
+
+    std::string file;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if(audio.size() <= m_memorySize && m_memoryIndex.find(key) == m_memoryIndex.end())
+            putMemory(key, std::make_shared<const std::vector<char>>(audio));
+
+        if(!m_diskSize || audio.size() > m_diskSize || m_diskIndex.find(fileName(key)) != m_diskIndex.end())
+            return;
+
+        file = m_path;
+    }
+
+    std::string name = fileName(key);
+    if(!writeFile(file + "/" + name, key, audio))
+        return;
+
+    std::vector<std::string> removed;
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        if(file != m_path || m_diskIndex.find(name) != m_diskIndex.end())
+            return;
+
+        uint64_t size = key.size() + 1 + audio.size();
+        m_disk.push_front({ name, size });
+        m_diskIndex[name] = m_disk.begin();
+        m_diskBytes += size;
+        trimDisk(removed);
+    }
+
+    for(auto &path : removed)
+        unlink(path.c_str());
+}
+
+void TTSCache::clear() {
+    std::vector<std::string> removed;
+
+    {
+        std::lock_guard<std::mutex> lock(m_mutex);
+
+        m_memory.clear();
+        m_memoryIndex.clear();
+        m_memoryBytes = 0;
+
+        for(auto &entry : m_disk)
+            removed.push_back(m_path + "/" + entry.file);
+        m_disk.clear();
+        m_diskIndex.clear();
+        m_diskBytes = 0;
+    }
+
+    for(auto &file : removed)
+        unlink(file.c_str());
+}
+
+TTSCacheStats TTSCache::stats() {
+    std::lock_guard<std::mutex> lock(m_mutex);
+
+    TTSCacheStats stats = m_stats;
+    stats.memoryBytes = m_memoryBytes;
+    stats.memoryEntries = m_memory.size();
+    stats.diskBytes = m_diskBytes;
+    stats.diskEntries = m_disk.size();
+    return stats;
+}
+
+// Stable across builds and restarts, unlike std::hash (64 bit FNV-1a)
+std::string TTSCache::fileName(const std::string &key) {
+    uint64_t hash = 0xcbf29ce484222325ULL;
+    for(unsigned char c : key) {
+        hash ^= c;
+        hash *= 0x100000001b3ULL;
+    }
+
+    char name[32];
+    snprintf(name, sizeof(name), "%016llx" TTS_CACHE_SUFFIX, (unsigned long long)hash);
+    return name;
+}
+
+// A cache file holds the key on the first line, followed by the audio. The key
+// is checked on read, so a hash collision is a miss and not the wrong speech.
+bool TTSCache::readFile(const std::string &file, const std::string &key, std::vector<char> &audio) {
+    std::ifstream in(file, std::ios::binary);
+    std::string stored;
+
+    if(!in || !std::getline(in, stored) || stored != key)
+        return false;
+
+    audio.assign(std::istreambuf_iterator<char>(in), std::istreambuf_iterator<char>());
+    return !audio.empty();
+}
+
+bool TTSCache::writeFile(const std::string &file, const std::string &key, const std::vector<char> &audio) {
+    // Written aside and renamed, a file in the cache is always complete
+    std::string temp = file + ".tmp";
+
+    {
+        std::ofstream out(temp, std::ios::binary | std::ios::trunc);
+        out << key << '\n';
+        out.write(audio.data(), audio.size());
+        if(!out) {
+            TTSLOG_WARNING("Cannot write cache file %s", temp.c_str());
+            out.close();
+            unlink(temp.c_str());
+            return false;
+        }
+    }
+
+    if(rename(temp.c_str(), file.c_str()) != 0) {
+        TTSLOG_WARNING("Cannot rename cache file %s: %s", temp.c_str(), strerror(errno));
+        unlink(temp.c_str());
+        return false;
+    }
+
+    return true;
+}
+
+void TTSCache::loadDisk() {
+    DIR *dir = opendir(m_path.c_str());
+    if(!dir)
+        return;
+
+    std::vector<std::pair<time_t, DiskEntry>> entries;
+    size_t suffix = strlen(TTS_CACHE_SUFFIX);
+    struct dirent *ent;
+
+    while((ent = readdir(dir)) != NULL) {
+        std::string name = ent->d_name;
+        std::string file = m_path + "/" + name;
+        struct stat st;
+
+        if(name.size() > 4 && name.compare(name.size() - 4, 4, ".tmp") == 0) {
+            // Left over from an interrupted write
+            unlink(file.c_str());
+            continue;
+        }
+
+        if(name.size() <= suffix || name.compare(name.size() - suffix, suffix, TTS_CACHE_SUFFIX) != 0)
+            continue;
+
+        if(stat(file.c_str(), &st) != 0 || !S_ISREG(st.st_mode))
+            continue;
+
+        entries.push_back(std::make_pair(st.st_mtime, DiskEntry{ name, (uint64_t)st.st_size }));
+    }
+    closedir(dir);
+
+    // Most recently used first, files are touched on every hit
+    std::sort(entries.begin(), entries.end(),
+            [] (const std::pair<time_t, DiskEntry> &a, const std::pair<time_t, DiskEntry> &b) { return a.first > b.first; });
+
+    for(auto &entry : entries) {
+        m_disk.push_back(entry.second);
+        m_diskIndex[entry.second.file] = std::prev(m_disk.end());
+        m_diskBytes += entry.second.size;
+    }
+
+    TTSLOG_INFO("Loaded %u cached speeches, %llu bytes", (unsigned)m_disk.size(), (unsigned long long)m_diskBytes);
+}
+
+void TTSCache::putMemory(const std::string &key, Audio audio) {
+    auto it = m_memoryIndex.find(key);
+    if(it != m_memoryIndex.end()) {
+        m_memoryBytes -= it->second->audio->size();
+        m_memory.erase(it->second);
+        m_memoryIndex.erase(it);
+    }
+
+    m_memory.push_front({ key, audio });
+    m_memoryIndex[key] = m_memory.begin();
+    m_memoryBytes += audio->size();
+    trimMemory();
+}
+
+// Dropping from memory is not an eviction as long as the entry stays on disk
+void TTSCache::trimMemory() {
+    while(m_memoryBytes > m_memorySize && !m_memory.empty()) {
+        MemoryEntry &entry = m_memory.back();
+        if(!m_diskSize)
+            m_stats.evictions++;
+        m_memoryBytes -= entry.audio->size();
+        m_memoryIndex.erase(entry.key);
+        m_memory.pop_back();
+    }
+}
+
+void TTSCache::trimDisk(std::vector<std::string> &removed) {
+    while(m_diskBytes > m_diskSize && !m_disk.empty()) {
+        DiskEntry &entry = m_disk.back();
+        removed.push_back(m_path + "/" + entry.file);
+        m_stats.evictions++;
+        m_diskBytes -= entry.size;
+        m_diskIndex.erase(entry.file);
+        m_disk.pop_back();
+    }
+}
+
+} // namespace TTS
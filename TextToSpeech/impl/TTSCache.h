@@ -0,0 +1,107 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2020 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+#ifndef _TTS_CACHE_H_
+#define _TTS_CACHE_H_
+
+#include <stdint.h>
+
+#include <list>
+#include <mutex>
+#include <memory>
+#include <string>
+#include <vector>
+#include <unordered_map>
+
+namespace TTS {
+
+#define TTS_CACHE_MEMORY_SIZE (2 * 1024 * 1024)
+#define TTS_CACHE_DISK_SIZE (16 * 1024 * 1024)
+
+struct TTSCacheStats {
+    TTSCacheStats() : hits(0), memoryHits(0), diskHits(0), misses(0), evictions(0), bytesServed(0),
+        memoryBytes(0), memoryEntries(0), diskBytes(0), diskEntries(0) {}
+
+    uint64_t hits;
+    uint64_t memoryHits;
+    uint64_t diskHits;
+    uint64_t misses;
+    uint64_t evictions;
+    uint64_t bytesServed;
+    uint64_t memoryBytes;
+    uint32_t memoryEntries;
+    uint64_t diskBytes;
+    uint32_t diskEntries;
+};
+
+// Synthesized audio, keyed by the TTS request (text, voice, language, rate and endpoint).
+// Recently used entries are kept in memory, all of them on disk when a path is configured.
+// Both tiers are bounded in bytes and evict the least recently used entries first.
+class TTSCache {
+public:
+    typedef std::shared_ptr<const std::vector<char>> Audio;
+
+    TTSCache();
+    ~TTSCache();
+
+    void configure(const std::string &path, uint64_t memorySize, uint64_t diskSize);
+    bool get(const std::string &key, Audio &audio);
+    void put(const std::string &key, const std::vector<char> &audio);
+    void clear();
+    TTSCacheStats stats();
+
+private:
+    struct MemoryEntry {
+        std::string key;
+        Audio audio;
+    };
+    typedef std::list<MemoryEntry> MemoryList;
+
+    struct DiskEntry {
+        std::string file;
+        uint64_t size;
+    };
+    typedef std::list<DiskEntry> DiskList;
+
+    static std::string fileName(const std::string &key);
+    bool readFile(const std::string &file, const std::string &key, std::vector<char> &audio);
+    bool writeFile(const std::string &file, const std::string &key, const std::vector<char> &audio);
+    void loadDisk();
+    void putMemory(const std::string &key, Audio audio);
+    void trimMemory();
+    void trimDisk(std::vector<std::string> &removed);
+
+    std::mutex m_mutex;
+    std::string m_path;
+    uint64_t m_memorySize;
+    uint64_t m_diskSize;
+
+    MemoryList m_memory; // most recently used first
+    std::unordered_map<std::string, MemoryList::iterator> m_memoryIndex;
+    uint64_t m_memoryBytes;
+
+    DiskList m_disk; // most recently used first
+    std::unordered_map<std::string, DiskList::iterator> m_diskIndex;
+    uint64_t m_diskBytes;
+
+    TTSCacheStats m_stats;
+};
+
+} // namespace TTS
+
+#endif
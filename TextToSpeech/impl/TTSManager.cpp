@@ -194,6 +194,22 @@ TTS_Error TTSManager::getSpeechState(uint32_t id, SpeechState &state) {
     return TTS_OK;
 }
 
+void TTSManager::configureCache(std::string path, uint64_t memorySize, uint64_t diskSize) {
+    TTSLOG_TRACE("configureCache");
+
+    if(m_speaker)
+        m_speaker->cache().configure(path, memorySize, diskSize);
+}
+
+TTS_Error TTSManager::getCacheStats(TTSCacheStats &stats) {
+    TTSLOG_TRACE("getCacheStats");
+
+    if(m_speaker)
+        stats = m_speaker->cache().stats();
+
+    return TTS_OK;
+}
+
 void TTSManager::willSpeak(uint32_t speech_id, std::string text) {
     TTSLOG_TRACE(" [%d, %s]", speech_id, text.c_str());
 
@@ -212,12 +228,13 @@ void TTSManager::started(uint32_t speech_id, std::string text) {
     m_callback->onSpeechStart(d);
 }
 
-void TTSManager::spoke(uint32_t speech_id, std::string text) {
+void TTSManager::spoke(uint32_t speech_id, std::string text, SpeechMetrics &metrics) {
     TTSLOG_TRACE(" [%d, %s]", speech_id, text.c_str());
 
     SpeechData d;
     d.id = speech_id;
     d.text = text;
+    d.metrics = metrics;
     m_callback->onSpeechComplete(d);
 }
 
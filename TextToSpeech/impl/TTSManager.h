@@ -79,12 +79,16 @@ public:
     TTS_Error getSpeechState(uint32_t id, SpeechState &state);
     TTS_Error clearAudioPipeline();
 
+    // Audio cache
+    void configureCache(std::string path, uint64_t memorySize, uint64_t diskSize);
+    TTS_Error getCacheStats(TTSCacheStats &stats);
+
     virtual TTSConfiguration *configuration() {return &m_defaultConfiguration;}
 
     //Speak Events
     virtual void willSpeak(uint32_t speech_id, std::string text);
     virtual void started(uint32_t speech_id, std::string text);
-    virtual void spoke(uint32_t speech_id, std::string text);
+    virtual void spoke(uint32_t speech_id, std::string text, SpeechMetrics &metrics);
     virtual void paused(uint32_t speech_id);
     virtual void resumed(uint32_t speech_id);
     virtual void cancelled(std::vector<uint32_t> &speeches);
@@ -171,6 +171,11 @@ TTSSpeaker::TTSSpeaker(TTSConfiguration &config) :
     m_currentSpeech(NULL),
     m_isSpeaking(false),
     m_isPaused(false),
+    m_fetchThread(NULL),
+    m_runFetchThread(true),
+    m_hasHandoff(false),
+    m_awaitingFirstAudio(false),
+    m_firstAudio(0),
     m_pipeline(NULL),
     m_source(NULL),
     m_audioSink(NULL),
@@ -198,6 +203,7 @@ TTSSpeaker::TTSSpeaker(TTSConfiguration &config) :
         setenv("GST_REGISTRY_FORK", "no", 0);
 
         m_main_loop_thread = g_thread_new("BusWatch", (void* (*)(void*)) event_loop, this);
+        m_fetchThread = new std::thread(FetchThreadFunc, this);
         m_gstThread = new std::thread(GStreamerThreadFunc, this);
 
 }
@@ -221,6 +227,21 @@ TTSSpeaker::~TTSSpeaker() {
         m_gstThread = NULL;
     }
 
+    {
+        std::lock_guard<std::mutex> lock(m_fetchMutex);
+        m_runFetchThread = false;
+        for(auto &fetch : m_fetches)
+            fetch->aborted = true;
+        m_fetches.clear();
+    }
+    m_fetchCondition.notify_all();
+
+    if(m_fetchThread) {
+        m_fetchThread->join();
+        delete m_fetchThread;
+        m_fetchThread = NULL;
+    }
+
     if(g_main_loop_is_running(m_main_loop))
         g_main_loop_quit(m_main_loop);
     g_thread_join(m_main_loop_thread);
@@ -243,6 +264,10 @@ int TTSSpeaker::speak(TTSSpeakerClient *client, uint32_t id, std::string text, b
     SpeechData data(client, id, text, secure);
     queueData(data);
 
+    // Start downloading right away if it is next in line behind the current speech
+    if(m_isSpeaking)
+        prefetchNext();
+
     return 0;
 }
 
@@ -297,6 +322,7 @@ bool TTSSpeaker::reset() {
     TTSLOG_VERBOSE("Resetting Speaker");
     cancelSpeech();
     flushQueue();
+    abortFetches();
 
     return true;
 }
@@ -487,9 +513,14 @@ void TTSSpeaker::createPipeline() {
     }
 
 
+    // The audio is downloaded by the fetch thread and pushed through appsrc, so
+    // the pipeline does not depend on the endpoint and survives network errors.
+    m_source = gst_element_factory_make("appsrc", NULL);
+    g_object_set(G_OBJECT(m_source), "format", GST_FORMAT_BYTES, "is-live", FALSE, NULL);
+    gst_util_set_object_arg(G_OBJECT(m_source), "stream-type", "stream");
+
     // create soc specific elements
 #if defined(PLATFORM_BROADCOM)
-    m_source = gst_element_factory_make("souphttpsrc", NULL);
     m_audioSink = gst_element_factory_make("brcmpcmsink", NULL);
 #elif defined(PLATFORM_AMLOGIC)
     GstElement *convert = gst_element_factory_make("audioconvert", NULL);
@@ -500,17 +531,6 @@ void TTSSpeaker::createPipeline() {
     std::string tts_url =
         !m_defaultConfig.secureEndPoint().empty() ? m_defaultConfig.secureEndPoint() : m_defaultConfig.endPoint();
     if(!tts_url.empty()) {
-        if(!m_defaultConfig.voice().empty()) {
-            tts_url.append("voice=");
-            tts_url.append(m_defaultConfig.voice());
-        }
-
-        if(!m_defaultConfig.language().empty()) {
-            tts_url.append("&language=");
-            tts_url.append(m_defaultConfig.language());
-        }
-
-        tts_url.append("&text=init");
         std::string LoopbackEndPoint = LOOPBACK_ENDPOINT;
         std::string  LocalhostEndPoint = LOCALHOST_ENDPOINT;
         //Check if url contains endpoint on localhost, enable PCM audio
@@ -518,20 +538,18 @@ void TTSSpeaker::createPipeline() {
             TTSLOG_INFO("PCM audio playback is enabled");
             m_pcmAudioEnabled = true;
         }
-        curlSanitize(tts_url);
 
 #if defined(PLATFORM_AMLOGIC)
-        if(m_pcmAudioEnabled) {
-            //Raw PCM audio does not work with souphhtpsrc on Amlogic amlhalasink
-            m_source = gst_element_factory_make("httpsrc", NULL);
+        if(m_pcmAudioEnabled)
             g_object_set(G_OBJECT(m_audioSink), "tts-mode", TRUE, NULL);
-        }
-        else {
-            m_source = gst_element_factory_make("souphttpsrc", NULL);
-        }
 #endif
+    }
 
-        g_object_set(G_OBJECT(m_source), "location", tts_url.c_str(), NULL);
+    // Watch the sink for the first audio of a speech and for the boundaries between gapless speeches
+    GstPad *sinkPad = gst_element_get_static_pad(m_audioSink, "sink");
+    if(sinkPad) {
+        gst_pad_add_probe(sinkPad, (GstPadProbeType)(GST_PAD_PROBE_TYPE_BUFFER | GST_PAD_PROBE_TYPE_EVENT_DOWNSTREAM), SinkProbe, this, NULL);
+        gst_object_unref(sinkPad);
     }
 
     // set the TTS volume to max.
@@ -627,9 +645,14 @@ void TTSSpeaker::resetPipeline() {
         // If pipe line is NULL, create one
         createPipeline();
     } else {
-        // If pipeline is present, bring it to NULL state
-        gst_element_set_state(m_pipeline, GST_STATE_NULL);
-        while(!waitForStatus(GST_STATE_NULL, 60*1000));
+        // Keep the pipeline and bring it back to READY, that is enough to clear the EOS
+        // and much cheaper than tearing the elements down for every speech
+        gst_element_set_state(m_pipeline, GST_STATE_READY);
+        if(!waitForStatus(GST_STATE_READY, 5*1000) && !m_flushed) {
+            TTSLOG_WARNING("Pipeline did not get to READY, re-creating it");
+            destroyPipeline();
+            createPipeline();
+        }
     }
 }
 
@@ -697,7 +720,7 @@ void TTSSpeaker::waitForAudioToFinishTimeout(float timeout_s) {
 
     // Irrespective of EOS / Timeout reset pipeline
     if(m_pipeline)
-        gst_element_set_state(m_pipeline, GST_STATE_NULL);
+        gst_element_set_state(m_pipeline, GST_STATE_READY);
 
     if(!m_isEOS)
         TTSLOG_ERROR("Stopped waiting for audio to finish without hitting EOS!");
@@ -822,35 +845,439 @@ std::string TTSSpeaker::constructURL(TTSConfiguration &config, SpeechData &d) {
     return tts_request;
 }
 
-void TTSSpeaker::speakText(TTSConfiguration config, SpeechData &data) {
+static int64_t elapsedMs(std::chrono::steady_clock::time_point from, std::chrono::steady_clock::time_point to) {
+    return std::chrono::duration_cast<std::chrono::milliseconds>(to - from).count();
+}
+
+static int64_t nowUs() {
+    return std::chrono::duration_cast<std::chrono::microseconds>(std::chrono::steady_clock::now().time_since_epoch()).count();
+}
+
+int64_t TTSSpeaker::firstAudioMs(const SpeechData &data) const {
+    int64_t firstAudio = m_firstAudio;
+    if(m_awaitingFirstAudio || !firstAudio)
+        return -1;
+
+    int64_t requested = std::chrono::duration_cast<std::chrono::microseconds>(data.requested.time_since_epoch()).count();
+    return (firstAudio > requested) ? (firstAudio - requested) / 1000 : 0;
+}
+
+bool TTSSpeaker::speakText(TTSConfiguration config, SpeechData &data) {
+    bool handedOff = false;
+
     m_isEOS = false;
     m_duration = 0;
 
     if(m_pipeline && !m_pipelineError && !m_flushed) {
         m_currentSpeech = &data;
 
-        g_object_set(G_OBJECT(m_source), "location", constructURL(config, data).c_str(), NULL);
+        std::shared_ptr<AudioFetch> fetch = requestFetch(config, data);
+        prefetchNext();
+
         // PCM Sink seems to be accepting volume change before PLAYING state
         g_object_set(G_OBJECT(m_audioSink), "volume", (double) (data.client->configuration()->volume() / MAX_VOLUME), NULL);
-        gst_element_set_state(m_pipeline, GST_STATE_PLAYING);
+
+        // Right behind a gapless speech the pipeline is still playing and the first audio
+        // is marked by the boundary event instead
+        if(!m_hasHandoff) {
+            m_awaitingFirstAudio = true;
+            gst_element_set_state(m_pipeline, GST_STATE_PLAYING);
+        }
 #if defined(PLATFORM_AMLOGIC)
 	//-12db is almost 25%
 	setMixGain(MIXGAIN_PRIM,-12);
 #endif
         TTSLOG_VERBOSE("Speaking.... ( %d, \"%s\")", data.id, data.text.c_str());
 
-        //Wait for EOS with a timeout incase EOS never comes
-        if(m_pcmAudioEnabled) {
-            //FIXME, find out way to EOS or position for raw PCM audio
-            waitForAudioToFinishTimeout(60);
+        bool pushed = pushAudio(fetch, data);
+        if(!pushed && !m_flushed && !m_pipelineError) {
+            TTSLOG_ERROR("Could not download the audio of speech %d", data.id);
+            m_networkError = true;
         }
-        else {
-            waitForAudioToFinishTimeout(10);
+
+        if(pushed && isNextReady()) {
+            // Only one speech may wait for its boundary, so the appsrc queue stays short
+            std::unique_lock<std::mutex> mlock(m_queueMutex);
+            m_condition.wait_for(mlock, std::chrono::seconds(10), [this] () {
+                    return !m_hasHandoff || m_flushed || m_pipelineError;
+                });
+            mlock.unlock();
+
+            if(m_hasHandoff) {
+                TTSLOG_WARNING("Boundary of speech %d did not reach the sink", m_handoff.id);
+                completeHandoff(m_flushed || m_pipelineError);
+            }
+
+            if(!m_flushed && !m_pipelineError) {
+                // Push the next speech right behind this one, this one completes when
+                // the boundary comes out of the decoder together with the next audio
+                {
+                    std::lock_guard<std::mutex> lock(m_stateMutex);
+                    m_handoff = data;
+                    m_hasHandoff = true;
+                }
+
+                GstStructure *boundary = gst_structure_new("tts-boundary", "id", G_TYPE_UINT, data.id, NULL);
+                gst_element_send_event(m_source, gst_event_new_custom(GST_EVENT_CUSTOM_DOWNSTREAM, boundary));
+                handedOff = true;
+            }
+        } else if(!m_flushed && !m_pipelineError && (pushed || m_hasHandoff)) {
+            GstFlowReturn ret;
+            g_signal_emit_by_name(m_source, "end-of-stream", &ret);
+
+            //Wait for EOS with a timeout incase EOS never comes
+            if(m_pcmAudioEnabled) {
+                //FIXME, find out way to EOS or position for raw PCM audio
+                waitForAudioToFinishTimeout(60);
+            }
+            else {
+                waitForAudioToFinishTimeout(10);
+            }
+
+            // The boundary is handled before the EOS, this only catches a timeout
+            if(m_hasHandoff)
+                completeHandoff(m_flushed || m_pipelineError);
         }
+
+        if(!handedOff)
+            data.metrics.firstAudio = firstAudioMs(data);
+
+        dropFetch(data.id);
     } else {
         TTSLOG_WARNING("m_pipeline=%p, m_pipelineError=%d", m_pipeline, m_pipelineError);
     }
-    m_currentSpeech = NULL;
+    // Still playing after a hand off, pause and resume keep working on the copy
+    m_currentSpeech = handedOff ? &m_handoff : NULL;
+
+    return handedOff;
+}
+
+void TTSSpeaker::completeHandoff(bool interrupted) {
+    SpeechData handoff;
+
+    {
+        std::lock_guard<std::mutex> lock(m_stateMutex);
+        if(!m_hasHandoff)
+            return;
+
+        m_hasHandoff = false;
+        handoff = m_handoff;
+    }
+
+    // The next speech has not started yet, m_firstAudio is still the one of this speech
+    SpeechMetrics &metrics = handoff.metrics;
+    metrics.firstAudio = firstAudioMs(handoff);
+    metrics.total = elapsedMs(handoff.requested, std::chrono::steady_clock::now());
+
+    if(interrupted) {
+        handoff.client->interrupted(handoff.id);
+    } else {
+        TTSLOG_INFO("Speech %d: first byte %lld ms, first audio %lld ms, downloaded %lld ms, total %lld ms, %u bytes%s",
+                handoff.id, (long long)metrics.firstByte, (long long)metrics.firstAudio, (long long)metrics.download,
+                (long long)metrics.total, metrics.bytes, metrics.prefetched ? ", prefetched" : "");
+        handoff.client->spoke(handoff.id, handoff.text, metrics);
+    }
+
+    // speakText checks m_hasHandoff under m_queueMutex, notify under it so the wakeup is not lost
+    std::lock_guard<std::mutex> lock(m_queueMutex);
+    m_condition.notify_one();
+}
+
+bool TTSSpeaker::pushAudio(std::shared_ptr<AudioFetch> fetch, SpeechData &data) {
+    size_t offset = 0;
+
+    while(true) {
+        std::vector<char> chunk;
+        bool done = false;
+        bool failed = false;
+
+        {
+            std::unique_lock<std::mutex> lock(m_fetchMutex);
+            // m_flushed and m_pipelineError are signalled on m_condition, poll them
+            m_fetchCondition.wait_for(lock, std::chrono::milliseconds(100), [this, &fetch, offset] () {
+                    return fetch->data.size() > offset || fetch->done || m_flushed || m_pipelineError;
+                });
+
+            if(m_flushed || m_pipelineError)
+                return false;
+
+            if(fetch->data.size() > offset) {
+                chunk.assign(fetch->data.begin() + offset, fetch->data.end());
+                offset = fetch->data.size();
+            }
+
+            done = fetch->done && offset == fetch->data.size();
+            failed = fetch->failed;
+
+            if(done) {
+                data.metrics.firstByte = elapsedMs(data.requested, fetch->firstByte);
+                data.metrics.download = elapsedMs(data.requested, fetch->finished);
+                data.metrics.bytes = offset;
+                data.metrics.cached = fetch->cached;
+            }
+        }
+
+        if(!chunk.empty()) {
+            GstBuffer *buffer = gst_buffer_new_allocate(NULL, chunk.size(), NULL);
+            gst_buffer_fill(buffer, 0, chunk.data(), chunk.size());
+
+            GstFlowReturn ret = GST_FLOW_OK;
+            g_signal_emit_by_name(m_source, "push-buffer", buffer, &ret);
+            gst_buffer_unref(buffer);
+
+            if(ret != GST_FLOW_OK) {
+                TTSLOG_WARNING("appsrc refused the audio, flow %s", gst_flow_get_name(ret));
+                return false;
+            }
+        }
+
+        if(failed)
+            return false;
+
+        if(done)
+            return (offset > 0);
+    }
+}
+
+// Fetching
+
+struct FetchContext {
+    std::mutex *mutex;
+    std::condition_variable *condition;
+    AudioFetch *fetch;
+};
+
+static size_t FetchWriteCallback(char *ptr, size_t size, size_t nmemb, void *userdata) {
+    FetchContext *context = (FetchContext*) userdata;
+    size_t length = size * nmemb;
+
+    {
+        std::lock_guard<std::mutex> lock(*context->mutex);
+        if(context->fetch->aborted)
+            return 0;
+        if(context->fetch->data.empty())
+            context->fetch->firstByte = std::chrono::steady_clock::now();
+        context->fetch->data.insert(context->fetch->data.end(), ptr, ptr + length);
+    }
+    context->condition->notify_all();
+
+    return length;
+}
+
+static int FetchProgressCallback(void *userdata, curl_off_t, curl_off_t, curl_off_t, curl_off_t) {
+    FetchContext *context = (FetchContext*) userdata;
+    std::lock_guard<std::mutex> lock(*context->mutex);
+    return context->fetch->aborted ? 1 : 0;
+}
+
+void TTSSpeaker::FetchThreadFunc(void *ctx) {
+    TTSLOG_INFO("Starting FetchThread");
+    TTSSpeaker *speaker = (TTSSpeaker*) ctx;
+
+    // One handle for the lifetime of the speaker, so the connection to the TTS endpoint is kept alive
+    CURL *curl = curl_easy_init();
+    if(!curl) {
+        TTSLOG_ERROR("Could not create a curl handle, speech cannot be downloaded");
+    }
+
+    while(curl) {
+        std::shared_ptr<AudioFetch> fetch;
+
+        {
+            std::unique_lock<std::mutex> lock(speaker->m_fetchMutex);
+            speaker->m_fetchCondition.wait(lock, [speaker] () {
+                    if(!speaker->m_runFetchThread)
+                        return true;
+                    for(auto &f : speaker->m_fetches)
+                        if(!f->started)
+                            return true;
+                    return false;
+                });
+
+            if(!speaker->m_runFetchThread)
+                break;
+
+            for(auto &f : speaker->m_fetches) {
+                if(!f->started) {
+                    fetch = f;
+                    break;
+                }
+            }
+            fetch->started = true;
+        }
+
+        FetchContext context = { &speaker->m_fetchMutex, &speaker->m_fetchCondition, fetch.get() };
+
+        curl_easy_reset(curl);
+        curl_easy_setopt(curl, CURLOPT_URL, fetch->url.c_str());
+        curl_easy_setopt(curl, CURLOPT_FOLLOWLOCATION, 1L);
+        curl_easy_setopt(curl, CURLOPT_FAILONERROR, 1L);
+        curl_easy_setopt(curl, CURLOPT_CONNECTTIMEOUT, 5L);
+        curl_easy_setopt(curl, CURLOPT_TIMEOUT, 30L);
+        curl_easy_setopt(curl, CURLOPT_WRITEFUNCTION, FetchWriteCallback);
+        curl_easy_setopt(curl, CURLOPT_WRITEDATA, &context);
+        curl_easy_setopt(curl, CURLOPT_NOPROGRESS, 0L);
+        curl_easy_setopt(curl, CURLOPT_XFERINFOFUNCTION, FetchProgressCallback);
+        curl_easy_setopt(curl, CURLOPT_XFERINFODATA, &context);
+
+        CURLcode res = curl_easy_perform(curl);
+
+        bool cache = false;
+        {
+            std::lock_guard<std::mutex> lock(speaker->m_fetchMutex);
+            cache = (res == CURLE_OK && fetch->cacheable && !fetch->aborted);
+            if(res != CURLE_OK) {
+                if(!fetch->aborted)
+                    TTSLOG_ERROR("Download of speech %d failed: %s", fetch->id, curl_easy_strerror(res));
+                fetch->failed = true;
+            }
+            fetch->done = true;
+            fetch->finished = std::chrono::steady_clock::now();
+        }
+        speaker->m_fetchCondition.notify_all();
+
+        // Nothing writes to a finished fetch any more
+        if(cache)
+            speaker->m_cache.put(fetch->url, fetch->data);
+    }
+
+    if(curl)
+        curl_easy_cleanup(curl);
+    TTSLOG_INFO("Stopping FetchThread");
+}
+
+std::shared_ptr<AudioFetch> TTSSpeaker::requestFetch(TTSConfiguration &config, SpeechData &data) {
+    std::string url = constructURL(config, data);
+    std::shared_ptr<AudioFetch> fetch;
+
+    {
+        std::lock_guard<std::mutex> lock(m_fetchMutex);
+
+        for(auto it = m_fetches.begin(); it != m_fetches.end(); ++it) {
+            if((*it)->id != data.id)
+                continue;
+
+            if((*it)->url == url && !(*it)->failed) {
+                data.metrics.prefetched = true;
+                return *it;
+            }
+
+            // The configuration changed since it was prefetched
+            (*it)->aborted = true;
+            m_fetches.erase(it);
+            break;
+        }
+
+    }
+
+    // The speech being played is downloaded before any prefetch
+    fetch = newFetch(data.id, url, data.secure);
+    {
+        std::lock_guard<std::mutex> lock(m_fetchMutex);
+        m_fetches.push_front(fetch);
+    }
+    m_fetchCondition.notify_all();
+
+    return fetch;
+}
+
+std::shared_ptr<AudioFetch> TTSSpeaker::newFetch(uint32_t id, const std::string &url, bool secure) {
+    std::shared_ptr<AudioFetch> fetch = std::make_shared<AudioFetch>(id, url, !secure);
+    TTSCache::Audio audio;
+
+    // A cached speech is complete right away, the fetch thread skips it
+    if(fetch->cacheable && m_cache.get(url, audio)) {
+        fetch->data.assign(audio->begin(), audio->end());
+        fetch->started = fetch->done = fetch->cached = true;
+        fetch->firstByte = fetch->finished = std::chrono::steady_clock::now();
+    }
+
+    return fetch;
+}
+
+void TTSSpeaker::prefetchNext() {
+    SpeechData next;
+
+    {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        if(m_queue.empty())
+            return;
+        next = m_queue.front();
+    }
+
+    {
+        std::lock_guard<std::mutex> lock(m_fetchMutex);
+        for(auto &fetch : m_fetches)
+            if(fetch->id == next.id)
+                return;
+    }
+
+    std::string url = constructURL(*next.client->configuration(), next);
+    if(url.empty())
+        return;
+
+    std::shared_ptr<AudioFetch> fetch = newFetch(next.id, url, next.secure);
+    {
+        std::lock_guard<std::mutex> lock(m_fetchMutex);
+        m_fetches.push_back(fetch);
+    }
+    m_fetchCondition.notify_all();
+}
+
+bool TTSSpeaker::isNextReady() {
+    uint32_t id;
+
+    {
+        std::lock_guard<std::mutex> lock(m_queueMutex);
+        if(m_queue.empty())
+            return false;
+        id = m_queue.front().id;
+    }
+
+    std::lock_guard<std::mutex> lock(m_fetchMutex);
+    for(auto &fetch : m_fetches)
+        if(fetch->id == id)
+            return !fetch->failed && !fetch->data.empty();
+
+    return false;
+}
+
+void TTSSpeaker::dropFetch(uint32_t id) {
+    std::lock_guard<std::mutex> lock(m_fetchMutex);
+    for(auto it = m_fetches.begin(); it != m_fetches.end(); ++it) {
+        if((*it)->id == id) {
+            (*it)->aborted = true;
+            m_fetches.erase(it);
+            break;
+        }
+    }
+}
+
+void TTSSpeaker::abortFetches() {
+    std::lock_guard<std::mutex> lock(m_fetchMutex);
+    for(auto &fetch : m_fetches)
+        fetch->aborted = true;
+    m_fetches.clear();
+}
+
+GstPadProbeReturn TTSSpeaker::SinkProbe(GstPad *, GstPadProbeInfo *info, gpointer data) {
+    TTSSpeaker *speaker = (TTSSpeaker*) data;
+
+    if(GST_PAD_PROBE_INFO_TYPE(info) & GST_PAD_PROBE_TYPE_BUFFER) {
+        bool awaiting = true;
+        if(speaker->m_awaitingFirstAudio.compare_exchange_strong(awaiting, false))
+            speaker->m_firstAudio = nowUs();
+    } else {
+        GstEvent *event = GST_PAD_PROBE_INFO_EVENT(info);
+        if(GST_EVENT_TYPE(event) == GST_EVENT_CUSTOM_DOWNSTREAM && gst_event_has_name(event, "tts-boundary")) {
+            // Handled on the bus thread, like the state changes that report the start of a speech
+            GstElement *pipeline = speaker->m_pipeline;
+            if(pipeline)
+                gst_element_post_message(pipeline, gst_message_new_application(GST_OBJECT(pipeline), gst_structure_copy(gst_event_get_structure(event))));
+        }
+    }
+
+    return GST_PAD_PROBE_OK;
 }
 
 void TTSSpeaker::event_loop(void *data)
@@ -916,10 +1343,15 @@ void TTSSpeaker::GStreamerThreadFunc(void *ctx) {
         if(!speaker->m_flushed)
             data.client->willSpeak(data.id, data.text);
 
-        // Push it to gstreamer for speaking
+        // Push it to gstreamer for speaking, a speech handed off to the next one
+        // is reported from the bus once its audio has been played
         if(!speaker->m_flushed) {
-            speaker->speakText(*data.client->configuration(), data);
+            if(speaker->speakText(*data.client->configuration(), data))
+                continue;
         }
+
+        // A hand off still pending here did not make it to the sink
+        speaker->completeHandoff(true);
 #if defined(PLATFORM_AMLOGIC)
 	// when not speaking, set primary mixgain back to default.
 	if(speaker->m_flushed || speaker->m_networkError || !speaker->m_pipeline || speaker->m_pipelineError)
@@ -936,7 +1368,12 @@ void TTSSpeaker::GStreamerThreadFunc(void *ctx) {
 #if defined(PLATFORM_AMLOGIC)
 	    speaker->setMixGain(MIXGAIN_PRIM,0);
 #endif
-            data.client->spoke(data.id, data.text);
+            SpeechMetrics &metrics = data.metrics;
+            metrics.total = elapsedMs(data.requested, std::chrono::steady_clock::now());
+            TTSLOG_INFO("Speech %d: first byte %lld ms, first audio %lld ms, downloaded %lld ms, total %lld ms, %u bytes%s",
+                    data.id, (long long)metrics.firstByte, (long long)metrics.firstAudio, (long long)metrics.download,
+                    (long long)metrics.total, metrics.bytes, metrics.prefetched ? ", prefetched" : "");
+            data.client->spoke(data.id, data.text, metrics);
 	}
         speaker->setSpeakingState(false);
 
@@ -966,9 +1403,6 @@ bool TTSSpeaker::handleMessage(GstMessage *message) {
                 gst_message_parse_error(message, &error, &debug);
                 TTSLOG_ERROR("error! code: %d, %s, Debug: %s", error->code, error->message, debug);
                 GST_DEBUG_BIN_TO_DOT_FILE_WITH_TS(GST_BIN(m_pipeline), GST_DEBUG_GRAPH_SHOW_ALL, "error-pipeline");
-                std::string source = GST_MESSAGE_SRC_NAME(message);
-                if(source.find("httpsrc") != std::string::npos)
-                    m_networkError = true;
                 m_pipelineError = true;
                 m_condition.notify_one();
             }
@@ -980,6 +1414,22 @@ bool TTSSpeaker::handleMessage(GstMessage *message) {
             }
             break;
 
+        case GST_MESSAGE_APPLICATION: {
+                const GstStructure *structure = gst_message_get_structure(message);
+                if(!structure || !gst_structure_has_name(structure, "tts-boundary"))
+                    break;
+
+                // The previous speech has been played, the current one starts right behind it
+                completeHandoff(false);
+
+                std::lock_guard<std::mutex> lock(m_stateMutex);
+                if(m_clientSpeaking && m_currentSpeech && m_currentSpeech != &m_handoff) {
+                    m_firstAudio = nowUs();
+                    m_clientSpeaking->started(m_currentSpeech->id, m_currentSpeech->text);
+                }
+            }
+            break;
+
         case GST_MESSAGE_EOS: {
                 TTSLOG_INFO("Audio EOS message received");
                 m_isEOS = true;
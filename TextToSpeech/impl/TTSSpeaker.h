@@ -27,11 +27,15 @@
 #include <map>
 #include <list>
 #include <mutex>
+#include <atomic>
+#include <chrono>
+#include <memory>
 #include <thread>
 #include <vector>
 #include <condition_variable>
 
 #include "TTSCommon.h"
+#include "TTSCache.h"
 
 #if defined(PLATFORM_AMLOGIC)
 #include "audio_if.h"
@@ -91,12 +95,25 @@ private:
     bool m_enabled;
 };
 
+// Latency of one speech, in ms from the speak request. -1 when not reached.
+struct SpeechMetrics {
+    SpeechMetrics() : firstByte(-1), download(-1), firstAudio(-1), total(-1), bytes(0), prefetched(false), cached(false) {}
+
+    int64_t firstByte;  // first byte of audio received from the TTS endpoint
+    int64_t download;   // audio completely received
+    int64_t firstAudio; // first audio reached the sink
+    int64_t total;      // speech completed
+    uint32_t bytes;
+    bool prefetched;    // download started while the previous speech was playing
+    bool cached;        // served from the audio cache, nothing was downloaded
+};
+
 class TTSSpeakerClient {
 public:
     virtual TTSConfiguration* configuration() = 0;
     virtual void willSpeak(uint32_t speech_id, std::string text) = 0;
     virtual void started(uint32_t speech_id, std::string text) = 0;
-    virtual void spoke(uint32_t speech_id, std::string text) = 0;
+    virtual void spoke(uint32_t speech_id, std::string text, SpeechMetrics &metrics) = 0;
     virtual void paused(uint32_t speech_id) = 0;
     virtual void resumed(uint32_t speech_id) = 0;
     virtual void cancelled(std::vector<uint32_t> &speeches) = 0;
@@ -107,13 +124,15 @@ public:
 
 struct SpeechData {
     public:
-        SpeechData() : client(NULL), secure(false), id(0), text() {}
-        SpeechData(TTSSpeakerClient *c, uint32_t i, std::string t, bool s=false) : client(c), secure(s), id(i), text(t) {}
+        SpeechData() : client(NULL), secure(false), id(0), text(), requested(std::chrono::steady_clock::now()) {}
+        SpeechData(TTSSpeakerClient *c, uint32_t i, std::string t, bool s=false) : client(c), secure(s), id(i), text(t), requested(std::chrono::steady_clock::now()) {}
         SpeechData(const SpeechData &n) {
             client = n.client;
             id = n.id;
             text = n.text;
             secure = n.secure;
+            requested = n.requested;
+            metrics = n.metrics;
         }
         ~SpeechData() {}
 
@@ -121,6 +140,25 @@ struct SpeechData {
         bool secure;
         uint32_t id;
         std::string text;
+        std::chrono::steady_clock::time_point requested;
+        SpeechMetrics metrics;
+};
+
+// Audio of one speech, downloaded by the fetch thread. Guarded by TTSSpeaker::m_fetchMutex.
+struct AudioFetch {
+    AudioFetch(uint32_t i, const std::string &u, bool c) : id(i), url(u), started(false), done(false), failed(false), aborted(false), cacheable(c), cached(false) {}
+
+    uint32_t id;
+    std::string url;
+    std::vector<char> data; // grows while downloading
+    bool started;
+    bool done;
+    bool failed;
+    bool aborted;
+    bool cacheable; // secure speeches are never cached
+    bool cached;
+    std::chrono::steady_clock::time_point firstByte;
+    std::chrono::steady_clock::time_point finished;
 };
 
 class TTSSpeaker {
@@ -140,6 +178,8 @@ public:
     bool pause(uint32_t id = 0);
     bool resume(uint32_t id = 0);
 
+    TTSCache &cache() { return m_cache; }
+
 private:
 
     // Private Data
@@ -161,6 +201,34 @@ private:
     // Private functions
     inline void setSpeakingState(bool state, TTSSpeakerClient *client=NULL);
 
+    // Audio download, see FetchThreadFunc. Holds the speech being pushed to the
+    // pipeline and the next one in the queue, in that order.
+    std::list<std::shared_ptr<AudioFetch>> m_fetches;
+    std::mutex m_fetchMutex;
+    std::condition_variable m_fetchCondition;
+    std::thread *m_fetchThread;
+    bool m_runFetchThread;
+
+    static void FetchThreadFunc(void *ctx);
+    std::shared_ptr<AudioFetch> requestFetch(TTSConfiguration &config, SpeechData &data);
+    std::shared_ptr<AudioFetch> newFetch(uint32_t id, const std::string &url, bool secure);
+    void prefetchNext();
+    bool isNextReady();
+    void dropFetch(uint32_t id);
+    void abortFetches();
+    bool pushAudio(std::shared_ptr<AudioFetch> fetch, SpeechData &data);
+    TTSCache m_cache;
+
+    // Gapless playback: the previous speech when the current one was pushed right behind it.
+    // It completes when its boundary event reaches the sink.
+    SpeechData m_handoff;
+    std::atomic<bool> m_hasHandoff; // written under m_stateMutex, waited on under m_queueMutex
+    std::atomic<bool> m_awaitingFirstAudio;
+    std::atomic<int64_t> m_firstAudio; // steady clock, us
+    void completeHandoff(bool interrupted);
+    int64_t firstAudioMs(const SpeechData &data) const;
+    static GstPadProbeReturn SinkProbe(GstPad *pad, GstPadProbeInfo *info, gpointer data);
+
     // GStreamer Releated members
     GstElement  *m_pipeline;
     GstElement  *m_source;
@@ -207,7 +275,7 @@ private:
     void replaceIfIsolated(std::string& subject, const std::string& search, const std::string& replace);
     void curlSanitize(std::string &url);
     void sanitizeString(std::string &input, std::string &sanitizedString);
-    void speakText(TTSConfiguration config, SpeechData &data);
+    bool speakText(TTSConfiguration config, SpeechData &data);
     bool waitForStatus(GstState expected_state, uint32_t timeout_ms);
     void waitForAudioToFinishTimeout(float timeout_s);
     bool handleMessage(GstMessage*);
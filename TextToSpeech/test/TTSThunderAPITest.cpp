@@ -65,6 +65,7 @@ static int currentSpeechId = 0;
 #define OPT_EXIT                  12
 #define OPT_BLOCK_TILL_INPUT      13
 #define OPT_SLEEP                 14
+#define OPT_CACHE_STATS           15
 
 /* Declare module name */
 MODULE_NAME_DECLARATION(BUILD_REFERENCE)
@@ -87,6 +88,7 @@ void showMenu()
     cout << OPT_EXIT                 << ".exit" << endl;
     cout << OPT_BLOCK_TILL_INPUT     << ".dummyInput" << endl;
     cout << OPT_SLEEP                << ".sleep" << endl;
+    cout << OPT_CACHE_STATS          << ".getCacheStats" << endl;
     cout << "------------------------" << endl;
 }
 
@@ -461,6 +463,22 @@ int main(int argc, char *argv[]) {
                     }
                     break;
 
+                    case OPT_CACHE_STATS:
+                    {
+                        JsonObject params;
+                        ret = remoteObject->Invoke<JsonObject, JsonObject>(1000,
+                                _T("getcachestats"), params, result);
+                        if (result["success"].Boolean()) {
+                            cout << "Cache hits : " << result["hits"].String() << ", misses : " << result["misses"].String()
+                                << " (" << result["hitrate"].String() << "%), "
+                                << result["memorybytes"].String() << " bytes in memory, "
+                                << result["diskbytes"].String() << " bytes on disk" << endl;
+                        } else {
+                            cout << "getcachestats call failed. TTS_Status: " << result["TTS_Status"].String() << endl;
+                        }
+                    }
+                    break;
+
                     case OPT_EXIT: {
                         cout << "Test app is exiting" <<endl;
                         exit(0);
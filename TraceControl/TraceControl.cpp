@@ -78,6 +78,23 @@ namespace Plugin {
 
             _outputs.push_back(new Trace::TraceMedia(logNode));
         }
+#ifndef __WINDOWS__
+        if ((_config.Ring.Path.IsSet() == true) && (_config.Ring.Path.Value().empty() == false)) {
+            string fileName(_config.Ring.Path.Value());
+
+            if (fileName[0] != '/') {
+                fileName = service->VolatilePath() + fileName;
+            }
+
+            _ring = new Plugin::TraceRingOutput(fileName, std::max(_config.Ring.Size.Value(), static_cast<uint32_t>(4 * 1024)), _config.Ring.Strings.Value());
+
+            if (_ring->IsValid() == false) {
+                TRACE(Trace::Error, (_T("Could not open trace ring file %s"), fileName.c_str()));
+                delete _ring;
+                _ring = nullptr;
+            }
+        }
+#endif
 
         _service->Register(&_observer);
 
@@ -102,6 +119,13 @@ namespace Plugin {
 
             _outputs.pop_front();
         }
+
+#ifndef __WINDOWS__
+        if (_ring != nullptr) {
+            delete _ring;
+            _ring = nullptr;
+        }
+#endif
     }
 
     /* virtual */ string TraceControl::Information() const
@@ -139,19 +163,7 @@ namespace Plugin {
             response->Console = _config.Console;
             response->Remote = _config.Remote;
 
-            Observer::ModuleIterator index(_observer.Modules());
-
-            while (index.Next() == true) {
-                string moduleName(Core::ToString(index.Module()));
-
-                Observer::ModuleIterator::CategoryIterator categories(index.Categories());
-
-                while (categories.Next()) {
-                    string categoryName(Core::ToString(categories.Category()));
-
-                    response->Settings.Add(Data::Trace(moduleName, categoryName, categories.State()));
-                }
-            }
+            Settings(string(EMPTY_STRING), string(EMPTY_STRING), response->Settings);
 
             result->Body(Core::proxy_cast<Web::IBody>(response));
             result->ContentType = Web::MIME_JSON;
@@ -218,6 +230,12 @@ namespace Plugin {
             (*index)->Output(information.FileName(), information.LineNumber(), information.ClassName(), &wrapper);
             index++;
         }
+
+#ifndef __WINDOWS__
+        if (_ring != nullptr) {
+            _ring->Output(information.Timestamp(), information.FileName(), information.LineNumber(), information.Module(), information.Category(), information.ClassName(), information.Information(), information.Length());
+        }
+#endif
     }
 }
 }
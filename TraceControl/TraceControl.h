@@ -20,12 +20,16 @@
 #pragma once
 
 #include "Module.h"
-#include <interfaces/json/JsonData_TraceControl.h>
+
+#include <atomic>
+#include <unordered_map>
 
 namespace WPEFramework {
 
 namespace Plugin {
 
+    class TraceRingOutput;
+
     class TraceControl : public PluginHost::IPlugin, public PluginHost::IWeb, public PluginHost::JSONRPC {
 
     public:
@@ -39,6 +43,177 @@ namespace Plugin {
         TraceControl(const TraceControl&) = delete;
         TraceControl& operator=(const TraceControl&) = delete;
 
+        // Token bucket rate limit and 1-in-N sampling per module/category, applied before dispatching.
+        // A rule for a module without category applies to all its categories, a rule without module
+        // to everything, the most specific rule wins.
+        class Limiter {
+        private:
+            Limiter(const Limiter&) = delete;
+            Limiter& operator=(const Limiter&) = delete;
+
+        public:
+            struct Rule {
+                uint32_t Rate; // traces per second, 0 is unlimited
+                uint32_t Burst; // traces allowed in a burst above the rate
+                uint32_t Sample; // dispatch 1 in N traces, 0 or 1 dispatches all
+            };
+
+        private:
+            struct Bucket {
+                Rule Applied;
+                uint64_t Tokens; // in traces * 1000000, to stay in integers
+                uint64_t Last;
+                uint32_t Counter;
+                uint64_t Dropped;
+                uint64_t Suppressed;
+            };
+
+            static string Key(const string& module, const string& category)
+            {
+                return (module + '\n' + category);
+            }
+
+        public:
+            Limiter()
+                : _lock()
+                , _rules()
+                , _count(0)
+                , _buckets()
+                , _dropped(0)
+                , _suppressed(0)
+            {
+            }
+            ~Limiter()
+            {
+            }
+
+        public:
+            void Configure(const string& module, const string& category, const Rule& rule)
+            {
+                _lock.Lock();
+
+                if ((rule.Rate == 0) && (rule.Sample <= 1)) {
+                    _rules.erase(Key(module, category));
+                } else {
+                    Rule& entry(_rules[Key(module, category)]);
+                    entry = rule;
+                    if ((entry.Rate != 0) && (entry.Burst == 0)) {
+                        entry.Burst = entry.Rate;
+                    }
+                }
+
+                _count.store(static_cast<uint32_t>(_rules.size()), std::memory_order_release);
+
+                // Reapply the rules, but keep the counters.
+                for (std::pair<const string, Bucket>& bucket : _buckets) {
+                    size_t split(bucket.first.find('\n'));
+                    bucket.second.Applied = Find(bucket.first.substr(0, split), bucket.first.substr(split + 1));
+                    bucket.second.Tokens = static_cast<uint64_t>(bucket.second.Applied.Burst) * 1000000;
+                }
+
+                _lock.Unlock();
+            }
+            // Timestamp is the trace clock in microseconds.
+            bool Pass(const char module[], const char category[], const uint64_t timestamp)
+            {
+                bool result = true;
+
+                // Without rules nothing is limited, do not contend with the other sources for that.
+                if (_count.load(std::memory_order_acquire) == 0) {
+                    return (result);
+                }
+
+                _lock.Lock();
+
+                if (_rules.empty() == false) {
+                    const string key(Key(module, category));
+                    std::unordered_map<string, Bucket>::iterator index(_buckets.find(key));
+
+                    if (index == _buckets.end()) {
+                        Bucket bucket;
+                        bucket.Applied = Find(module, category);
+                        bucket.Tokens = static_cast<uint64_t>(bucket.Applied.Burst) * 1000000;
+                        bucket.Last = timestamp;
+                        bucket.Counter = 0;
+                        bucket.Dropped = 0;
+                        bucket.Suppressed = 0;
+                        index = _buckets.emplace(key, bucket).first;
+                    }
+
+                    Bucket& bucket(index->second);
+
+                    if ((bucket.Applied.Sample > 1) && ((bucket.Counter++ % bucket.Applied.Sample) != 0)) {
+                        bucket.Suppressed++;
+                        _suppressed++;
+                        result = false;
+                    } else if (bucket.Applied.Rate != 0) {
+                        // Traces of different processes are not strictly ordered, never go back in time.
+                        if (timestamp > bucket.Last) {
+                            const uint64_t limit(static_cast<uint64_t>(bucket.Applied.Burst) * 1000000);
+                            bucket.Tokens = std::min(limit, bucket.Tokens + ((timestamp - bucket.Last) * bucket.Applied.Rate));
+                            bucket.Last = timestamp;
+                        }
+                        if (bucket.Tokens >= 1000000) {
+                            bucket.Tokens -= 1000000;
+                        } else {
+                            bucket.Dropped++;
+                            _dropped++;
+                            result = false;
+                        }
+                    }
+                }
+
+                _lock.Unlock();
+
+                return (result);
+            }
+            bool Info(const string& module, const string& category, Rule& rule, uint64_t& dropped, uint64_t& suppressed) const
+            {
+                _lock.Lock();
+
+                rule = Find(module, category);
+
+                std::unordered_map<string, Bucket>::const_iterator index(_buckets.find(Key(module, category)));
+                dropped = (index != _buckets.end() ? index->second.Dropped : 0);
+                suppressed = (index != _buckets.end() ? index->second.Suppressed : 0);
+
+                _lock.Unlock();
+
+                return ((rule.Rate != 0) || (rule.Sample > 1) || (dropped != 0) || (suppressed != 0));
+            }
+            void Totals(uint64_t& dropped, uint64_t& suppressed) const
+            {
+                _lock.Lock();
+                dropped = _dropped;
+                suppressed = _suppressed;
+                _lock.Unlock();
+            }
+
+        private:
+            Rule Find(const string& module, const string& category) const
+            {
+                std::map<string, Rule>::const_iterator index(_rules.find(Key(module, category)));
+
+                if (index == _rules.end()) {
+                    index = _rules.find(Key(module, EMPTY_STRING));
+
+                    if (index == _rules.end()) {
+                        index = _rules.find(Key(EMPTY_STRING, EMPTY_STRING));
+                    }
+                }
+
+                return (index != _rules.end() ? index->second : Rule{ 0, 0, 0 });
+            }
+
+        private:
+            mutable Core::CriticalSection _lock;
+            std::map<string, Rule> _rules;
+            std::atomic<uint32_t> _count; // _rules.size(), read without the lock
+            std::unordered_map<string, Bucket> _buckets;
+            uint64_t _dropped;
+            uint64_t _suppressed;
+        };
+
         class Observer : public Core::Thread, public RPC::IRemoteConnection::INotification {
         private:
             Observer() = delete;
@@ -556,6 +731,7 @@ namespace Plugin {
                 , _traceControl(Trace::TraceUnit::Instance())
                 , _parent(parent)
                 , _refcount(0)
+                , _limiter()
             {
             }
             ~Observer()
@@ -635,6 +811,15 @@ namespace Plugin {
                 _adminLock.Unlock();
             }
 
+            void Limit(const std::string& module, const std::string& category, const Limiter::Rule& rule)
+            {
+                _limiter.Configure(module, category, rule);
+            }
+            inline const Limiter& Limits() const
+            {
+                return (_limiter);
+            }
+
             void Relinquish()
             {
                 _adminLock.Lock();
@@ -711,8 +896,10 @@ namespace Plugin {
 
                         if (selected != nullptr) {
 
-                            // Oke, output this entry
-                            _parent.Dispatch(*selected);
+                            // Oke, output this entry, unless it is above its rate or not sampled.
+                            if (_limiter.Pass(selected->Module(), selected->Category(), selected->Timestamp()) == true) {
+                                _parent.Dispatch(*selected);
+                            }
 
                             // Ready to load a new one..
                             selected->Clear();
@@ -736,6 +923,7 @@ namespace Plugin {
             Trace::TraceUnit& _traceControl;
             TraceControl& _parent;
             mutable uint32_t _refcount;
+            Limiter _limiter;
         };
 
         class InformationWrapper : public Trace::ITrace {
@@ -810,6 +998,31 @@ namespace Plugin {
             Core::JSON::DecUInt16 Port;
             Core::JSON::String Binding;
         };
+        class RingNode : public Core::JSON::Container {
+        private:
+            RingNode(const RingNode&);
+            RingNode& operator=(const RingNode&);
+
+        public:
+            RingNode()
+                : Core::JSON::Container()
+                , Path()
+                , Size(1024 * 1024)
+                , Strings(64 * 1024)
+            {
+                Add(_T("path"), &Path);
+                Add(_T("size"), &Size);
+                Add(_T("strings"), &Strings);
+            }
+            ~RingNode()
+            {
+            }
+
+        public:
+            Core::JSON::String Path; // Ring file, relative paths are taken from the volatile path
+            Core::JSON::DecUInt32 Size; // Bytes reserved for records
+            Core::JSON::DecUInt32 Strings; // Bytes reserved for file, module, category and class names
+        };
         class Config : public Core::JSON::Container {
         private:
             Config(const Config&);
@@ -822,11 +1035,13 @@ namespace Plugin {
                 , SysLog(true)
                 , Abbreviated(true)
                 , Remote()
+                , Ring()
             {
                 Add(_T("console"), &Console);
                 Add(_T("syslog"), &SysLog);
                 Add(_T("abbreviated"), &Abbreviated);
                 Add(_T("remote"), &Remote);
+                Add(_T("ring"), &Ring);
             }
             ~Config()
             {
@@ -837,6 +1052,7 @@ namespace Plugin {
             Core::JSON::Boolean SysLog;
             Core::JSON::Boolean Abbreviated;
             NetworkNode Remote;
+            RingNode Ring;
         };
         class Data : public Core::JSON::Container {
         public:
@@ -867,16 +1083,12 @@ namespace Plugin {
                 Trace()
                     : Core::JSON::Container()
                 {
-                    Add(_T("module"), &Module);
-                    Add(_T("category"), &Category);
-                    Add(_T("state"), &State);
+                    Init();
                 }
                 Trace(const string& moduleName, const string& categoryName, const state currentState)
                     : Core::JSON::Container()
                 {
-                    Add(_T("module"), &Module);
-                    Add(_T("category"), &Category);
-                    Add(_T("state"), &State);
+                    Init();
 
                     Module = moduleName;
                     Category = categoryName;
@@ -887,19 +1099,40 @@ namespace Plugin {
                     , Module(copy.Module)
                     , Category(copy.Category)
                     , State(copy.State)
+                    , Rate(copy.Rate)
+                    , Burst(copy.Burst)
+                    , Sample(copy.Sample)
+                    , Dropped(copy.Dropped)
+                    , Suppressed(copy.Suppressed)
                 {
-                    Add(_T("module"), &Module);
-                    Add(_T("category"), &Category);
-                    Add(_T("state"), &State);
+                    Init();
                 }
                 ~Trace()
                 {
                 }
 
+            private:
+                void Init()
+                {
+                    Add(_T("module"), &Module);
+                    Add(_T("category"), &Category);
+                    Add(_T("state"), &State);
+                    Add(_T("rate"), &Rate);
+                    Add(_T("burst"), &Burst);
+                    Add(_T("sample"), &Sample);
+                    Add(_T("dropped"), &Dropped);
+                    Add(_T("suppressed"), &Suppressed);
+                }
+
             public:
                 Core::JSON::String Module;
                 Core::JSON::String Category;
                 Core::JSON::EnumType<state> State;
+                Core::JSON::DecUInt32 Rate; // Traces per second, 0 is unlimited
+                Core::JSON::DecUInt32 Burst; // Traces allowed in a burst above the rate (default: rate)
+                Core::JSON::DecUInt32 Sample; // Dispatch 1 in N traces
+                Core::JSON::DecUInt64 Dropped; // Traces dropped by the rate limit
+                Core::JSON::DecUInt64 Suppressed; // Traces skipped by sampling
             };
 
         private:
@@ -913,6 +1146,8 @@ namespace Plugin {
                 Add(_T("console"), &Console);
                 Add(_T("remote"), &Remote);
                 Add(_T("settings"), &Settings);
+                Add(_T("dropped"), &Dropped);
+                Add(_T("suppressed"), &Suppressed);
             }
             ~Data()
             {
@@ -922,6 +1157,8 @@ namespace Plugin {
             Core::JSON::Boolean Console;
             NetworkNode Remote;
             Core::JSON::ArrayType<Trace> Settings;
+            Core::JSON::DecUInt64 Dropped; // Traces dropped by rate limits, all modules and categories
+            Core::JSON::DecUInt64 Suppressed; // Traces skipped by sampling, all modules and categories
         };
 
     public:
@@ -932,6 +1169,7 @@ namespace Plugin {
             : _skipURL(0)
             , _service(nullptr)
             , _outputs()
+            , _ring(nullptr)
             , _tracePath()
             , _observer(*this)
         {
@@ -990,9 +1228,9 @@ namespace Plugin {
 
         void RegisterAll();
         void UnregisterAll();
-        JsonData::TraceControl::StateType TranslateState(TraceControl::state state);
-        uint32_t endpoint_status(const JsonData::TraceControl::StatusParamsData& params, JsonData::TraceControl::StatusResultData& response);
-        uint32_t endpoint_set(const JsonData::TraceControl::TraceInfo& params);
+        void Settings(const string& module, const string& category, Core::JSON::ArrayType<Data::Trace>& settings);
+        uint32_t endpoint_status(const Data::StatusParam& params, Data& response);
+        uint32_t endpoint_set(const Data::Trace& params);
         inline const string& TracePath() const 
         {
             return (_tracePath);
@@ -1003,6 +1241,7 @@ namespace Plugin {
         PluginHost::IShell* _service;
         Config _config;
         std::list<Trace::ITraceMedia*> _outputs;
+        TraceRingOutput* _ring;
         string _tracePath;
         Observer _observer;
     };
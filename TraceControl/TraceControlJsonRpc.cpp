@@ -19,21 +19,18 @@
  
 #include "Module.h"
 #include "TraceControl.h"
-#include <interfaces/json/JsonData_TraceControl.h>
 
 namespace WPEFramework {
 
 namespace Plugin {
 
-    using namespace JsonData::TraceControl;
-
     // Registration
     //
 
     void TraceControl::RegisterAll()
     {
-        Register<StatusParamsData,StatusResultData>(_T("status"), &TraceControl::endpoint_status, this);
-        Register<TraceInfo,void>(_T("set"), &TraceControl::endpoint_set, this);
+        Register<Data::StatusParam,Data>(_T("status"), &TraceControl::endpoint_status, this);
+        Register<Data::Trace,void>(_T("set"), &TraceControl::endpoint_set, this);
     }
 
     void TraceControl::UnregisterAll()
@@ -42,24 +39,35 @@ namespace Plugin {
         Unregister(_T("status"));
     }
 
-    JsonData::TraceControl::StateType TraceControl::TranslateState(TraceControl::state state)
+    void TraceControl::Settings(const string& module, const string& category, Core::JSON::ArrayType<Data::Trace>& settings)
     {
-        JsonData::TraceControl::StateType newState = JsonData::TraceControl::StateType::DISABLED;
-
-        switch (state)
-        {
-        case TraceControl::state::ENABLED:
-            newState = JsonData::TraceControl::StateType::ENABLED;
-            break;
-        case TraceControl::state::DISABLED:
-            newState = JsonData::TraceControl::StateType::DISABLED;
-            break;
-        case TraceControl::state::TRISTATED:
-            newState = JsonData::TraceControl::StateType::TRISTATED;
-            break;
-        }
+        Observer::ModuleIterator index(_observer.Modules());
+
+        while (index.Next() == true) {
+            string moduleName(Core::ToString(index.Module()));
+            Observer::ModuleIterator::CategoryIterator categories(index.Categories());
 
-        return newState;
+            if ((module.empty() == true) || (moduleName == module)) {
+                while (categories.Next()) {
+                    string categoryName(Core::ToString(categories.Category()));
+
+                    if ((category.empty() == true) || (categoryName == category)) {
+                        Data::Trace& trace(settings.Add(Data::Trace(moduleName, categoryName, categories.State())));
+                        Limiter::Rule rule;
+                        uint64_t dropped, suppressed;
+
+                        // Only report the limits for categories that are (or were) limited.
+                        if (_observer.Limits().Info(moduleName, categoryName, rule, dropped, suppressed) == true) {
+                            trace.Rate = rule.Rate;
+                            trace.Burst = rule.Burst;
+                            trace.Sample = rule.Sample;
+                            trace.Dropped = dropped;
+                            trace.Suppressed = suppressed;
+                        }
+                    }
+                }
+            }
+        }
     }
 
     // API implementation
@@ -68,50 +76,44 @@ namespace Plugin {
     // Method: status - Retrieves general information
     // Return codes:
     //  - ERROR_NONE: Success
-    uint32_t TraceControl::endpoint_status(const StatusParamsData& params, StatusResultData& response)
+    uint32_t TraceControl::endpoint_status(const Data::StatusParam& params, Data& response)
     {
         uint32_t result = Core::ERROR_NONE;
+        uint64_t dropped, suppressed;
 
         response.Console = _config.Console;
         response.Remote.Port = _config.Remote.Port;
         response.Remote.Binding = _config.Remote.Binding;
 
-        Observer::ModuleIterator index(_observer.Modules());
+        Settings((params.Module.IsSet() == true ? params.Module.Value() : string(EMPTY_STRING)),
+            (params.Category.IsSet() == true ? params.Category.Value() : string(EMPTY_STRING)),
+            response.Settings);
 
-        while (index.Next() == true) {
-            string moduleName(Core::ToString(index.Module()));
-            Observer::ModuleIterator::CategoryIterator categories(index.Categories());
+        _observer.Limits().Totals(dropped, suppressed);
+        response.Dropped = dropped;
+        response.Suppressed = suppressed;
 
-            if ((params.Module.IsSet() == false) || ((params.Module.IsSet() == true) && (moduleName == params.Module.Value()))) {
-                while (categories.Next()) {
-                    string categoryName(Core::ToString(categories.Category()));
-
-                    if ((params.Category.IsSet() == false) || ((params.Category.IsSet() == true) && (categoryName == params.Category.Value()))) {
-                        Data::Trace trace = Data::Trace(moduleName, categoryName, categories.State());
-                        JsonData::TraceControl::TraceInfo traceResponse;
-                        traceResponse.Module = trace.Module;
-                        traceResponse.Category = trace.Category;
-                        traceResponse.State = TranslateState(trace.State);
-                        response.Settings.Add(traceResponse);
-                    }
-                }
-            }
-        }
         _observer.Relinquish();
 
         return result;
     }
 
-    // Method: set - Sets traces
+    // Method: set - Sets traces, and optionally their rate limit and sampling
     // Return codes:
     //  - ERROR_NONE: Success
-    uint32_t TraceControl::endpoint_set(const TraceInfo& params)
+    uint32_t TraceControl::endpoint_set(const Data::Trace& params)
     {
         uint32_t result = Core::ERROR_NONE;
+        const std::string module(params.Module.IsSet() == true ? params.Module.Value() : std::string(EMPTY_STRING));
+        const std::string category(params.Category.IsSet() == true ? params.Category.Value() : std::string(EMPTY_STRING));
 
-        _observer.Set((params.State.Value() == JsonData::TraceControl::StateType::ENABLED),
-            (params.Module.IsSet() == true ? params.Module.Value() : std::string(EMPTY_STRING)),
-            (params.Category.IsSet() == true ? params.Category.Value() : std::string(EMPTY_STRING)));
+        if (params.State.IsSet() == true) {
+            _observer.Set((params.State.Value() == state::ENABLED), module, category);
+        }
+
+        if ((params.Rate.IsSet() == true) || (params.Sample.IsSet() == true)) {
+            _observer.Limit(module, category, Limiter::Rule{ params.Rate.Value(), params.Burst.Value(), params.Sample.Value() });
+        }
 
         _observer.Relinquish();
         return result;
@@ -119,4 +121,3 @@ namespace Plugin {
 } // namespace Plugin
 
 }
-
@@ -20,9 +20,16 @@
 #pragma once
 
 #include "Module.h"
+#include "TraceRing.h"
+
+#include <atomic>
+#include <unordered_map>
 
 #ifndef __WINDOWS__
 #include <syslog.h>
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <unistd.h>
 #endif
 
 namespace WPEFramework {
@@ -71,5 +78,163 @@ namespace Plugin {
         bool _syslogging;
         bool _abbreviated;
     };
+
+#ifndef __WINDOWS__
+    // Stores raw trace records in a fixed size, memory mapped ring file (see TraceRing.h). Nothing is
+    // formatted on the target, the file is turned into text by the TraceRingDecoder tool.
+    class TraceRingOutput {
+    public:
+        TraceRingOutput() = delete;
+        TraceRingOutput(const TraceRingOutput&) = delete;
+        TraceRingOutput& operator=(const TraceRingOutput&) = delete;
+
+        TraceRingOutput(const string& fileName, const uint32_t ringSize, const uint32_t stringsSize)
+            : _header(nullptr)
+            , _strings(nullptr)
+            , _ring(nullptr)
+            , _mapped(nullptr)
+            , _mappedSize(0)
+            , _ids()
+        {
+            const uint32_t headerSize(TraceRing::Align(sizeof(TraceRing::Header)));
+            const uint32_t ring(TraceRing::Align(ringSize));
+            const uint32_t strings(TraceRing::Align(stringsSize));
+
+            int fd = ::open(fileName.c_str(), O_RDWR | O_CREAT | O_TRUNC | O_CLOEXEC, 0644);
+
+            if (fd < 0) {
+                TRACE_L1("Could not create trace ring file %s, error %d", fileName.c_str(), errno);
+            } else {
+                _mappedSize = headerSize + strings + ring;
+
+                if (::ftruncate(fd, _mappedSize) == 0) {
+                    void* mapped = ::mmap(nullptr, _mappedSize, PROT_READ | PROT_WRITE, MAP_SHARED, fd, 0);
+
+                    if (mapped != MAP_FAILED) {
+                        _mapped = static_cast<uint8_t*>(mapped);
+                        _header = reinterpret_cast<TraceRing::Header*>(_mapped);
+                        _strings = reinterpret_cast<char*>(_mapped + headerSize);
+                        _ring = _mapped + headerSize + strings;
+
+                        ::memset(_header, 0, sizeof(TraceRing::Header));
+                        _header->version = TraceRing::Version;
+                        _header->headerSize = headerSize;
+                        _header->stringsSize = strings;
+                        _header->ringSize = ring;
+
+                        // The magic goes last, a decoder only trusts a file with a complete header.
+                        ::memcpy(_header->magic, TraceRing::Magic, sizeof(_header->magic));
+                    } else {
+                        TRACE_L1("Could not map trace ring file %s, error %d", fileName.c_str(), errno);
+                    }
+                }
+                ::close(fd);
+            }
+        }
+        ~TraceRingOutput()
+        {
+            if (_mapped != nullptr) {
+                ::msync(_mapped, _mappedSize, MS_ASYNC);
+                ::munmap(_mapped, _mappedSize);
+            }
+        }
+
+    public:
+        inline bool IsValid() const
+        {
+            return (_mapped != nullptr);
+        }
+
+        // Only called from the TraceControl observer thread, so there is a single writer.
+        void Output(const uint64_t clock, const char fileName[], const uint32_t lineNumber, const char module[], const char category[], const char className[], const char data[], const uint16_t length)
+        {
+            if (_mapped == nullptr) {
+                return;
+            }
+
+            const uint32_t maxPayload(_header->ringSize - static_cast<uint32_t>(sizeof(TraceRing::Record)));
+            const uint16_t payload(static_cast<uint16_t>(std::min(static_cast<uint32_t>(length),
+                std::min(maxPayload, static_cast<uint32_t>(0xFFFF - TraceRing::RecordAlignment - sizeof(TraceRing::Record))))));
+            const uint32_t required(TraceRing::Align(static_cast<uint32_t>(sizeof(TraceRing::Record)) + payload));
+
+            uint32_t offset(static_cast<uint32_t>(_header->head % _header->ringSize));
+            const uint32_t remaining(_header->ringSize - offset);
+
+            if (remaining < required) {
+                // Records never wrap, pad the end of the ring and continue at the start.
+                Reserve(remaining);
+
+                TraceRing::Record* padding(reinterpret_cast<TraceRing::Record*>(&_ring[offset]));
+                padding->length = static_cast<uint16_t>(remaining);
+                padding->module = TraceRing::PaddingId;
+                _header->head += remaining;
+                offset = 0;
+            }
+
+            Reserve(required);
+
+            TraceRing::Record* record(reinterpret_cast<TraceRing::Record*>(&_ring[offset]));
+            record->length = static_cast<uint16_t>(required);
+            record->module = Id(module);
+            record->category = Id(category);
+            record->file = Id(Core::FileNameOnly(fileName));
+            record->classname = Id(className);
+            record->payload = payload;
+            record->line = lineNumber;
+            record->clock = clock;
+            ::memcpy(&_ring[offset + sizeof(TraceRing::Record)], data, payload);
+
+            // Publish the record only after it is complete.
+            std::atomic_thread_fence(std::memory_order_release);
+            _header->head += required;
+            _header->records++;
+        }
+
+    private:
+        // Drop the oldest records until there is room for length bytes at the head.
+        void Reserve(const uint32_t length)
+        {
+            while ((_header->head + length - _header->tail) > _header->ringSize) {
+                const TraceRing::Record* oldest(reinterpret_cast<const TraceRing::Record*>(&_ring[_header->tail % _header->ringSize]));
+
+                ASSERT(oldest->length != 0);
+
+                if (oldest->module != TraceRing::PaddingId) {
+                    _header->overwritten++;
+                }
+                _header->tail += oldest->length;
+            }
+        }
+        uint16_t Id(const char text[])
+        {
+            uint16_t result(TraceRing::InvalidId);
+            const string key(text != nullptr ? text : "");
+            std::unordered_map<string, uint16_t>::const_iterator index(_ids.find(key));
+
+            if (index != _ids.end()) {
+                result = index->second;
+            } else if (((_header->stringsUsed + key.length() + 1) <= _header->stringsSize) && (_header->stringsCount < TraceRing::PaddingId)) {
+                ::memcpy(&_strings[_header->stringsUsed], key.c_str(), key.length() + 1);
+                result = static_cast<uint16_t>(_header->stringsCount);
+
+                // The string must be in the table before its id can be referenced.
+                std::atomic_thread_fence(std::memory_order_release);
+                _header->stringsUsed += static_cast<uint32_t>(key.length() + 1);
+                _header->stringsCount++;
+                _ids.emplace(key, result);
+            }
+
+            return (result);
+        }
+
+    private:
+        TraceRing::Header* _header;
+        char* _strings;
+        uint8_t* _ring;
+        uint8_t* _mapped;
+        uint32_t _mappedSize;
+        std::unordered_map<string, uint16_t> _ids;
+    };
+#endif
 }
 }
@@ -0,0 +1,81 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2020 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+#pragma once
+
+// Layout of the binary trace ring file. This header is shared between the
+// TraceControl plugin (writer) and the host side decoder, so it must not
+// depend on the framework.
+//
+//  +--------+----------------+--------------------------------------------+
+//  | Header | String table   | Record ring                                |
+//  +--------+----------------+--------------------------------------------+
+//
+// File names, modules, categories and class names are stored once in the
+// string table and referenced by id from the records. Records are aligned to
+// RecordAlignment bytes and never wrap around the end of the ring, the unused
+// tail is filled with a padding record instead. Head and tail are ever
+// increasing byte positions, the ring offset is the position modulo the ring
+// size. All fields are in the byte order of the writer.
+
+#include <stdint.h>
+
+namespace WPEFramework {
+namespace Plugin {
+namespace TraceRing {
+
+    static constexpr char Magic[8] = { 'T', 'R', 'C', 'R', 'I', 'N', 'G', '\0' };
+    static constexpr uint32_t Version = 1;
+    static constexpr uint32_t RecordAlignment = 8;
+    static constexpr uint16_t InvalidId = 0xFFFF;
+    static constexpr uint16_t PaddingId = 0xFFFE;
+
+    struct Header {
+        char magic[8];
+        uint32_t version;
+        uint32_t headerSize; // offset of the string table
+        uint32_t stringsSize; // capacity of the string table in bytes
+        uint32_t stringsUsed; // bytes used in the string table
+        uint32_t stringsCount; // number of NUL terminated strings in the string table
+        uint32_t ringSize; // capacity of the record ring in bytes
+        uint64_t head; // position after the newest record
+        uint64_t tail; // position of the oldest record
+        uint64_t records; // records written since the file was created
+        uint64_t overwritten; // records overwritten by newer ones
+    };
+
+    struct Record {
+        uint16_t length; // total record length including this header and alignment
+        uint16_t module; // string id, PaddingId for a padding record
+        uint16_t category; // string id
+        uint16_t file; // string id
+        uint16_t classname; // string id
+        uint16_t payload; // payload length in bytes, follows this header
+        uint32_t line;
+        uint64_t clock; // Core::Time ticks (microseconds) at which the trace was produced
+    };
+
+    static constexpr uint32_t Align(const uint32_t length)
+    {
+        return ((length + (RecordAlignment - 1)) & ~(RecordAlignment - 1));
+    }
+
+} // namespace TraceRing
+} // namespace Plugin
+} // namespace WPEFramework
@@ -0,0 +1,158 @@
+/*
+ * If not stated otherwise in this file or this component's LICENSE file the
+ * following copyright and licenses apply:
+ *
+ * Copyright 2020 RDK Management
+ *
+ * Licensed under the Apache License, Version 2.0 (the "License");
+ * you may not use this file except in compliance with the License.
+ * You may obtain a copy of the License at
+ *
+ * http://www.apache.org/licenses/LICENSE-2.0
+ *
+ * Unless required by applicable law or agreed to in writing, software
+ * distributed under the License is distributed on an "AS IS" BASIS,
+ * WITHOUT WARRANTIES OR CONDITIONS OF ANY KIND, either express or implied.
+ * See the License for the specific language governing permissions and
+ * limitations under the License.
+ */
+
+// Host side decoder for the binary trace ring file written by the TraceControl
+// plugin. Prints the records, oldest first, in the same layout as the console
+// output of the plugin.
+//
+//   TraceRingDecoder <ringfile> [-m module] [-c category]
+
+#include "../TraceRing.h"
+
+#include <stdio.h>
+#include <string.h>
+#include <time.h>
+
+#include <fstream>
+#include <iterator>
+#include <string>
+#include <vector>
+
+using namespace WPEFramework::Plugin;
+
+static const std::string& Lookup(const std::vector<std::string>& strings, const uint16_t id)
+{
+    static const std::string unknown("<unknown>");
+    return (id < strings.size() ? strings[id] : unknown);
+}
+
+static std::string Timestamp(const uint64_t clock)
+{
+    // The clock is in microseconds since the epoch.
+    const time_t seconds(static_cast<time_t>(clock / 1000000));
+    struct tm utc;
+    char buffer[64];
+
+    gmtime_r(&seconds, &utc);
+    size_t length = strftime(buffer, sizeof(buffer), "%Y-%m-%d %H:%M:%S", &utc);
+    snprintf(&buffer[length], sizeof(buffer) - length, ".%06u", static_cast<uint32_t>(clock % 1000000));
+
+    return (std::string(buffer));
+}
+
+int main(int argc, char* argv[])
+{
+    const char* fileName = nullptr;
+    const char* module = nullptr;
+    const char* category = nullptr;
+
+    for (int index = 1; index < argc; index++) {
+        if ((strcmp(argv[index], "-m") == 0) && ((index + 1) < argc)) {
+            module = argv[++index];
+        } else if ((strcmp(argv[index], "-c") == 0) && ((index + 1) < argc)) {
+            category = argv[++index];
+        } else if (fileName == nullptr) {
+            fileName = argv[index];
+        } else {
+            fileName = nullptr;
+            break;
+        }
+    }
+
+    if (fileName == nullptr) {
+        fprintf(stderr, "Usage: %s <ringfile> [-m module] [-c category]\n", argv[0]);
+        return (1);
+    }
+
+    // Work on a copy, the plugin may still be writing to the file.
+    std::ifstream file(fileName, std::ios::binary);
+    std::vector<uint8_t> content((std::istreambuf_iterator<char>(file)), std::istreambuf_iterator<char>());
+
+    TraceRing::Header header;
+
+    if ((content.size() < sizeof(header)) || (memcmp(content.data(), TraceRing::Magic, sizeof(TraceRing::Magic)) != 0)) {
+        fprintf(stderr, "%s is not a trace ring file\n", fileName);
+        return (1);
+    }
+
+    memcpy(&header, content.data(), sizeof(header));
+
+    if ((header.version != TraceRing::Version) || (header.ringSize == 0) || ((static_cast<uint64_t>(header.headerSize) + header.stringsSize + header.ringSize) > content.size()) || (header.stringsUsed > header.stringsSize)) {
+        fprintf(stderr, "%s has an unsupported version or an inconsistent header\n", fileName);
+        return (1);
+    }
+
+    std::vector<std::string> strings;
+    const char* table = reinterpret_cast<const char*>(&content[header.headerSize]);
+    uint32_t offset = 0;
+
+    while ((offset < header.stringsUsed) && (strings.size() < header.stringsCount)) {
+        strings.push_back(std::string(&table[offset], strnlen(&table[offset], header.stringsUsed - offset)));
+        offset += static_cast<uint32_t>(strings.back().length() + 1);
+    }
+
+    const uint8_t* ring = &content[header.headerSize + header.stringsSize];
+    uint64_t position = header.tail;
+    uint64_t printed = 0;
+
+    while (position < header.head) {
+        const uint32_t location = static_cast<uint32_t>(position % header.ringSize);
+        TraceRing::Record record;
+
+        if ((header.ringSize - location) < sizeof(TraceRing::Record)) {
+            // Only a padding record fits here.
+            memcpy(&record, &ring[location], sizeof(record.length));
+            record.module = TraceRing::PaddingId;
+        } else {
+            memcpy(&record, &ring[location], sizeof(record));
+        }
+
+        if ((record.length == 0) || ((record.length % TraceRing::RecordAlignment) != 0) || (record.length > (header.ringSize - location))) {
+            fprintf(stderr, "Corrupt record at position %llu, stopping\n", static_cast<unsigned long long>(position));
+            break;
+        }
+
+        if ((record.module != TraceRing::PaddingId) && (record.payload <= (record.length - sizeof(TraceRing::Record)))) {
+            const std::string& moduleName(Lookup(strings, record.module));
+            const std::string& categoryName(Lookup(strings, record.category));
+
+            if (((module == nullptr) || (moduleName == module)) && ((category == nullptr) || (categoryName == category))) {
+                printf("[%s]:[%s:%u] %s/%s %s: %.*s\n",
+                    Timestamp(record.clock).c_str(),
+                    Lookup(strings, record.file).c_str(),
+                    record.line,
+                    moduleName.c_str(),
+                    categoryName.c_str(),
+                    Lookup(strings, record.classname).c_str(),
+                    static_cast<int>(record.payload),
+                    reinterpret_cast<const char*>(&ring[location + sizeof(TraceRing::Record)]));
+                printed++;
+            }
+        }
+
+        position += record.length;
+    }
+
+    fprintf(stderr, "%llu of %llu records printed, %llu overwritten\n",
+        static_cast<unsigned long long>(printed),
+        static_cast<unsigned long long>(header.records),
+        static_cast<unsigned long long>(header.overwritten));
+
+    return (0);
+}